@@ -9,9 +9,10 @@
 
 #include <stdint.h>
 #include <inttypes.h>
-#include <arm_neon.h>
 
 #include "functions_SCD_ARM.h"
+#include "../../common/latency.h"
+#include "../../common/pmu.h"
 
 int main(){
 
@@ -141,11 +142,16 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 
     /* Simulations corresponding to each sig */
     int i_sig = 0;
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
     for (i_sig = 0; i_sig < num_EbN0dB; i_sig++)
     {
         printf("Count %d of %d\n", i_sig+1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
         
         BER[i_sig] = 0;
@@ -225,9 +231,13 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 
             /* Successive Cancellation Decoding */
             dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
             decode(msg_cap, N, n, K, LLR_Q, info_nodes, data_pos);
 
+            PMU_STOP(K);
+            lat_record(&lat, lat_now_ns() - lat_start);
             dec_end = clock();
 
             dec_cpu_time_used = dec_cpu_time_used + ( dec_end - dec_start );
@@ -247,6 +257,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         printf("EbN0dB %0.2f\t", EbN0dB[i_sig]);
         BER[i_sig] = (double) err_count/(N*num_sim);
         printf("BER %lf\n", BER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     } // end of noise var loop
 
@@ -263,5 +277,7 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     printf("Decoder throughput is %0.2f Mbps\n", ((float)(num_sim*num_EbN0dB*N/1024)/(dec_cpu_time_used*1000)));
     printf("Encoder throughput is %0.2f Mbps\n", ((float)(num_sim*num_EbN0dB*N/1024)/(enc_cpu_time_used*1000)));
 
+    lat_print(stdout, "all points", &lat_all);
+
 return 0;
 }
\ No newline at end of file
@@ -7,7 +7,7 @@
 
 #include <stdint.h>
 #include <inttypes.h>
-#include <arm_neon.h>
+#include "../../common/simd.h"
 
 #define f_macro(L1, L2) sign_macro(L1)*sign_macro(L2)*mini_macro(absl_macro(L1),absl_macro(L2))
 #define maxqr 31
@@ -129,7 +129,7 @@ void encode(uint8_t *u, int N)
     /* log function */
     while (N >>= 1) n++;
 
-    uint8x16_t data1, data2;
+    simd_u8 data1, data2;
 
     int i_s;
     int i_g;
@@ -148,16 +148,16 @@ void encode(uint8_t *u, int N)
             base = (1 << (i_s+1)) * (i_g);
 
             /* Sub group after sub group */
-            if (del >= 16)
+            if (del >= SIMD_U8_LANES)
             {
-                for (i_sg = 0; i_sg < del; i_sg+=16)
+                for (i_sg = 0; i_sg < del; i_sg+=SIMD_U8_LANES)
                 {
-                    data1 = vld1q_u8(&u[base+i_sg]);
-                    data2 = vld1q_u8(&u[base+i_sg+del]);
+                    data1 = simd_load_u8(&u[base+i_sg]);
+                    data2 = simd_load_u8(&u[base+i_sg+del]);
 
-                    data1 = veorq_u8(data1, data2);
+                    data1 = simd_xor_u8(data1, data2);
 
-                    vst1q_u8(&u[base+i_sg],data1);
+                    simd_store_u8(&u[base+i_sg],data1);
                 }
             }
 
@@ -293,18 +293,18 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
                 {
                     /* Combine */
                     int count = 0;
-                    uint8x16_t data1, data2;
-                    if (temp > 16)
+                    simd_u8 data1, data2;
+                    if (temp/2 >= SIMD_U8_LANES)
                     {
-                        for (i_L = 0; i_L < temp/2; i_L+=16)
+                        for (i_L = 0; i_L < temp/2; i_L+=SIMD_U8_LANES)
                         { 
-                            data1 = vld1q_u8 (&ucap[depth + 1][i_L + node_type_ind]);
-                            data2 = vld1q_u8 (&ucap[depth + 1][i_L + node_type_ind + temp/2]);
+                            data1 = simd_load_u8 (&ucap[depth + 1][i_L + node_type_ind]);
+                            data2 = simd_load_u8 (&ucap[depth + 1][i_L + node_type_ind + temp/2]);
 
-                            data1 = veorq_u8 (data1, data2);
+                            data1 = simd_xor_u8 (data1, data2);
 
-                            vst1q_u8(&ucap[depth][i_L + node_type_ind],data1);
-                            vst1q_u8(&ucap[depth][i_L + node_type_ind + temp/2],data2);
+                            simd_store_u8(&ucap[depth][i_L + node_type_ind],data1);
+                            simd_store_u8(&ucap[depth][i_L + node_type_ind + temp/2],data2);
                         }
                     }
 
@@ -7,7 +7,7 @@
 
 #include <stdint.h>
 #include <inttypes.h>
-#include <arm_neon.h>
+#include "../../common/simd.h"
 
 #define f_macro(L1, L2) sign_macro(L1)*sign_macro(L2)*mini_macro(absl_macro(L1),absl_macro(L2))
 #define maxqr 31
@@ -164,7 +164,7 @@ void encode(uint8_t *u, int N)
     /* log function */
     while (N >>= 1) n++;
 
-    uint8x16_t data1, data2;
+    simd_u8 data1, data2;
 
     int i_s;
     int i_g;
@@ -183,14 +183,14 @@ void encode(uint8_t *u, int N)
             base = (1 << (i_s+1)) * (i_g);
 
             /* Sub group after sub group */
-            if (del >= 16)
+            if (del >= SIMD_U8_LANES)
             {
-                for (i_sg = 0; i_sg < del; i_sg+=16)
+                for (i_sg = 0; i_sg < del; i_sg+=SIMD_U8_LANES)
                 {
-                    data1 = vld1q_u8(&u[base+i_sg]);
-                    data2 = vld1q_u8(&u[base+i_sg+del]);
+                    data1 = simd_load_u8(&u[base+i_sg]);
+                    data2 = simd_load_u8(&u[base+i_sg+del]);
 
-                    vst1q_u8(&u[base+i_sg],veorq_u8(data1, data2));
+                    simd_store_u8(&u[base+i_sg],simd_xor_u8(data1, data2));
                 }
             }
 
@@ -255,15 +255,12 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
     int n_enc;
     int N_enc;
 
-    uint8x16_t data_zero, data_one;
-    const uint8_t zero = 0;
-    const uint8_t one = 1;
-    data_zero = vld1q_dup_u8(&zero);
-    data_one = vld1q_dup_u8(&one);
+    const simd_u8 data_zero = simd_dup_u8(0);
+    const simd_u8 data_one = simd_dup_u8(1);
 
-    const int8_t zero_s = 0;
-    int8x16_t data_zero_s;
-    data_zero_s = vld1q_dup_s8(&zero_s);
+    const simd_s8 data_zero_s = simd_dup_s8(0);
+    const simd_s8 data_maxqr = simd_dup_s8(maxqr);
+    const simd_s8 data_minqr = simd_dup_s8(-(maxqr+1));
 
     /* Traverse till all bits are decoded */
     while (done == 0)
@@ -295,12 +292,12 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
         /* Rate-0 nodes */
         else if(node_type[node_type_ind + N*(n-depth)] == 10)
         {
-            if (temp >= 16)
+            if (temp >= SIMD_U8_LANES)
             {
-                for (i_n = 0; i_n < temp; i_n+=16)
+                for (i_n = 0; i_n < temp; i_n+=SIMD_U8_LANES)
                 {
-                    vst1q_u8(&ucap[n][i_n + node*temp],data_zero);
-                    vst1q_u8(&ucap[depth][i_n + node*temp],data_zero);
+                    simd_store_u8(&ucap[n][i_n + node*temp],data_zero);
+                    simd_store_u8(&ucap[depth][i_n + node*temp],data_zero);
                 }
             }
             else
@@ -323,27 +320,19 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
         /* Rate-1 nodes */
         else if(node_type[node_type_ind + N*(n-depth)] == 20)
         {
-            uint8x16_t data;
-            int8x16_t data1;
+            simd_u8 data;
+            simd_s8 data1;
 
-            int j;
-            if (temp >=16)
+            if (temp >= SIMD_U8_LANES)
             {
-                for (i_n = 0; i_n < temp; i_n+=16)
+                for (i_n = 0; i_n < temp; i_n+=SIMD_U8_LANES)
                 {
-                    data1 = vld1q_s8(&L[depth][i_n]);
-                    data = vcgeq_s8(data_zero_s,data1);
+                    /* Hard decision: 1 where L <= 0, as the scalar branch */
+                    data1 = simd_load_s8(&L[depth][i_n]);
+                    data = simd_and_u8(simd_cge_s8(data_zero_s,data1), data_one);
 
-                    for (j = 0; j < 16; j++)
-                    {
-                        if (data[j] > 0)
-                        {
-                            data[j] = 1;
-                        }
-                    }
-
-                    vst1q_u8(&ucap[depth][i_n + node_type_ind],data);
-                    vst1q_u8(&ucap[n][i_n + node_type_ind],data);
+                    simd_store_u8(&ucap[depth][i_n + node_type_ind],data);
+                    simd_store_u8(&ucap[n][i_n + node_type_ind],data);
                 }
             }
 
@@ -423,21 +412,19 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
                 res = 1;
             }
 
-            uint16x8_t  vdupq_n_u16(uint16_t value);
-
-            if (temp >= 16)
+            if (temp >= SIMD_U8_LANES)
             {
-                for (i_n = 0; i_n < temp; i_n+=16)
+                for (i_n = 0; i_n < temp; i_n+=SIMD_U8_LANES)
                 {
                     if (res == 0)
                     {
-                        vst1q_u8(&ucap[n][i_n + node*temp],data_zero);
-                        vst1q_u8(&ucap[depth][i_n + node*temp],data_zero);
+                        simd_store_u8(&ucap[n][i_n + node*temp],data_zero);
+                        simd_store_u8(&ucap[depth][i_n + node*temp],data_zero);
                     }
                     else
                     {
-                        vst1q_u8(&ucap[n][i_n + node*temp],data_one);
-                        vst1q_u8(&ucap[depth][i_n + node*temp],data_one);
+                        simd_store_u8(&ucap[n][i_n + node*temp],data_one);
+                        simd_store_u8(&ucap[depth][i_n + node*temp],data_one);
                     }
                 }
             }
@@ -470,9 +457,26 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
             if (ns[npos] == 0)
             {
                 /* f_minsum and storage */
-                for (i_L = 0; i_L < temp/2; i_L++)
+                if (temp/2 >= SIMD_U8_LANES)
+                {
+                    for (i_L = 0; i_L < temp/2; i_L+=SIMD_U8_LANES)
+                    {
+                        /* min(|L1|,|L2|), negated where the signs differ */
+                        simd_s8 L1 = simd_load_s8(&L[depth][i_L]);
+                        simd_s8 L2 = simd_load_s8(&L[depth][i_L + temp/2]);
+                        simd_s8 L_min = simd_min_s8(simd_abs_s8(L1), simd_abs_s8(L2));
+                        simd_u8 neg = simd_xor_u8(simd_cgt_s8(data_zero_s, L1), simd_cgt_s8(data_zero_s, L2));
+
+                        simd_store_s8(&L[depth+1][i_L], simd_select_s8(neg, simd_sub_s8(data_zero_s, L_min), L_min));
+                    }
+                }
+
+                else
                 {
-                    L[depth+1][i_L] = f_macro(L[depth][i_L], L[depth][i_L + temp/2]);
+                    for (i_L = 0; i_L < temp/2; i_L++)
+                    {
+                        L[depth+1][i_L] = f_macro(L[depth][i_L], L[depth][i_L + temp/2]);
+                    }
                 }
 
                 /* Next node: Left child */
@@ -490,9 +494,26 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
                 if (ns[npos] == 1)
                 {
                     /* g_minsum and storage */
-                    for (i_L = 0; i_L < temp/2; i_L++)
+                    if (temp/2 >= SIMD_U8_LANES)
                     {
-                        L[depth+1][i_L] = g_macro(ucap[depth+1][i_L+node_type_ind], L[depth][i_L ], L[depth][i_L+temp/2]);
+                        for (i_L = 0; i_L < temp/2; i_L+=SIMD_U8_LANES)
+                        {
+                            /* L2 - L1 where u = 1, L2 + L1 where u = 0, saturated */
+                            simd_s8 L1 = simd_load_s8(&L[depth][i_L]);
+                            simd_s8 L2 = simd_load_s8(&L[depth][i_L + temp/2]);
+                            simd_u8 u = simd_cgt_s8(simd_load_s8((const int8_t *)&ucap[depth+1][i_L+node_type_ind]), data_zero_s);
+                            simd_s8 L_g = simd_select_s8(u, simd_sub_s8(L2, L1), simd_add_s8(L2, L1));
+
+                            simd_store_s8(&L[depth+1][i_L], simd_max_s8(simd_min_s8(L_g, data_maxqr), data_minqr));
+                        }
+                    }
+
+                    else
+                    {
+                        for (i_L = 0; i_L < temp/2; i_L++)
+                        {
+                            L[depth+1][i_L] = g_macro(ucap[depth+1][i_L+node_type_ind], L[depth][i_L ], L[depth][i_L+temp/2]);
+                        }
                     }
 
                     /* Next node: right child */
@@ -509,20 +530,19 @@ void decode(int *msg_cap, int N, int n, int K, int *LLR_Q, int *info_nodes, int
                 {
                     /* Combine */
                     int count = 0;
-                    uint8x16_t data1, data2;
-                    if (temp > 16)
+                    simd_u8 data1, data2;
+                    if (temp/2 >= SIMD_U8_LANES)
                     {
-                        for (i_L = 0; i_L < temp/2; i_L+=16)
+                        for (i_L = 0; i_L < temp/2; i_L+=SIMD_U8_LANES)
                         { 
-                            data1 = vld1q_u8 (&ucap[depth + 1][i_L + node_type_ind]);
-                            data2 = vld1q_u8 (&ucap[depth + 1][i_L + node_type_ind + temp/2]);
+                            data1 = simd_load_u8 (&ucap[depth + 1][i_L + node_type_ind]);
+                            data2 = simd_load_u8 (&ucap[depth + 1][i_L + node_type_ind + temp/2]);
 
-                            data1 = veorq_u8 (data1, data2);
+                            data1 = simd_xor_u8 (data1, data2);
 
-                            vst1q_u8(&ucap[depth][i_L + node_type_ind],data1);
-                            vst1q_u8(&ucap[depth][i_L + node_type_ind + temp/2],data2);
+                            simd_store_u8(&ucap[depth][i_L + node_type_ind],data1);
+                            simd_store_u8(&ucap[depth][i_L + node_type_ind + temp/2],data2);
                         }
-                        count+=16;
                     }
 
                     else
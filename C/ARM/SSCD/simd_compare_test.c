@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <string.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include "../../common/simd.h"
+
+
+/* Checks the SIMD compare and the Rate-1 hard decision of functions_SSCD_ARM.c
+ * against plain C, for whichever backend simd.h picked */
+int main()
+{
+	simd_s8 a, b;
+
+	simd_u8 result;
+
+	int8_t a_int[32] = {1,2,-3,4,5,-6,7,8,-1,2,3,4,-5,6,7,-8,0,0,-32,31,-32,31,0,-1,1,-1,9,-9,16,-16,0,5};
+	int8_t b_int[32] = {5,6,-7,3,4,-9,22,3,-6,7,78,1,2,3,4,9,0,1,-32,31,31,-32,-1,0,1,1,-9,9,-16,16,0,-5};
+	uint8_t result_int[32];
+	uint8_t result_simd[32];
+
+	int i, i_v;
+	int errors = 0;
+
+	printf("backend %s, %d lanes\n", SIMD_BACKEND_NAME, SIMD_U8_LANES);
+
+	for(i = 0; i < 32; i++)
+	{
+		if (b_int[i] >= a_int[i])
+			result_int[i] = 1;
+		else
+			result_int[i] = 0;
+
+		printf("%d\t", result_int[i]);
+	}
+
+	printf("\n");
+
+	/* b >= a, masked to 0/1 as the Rate-1 node does */
+	for(i_v = 0; i_v < 32; i_v += SIMD_U8_LANES)
+	{
+		a = simd_load_s8(&a_int[i_v]);
+		b = simd_load_s8(&b_int[i_v]);
+
+		result = simd_and_u8(simd_cge_s8(b,a), simd_dup_u8(1));
+
+		simd_store_u8(&result_simd[i_v],result);
+	}
+
+	for(i = 0; i < 32; i++)
+	{
+		printf("%d\t", result_simd[i]);
+		errors += result_simd[i] != result_int[i];
+	}
+
+	printf("\nxor test\n");
+	printf("%d\t", 255^0);
+	printf("%d\n", 1^0);
+
+	printf("%d\t", 255^255);
+	printf("%d\t", 1^1);
+	printf("%d\t", 1^255);
+	printf("%d\n", 255^1);
+
+	printf("%d mismatches\n", errors);
+
+	return errors != 0;
+}
@@ -5,10 +5,11 @@
 #include <string.h>
 
 #include "functions_SSCL_ARM.h"
+#include "../../common/latency.h"
+#include "../../common/pmu.h"
 
 #include <stdint.h>
 #include <inttypes.h>
-#include <arm_neon.h>
 
 int main(){
 
@@ -184,11 +185,16 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     /*Simulations corresponding to each sig*/
     int i_sig = 0;
     int count[1];
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
     for (i_sig = 0; i_sig < num_EbN0dB; i_sig++)
     {
         printf("Count %d of %d\n", i_sig+1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
         
         BER[i_sig] = 0;
@@ -277,6 +283,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
             int crc_check[l];
 
             dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
             decode_unrolled(N, K, l, info_nodes, data_pos, node_type, LLR_Q, msg_cap);
 
@@ -298,6 +306,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
                 crc_ind = 0;
             }
 
+            PMU_STOP(K - crc_l);
+            lat_record(&lat, lat_now_ns() - lat_start);
             dec_end = clock();
 
             dec_cpu_time_used = dec_cpu_time_used + ( dec_end - dec_start );
@@ -315,6 +325,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         printf("EbN0dB %0.2f\t", EbN0dB[i_sig]);
         BER[i_sig] = (double) err_count/(N*num_sim);
         printf("BER %lf\n", BER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     } // end of noise var loop
 
@@ -329,5 +343,7 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     printf("Decoder throughput is %0.2f Mbps for list size %d\n", ((float)(num_sim*num_EbN0dB)/(dec_cpu_time_used*1000)),l);
     printf("Encoder throughput is %0.2f Mbps\n", ((float)(num_sim*num_EbN0dB)/(enc_cpu_time_used*1000)));
 
+    lat_print(stdout, "all points", &lat_all);
+
 return 0;
 }
\ No newline at end of file
@@ -8,7 +8,7 @@
 
 #include <stdint.h>
 #include <inttypes.h>
-#include <arm_neon.h>
+#include "../../common/simd.h"
 
 #define maxqr 31
 #define sign_macro(x) ((x > 0) - (x < 0))
@@ -92,7 +92,7 @@ void encode(uint8_t *u, int N)
     /* log function */
     while (N >>= 1) n++;
 
-    uint8x16_t data1, data2;
+    simd_u8 data1, data2;
 
     int i_s;
     int i_g;
@@ -111,16 +111,16 @@ void encode(uint8_t *u, int N)
             base = (1 << (i_s+1)) * (i_g);
 
             /* Sub group after sub group */
-            if (del >= 16)
+            if (del >= SIMD_U8_LANES)
             {
-                for (i_sg = 0; i_sg < del; i_sg+=16)
+                for (i_sg = 0; i_sg < del; i_sg+=SIMD_U8_LANES)
                 {
-                    data1 = vld1q_u8(&u[base+i_sg]);
-                    data2 = vld1q_u8(&u[base+i_sg+del]);
+                    data1 = simd_load_u8(&u[base+i_sg]);
+                    data2 = simd_load_u8(&u[base+i_sg+del]);
 
-                    data1 = veorq_u8(data1, data2);
+                    data1 = simd_xor_u8(data1, data2);
 
-                    vst1q_u8(&u[base+i_sg],data1);
+                    simd_store_u8(&u[base+i_sg],data1);
                 }
             }
 
@@ -177,15 +177,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
     int i_g;
     int i_sg;
 
-    uint8x16_t data_zero, data_one;
-    const uint8_t zero = 0;
-    const uint8_t one = 1;
-    data_zero = vld1q_dup_u8(&zero);
-    data_one = vld1q_dup_u8(&one);
-
-    const int8_t zero_s = 0;
-    int8x16_t data_zero_s;
-    data_zero_s = vld1q_dup_s8(&zero_s);
+    const simd_u8 data_zero = simd_dup_u8(0);
 
     int key_arr, key_ind, cur_index;
 
@@ -399,11 +391,11 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     ( L[depth][i_temp + i_list*N] < 0 ) ? ( PM[i_list] = PM[i_list] + absl_macro(L[depth][i_temp + i_list*N]) ) : 1 ;
                 }
 
-                if (temp > 16)
+                if (temp >= SIMD_U8_LANES)
                 {
-                    for (i_temp = 0; i_temp < temp; i_temp+=16)
+                    for (i_temp = 0; i_temp < temp; i_temp+=SIMD_U8_LANES)
                     {
-                        vst1q_u8(&beta[depth][i_temp + node_type_ind + i_list*N],data_zero);
+                        simd_store_u8(&beta[depth][i_temp + node_type_ind + i_list*N],data_zero);
                     }
                 }
                 else
@@ -505,7 +497,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     PM[i_list] = PM_temp[i_list];
                 }
 
-                uint8x16_t data;
+                simd_u8 data;
                 for (i_list = 0; i_list < l; i_list++)
                 {
                     PM[i_list] = PM_temp[i_list];
@@ -513,20 +505,15 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     ind_ord_old[i_list] = ind_ord[i_list];
                     ind_ord_old[i_list + l] = ind_ord[i_list + l];
 
-                    if (i_NN > 16)
+                    /* The i_NN bits decided so far: whole vectors, then the tail */
+                    for (i_N = 0; i_N + SIMD_U8_LANES <= i_NN; i_N+=SIMD_U8_LANES)
                     {
-                        for (i_N = 0; i_N < i_NN; i_N+=16)
-                        {
-                            data = vld1q_u8 (&beta[depth][i_N + node_type_ind + i_list*N]);
-                            vst1q_u8(&beta_copy[i_N + i_list*temp],data);
-                        }
+                        data = simd_load_u8 (&beta[depth][i_N + node_type_ind + i_list*N]);
+                        simd_store_u8(&beta_copy[i_N + i_list*temp],data);
                     }
-                    else
+                    for (; i_N < i_NN; i_N++)
                     {
-                        for (i_N = 0; i_N < i_NN; i_N++)
-                        {
-                            beta_copy[i_N + i_list*temp] = beta[depth][i_N + node_type_ind + i_list*N];
-                        }
+                        beta_copy[i_N + i_list*temp] = beta[depth][i_N + node_type_ind + i_list*N];
                     }
 
                     
@@ -538,20 +525,14 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     {
                         i_temp = (ind_ord_temp[ i_list]%l)*temp;
 
-                        if (i_NN > 16)
+                        for (i_N = 0; i_N + SIMD_U8_LANES <= i_NN; i_N+=SIMD_U8_LANES)
                         {
-                            for (i_N = 0; i_N < i_NN; i_N+=16)
-                            {
-                                data = vld1q_u8 (&beta_copy[i_N + i_temp]);
-                                vst1q_u8(&beta[depth][i_N + node_type_ind + i_list*N],data);
-                            }
+                            data = simd_load_u8 (&beta_copy[i_N + i_temp]);
+                            simd_store_u8(&beta[depth][i_N + node_type_ind + i_list*N],data);
                         }
-                        else
+                        for (; i_N < i_NN; i_N++)
                         {
-                            for (i_N = 0; i_N < i_NN; i_N++)
-                            {
-                                beta[depth][i_N + node_type_ind + i_list*N] = beta_copy[i_N + i_temp];
-                            }
+                            beta[depth][i_N + node_type_ind + i_list*N] = beta_copy[i_N + i_temp];
                         }
                     }                       
 
@@ -845,17 +826,17 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                         i_temp = node_type_ind + i_list*N;
                         i_temp_ord = node_type_ind + (ind_ord_mat[depth + 1][2*node + 1 + i_list*N])*N;
                         
-                        uint8x16_t data1, data2;
-                        if (temp >= 16)
+                        simd_u8 data1, data2;
+                        if (temp/2 >= SIMD_U8_LANES)
                         {
-                            for (i_up = 0; i_up < temp/2; i_up+=16)
+                            for (i_up = 0; i_up < temp/2; i_up+=SIMD_U8_LANES)
                             {
-                                data1 = vld1q_u8 (&beta[depth+1][i_up + i_temp_ord]);
-                                data2 = vld1q_u8 (&beta[depth+1][i_temp + temp/2 + i_up]);
+                                data1 = simd_load_u8 (&beta[depth+1][i_up + i_temp_ord]);
+                                data2 = simd_load_u8 (&beta[depth+1][i_temp + temp/2 + i_up]);
 
-                                data1 = veorq_u8 (data1, data2);
-                                vst1q_u8(&beta[depth][i_up + i_temp],data1);
-                                vst1q_u8(&beta[depth][i_up + temp/2 + i_temp],data2);
+                                data1 = simd_xor_u8 (data1, data2);
+                                simd_store_u8(&beta[depth][i_up + i_temp],data1);
+                                simd_store_u8(&beta[depth][i_up + temp/2 + i_temp],data2);
                             }
                         }
 
@@ -890,14 +871,14 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
     {
         i_n = i_list*N;
 
-        uint8x16_t data;
+        simd_u8 data;
 
-        if (N > 16)
+        if (N >= SIMD_U8_LANES)
         {
-            for (i_N = 0; i_N < N; i_N+=16)
+            for (i_N = 0; i_N < N; i_N+=SIMD_U8_LANES)
             {
-                data = vld1q_u8 (&beta[0][i_n + i_N]);
-                vst1q_u8(&temp_beta[i_N], data);
+                data = simd_load_u8 (&beta[0][i_n + i_N]);
+                simd_store_u8(&temp_beta[i_N], data);
             }
         }
         else
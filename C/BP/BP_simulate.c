@@ -0,0 +1,510 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <string.h>
+
+#include "functions_BP.h"
+#include "latency.h"
+
+/* Channel reliability in increasing order*/
+static const int Q[1024] = {
+    0,    1,    2,   4,    8,    16,   32,   3,    5,    64,   9,   6,    17,
+    10,   18,   128, 12,   33,   65,   20,   256,  34,   24,   36,  7,    129,
+    66,   512,  11,  40,   68,   130,  19,   13,   48,   14,   72,  257,  21,
+    132,  35,   258, 26,   513,  80,   37,   25,   22,   136,  260, 264,  38,
+    514,  96,   67,  41,   144,  28,   69,   42,   516,  49,   74,  272,  160,
+    520,  288,  528, 192,  544,  70,   44,   131,  81,   50,   73,  15,   320,
+    133,  52,   23,  134,  384,  76,   137,  82,   56,   27,   97,  39,   259,
+    84,   138,  145, 261,  29,   43,   98,   515,  88,   140,  30,  146,  71,
+    262,  265,  161, 576,  45,   100,  640,  51,   148,  46,   75,  266,  273,
+    517,  104,  162, 53,   193,  152,  77,   164,  768,  268,  274, 518,  54,
+    83,   57,   521, 112,  135,  78,   289,  194,  85,   276,  522, 58,   168,
+    139,  99,   86,  60,   280,  89,   290,  529,  524,  196,  141, 101,  147,
+    176,  142,  530, 321,  31,   200,  90,   545,  292,  322,  532, 263,  149,
+    102,  105,  304, 296,  163,  92,   47,   267,  385,  546,  324, 208,  386,
+    150,  153,  165, 106,  55,   328,  536,  577,  548,  113,  154, 79,   269,
+    108,  578,  224, 166,  519,  552,  195,  270,  641,  523,  275, 580,  291,
+    59,   169,  560, 114,  277,  156,  87,   197,  116,  170,  61,  531,  525,
+    642,  281,  278, 526,  177,  293,  388,  91,   584,  769,  198, 172,  120,
+    201,  336,  62,  282,  143,  103,  178,  294,  93,   644,  202, 592,  323,
+    392,  297,  770, 107,  180,  151,  209,  284,  648,  94,   204, 298,  400,
+    608,  352,  325, 533,  155,  210,  305,  547,  300,  109,  184, 534,  537,
+    115,  167,  225, 326,  306,  772,  157,  656,  329,  110,  117, 212,  171,
+    776,  330,  226, 549,  538,  387,  308,  216,  416,  271,  279, 158,  337,
+    550,  672,  118, 332,  579,  540,  389,  173,  121,  553,  199, 784,  179,
+    228,  338,  312, 704,  390,  174,  554,  581,  393,  283,  122, 448,  353,
+    561,  203,  63,  340,  394,  527,  582,  556,  181,  295,  285, 232,  124,
+    205,  182,  643, 562,  286,  585,  299,  354,  211,  401,  185, 396,  344,
+    586,  645,  593, 535,  240,  206,  95,   327,  564,  800,  402, 356,  307,
+    301,  417,  213, 568,  832,  588,  186,  646,  404,  227,  896, 594,  418,
+    302,  649,  771, 360,  539,  111,  331,  214,  309,  188,  449, 217,  408,
+    609,  596,  551, 650,  229,  159,  420,  310,  541,  773,  610, 657,  333,
+    119,  600,  339, 218,  368,  652,  230,  391,  313,  450,  542, 334,  233,
+    555,  774,  175, 123,  658,  612,  341,  777,  220,  314,  424, 395,  673,
+    583,  355,  287, 183,  234,  125,  557,  660,  616,  342,  316, 241,  778,
+    563,  345,  452, 397,  403,  207,  674,  558,  785,  432,  357, 187,  236,
+    664,  624,  587, 780,  705,  126,  242,  565,  398,  346,  456, 358,  405,
+    303,  569,  244, 595,  189,  566,  676,  361,  706,  589,  215, 786,  647,
+    348,  419,  406, 464,  680,  801,  362,  590,  409,  570,  788, 597,  572,
+    219,  311,  708, 598,  601,  651,  421,  792,  802,  611,  602, 410,  231,
+    688,  653,  248, 369,  190,  364,  654,  659,  335,  480,  315, 221,  370,
+    613,  422,  425, 451,  614,  543,  235,  412,  343,  372,  775, 317,  222,
+    426,  453,  237, 559,  833,  804,  712,  834,  661,  808,  779, 617,  604,
+    433,  720,  816, 836,  347,  897,  243,  662,  454,  318,  675, 618,  898,
+    781,  376,  428, 665,  736,  567,  840,  625,  238,  359,  457, 399,  787,
+    591,  678,  434, 677,  349,  245,  458,  666,  620,  363,  127, 191,  782,
+    407,  436,  626, 571,  465,  681,  246,  707,  350,  599,  668, 790,  460,
+    249,  682,  573, 411,  803,  789,  709,  365,  440,  628,  689, 374,  423,
+    466,  793,  250, 371,  481,  574,  413,  603,  366,  468,  655, 900,  805,
+    615,  684,  710, 429,  794,  252,  373,  605,  848,  690,  713, 632,  482,
+    806,  427,  904, 414,  223,  663,  692,  835,  619,  472,  455, 796,  809,
+    714,  721,  837, 716,  864,  810,  606,  912,  722,  696,  377, 435,  817,
+    319,  621,  812, 484,  430,  838,  667,  488,  239,  378,  459, 622,  627,
+    437,  380,  818, 461,  496,  669,  679,  724,  841,  629,  351, 467,  438,
+    737,  251,  462, 442,  441,  469,  247,  683,  842,  738,  899, 670,  783,
+    849,  820,  728, 928,  791,  367,  901,  630,  685,  844,  633, 711,  253,
+    691,  824,  902, 686,  740,  850,  375,  444,  470,  483,  415, 485,  905,
+    795,  473,  634, 744,  852,  960,  865,  693,  797,  906,  715, 807,  474,
+    636,  694,  254, 717,  575,  913,  798,  811,  379,  697,  431, 607,  489,
+    866,  723,  486, 908,  718,  813,  476,  856,  839,  725,  698, 914,  752,
+    868,  819,  814, 439,  929,  490,  623,  671,  739,  916,  463, 843,  381,
+    497,  930,  821, 726,  961,  872,  492,  631,  729,  700,  443, 741,  845,
+    920,  382,  822, 851,  730,  498,  880,  742,  445,  471,  635, 932,  687,
+    903,  825,  500, 846,  745,  826,  732,  446,  962,  936,  475, 853,  867,
+    637,  907,  487, 695,  746,  828,  753,  854,  857,  504,  799, 255,  964,
+    909,  719,  477, 915,  638,  748,  944,  869,  491,  699,  754, 858,  478,
+    968,  383,  910, 815,  976,  870,  917,  727,  493,  873,  701, 931,  756,
+    860,  499,  731, 823,  922,  874,  918,  502,  933,  743,  760, 881,  494,
+    702,  921,  501, 876,  847,  992,  447,  733,  827,  934,  882, 937,  963,
+    747,  505,  855, 924,  734,  829,  965,  938,  884,  506,  749, 945,  966,
+    755,  859,  940, 830,  911,  871,  639,  888,  479,  946,  750, 969,  508,
+    861,  757,  970, 919,  875,  862,  758,  948,  977,  923,  972, 761,  877,
+    952,  495,  703, 935,  978,  883,  762,  503,  925,  878,  735, 993,  885,
+    939,  994,  980, 926,  764,  941,  967,  886,  831,  947,  507, 889,  984,
+    751,  942,  996, 971,  890,  509,  949,  973,  1000, 892,  950, 863,  759,
+    1008, 510,  979, 953,  763,  974,  954,  879,  981,  982,  927, 995,  765,
+    956,  887,  985, 997,  986,  943,  891,  998,  766,  511,  988, 1001, 951,
+    1002, 893,  975, 894,  1009, 955,  1004, 1010, 957,  983,  958, 987,  1012,
+    999,  1016, 767, 989,  1003, 990,  1005, 959,  1011, 1013, 895, 1006, 1014,
+    1017, 1018, 991, 1020, 1007, 1015, 1019, 1021, 1022, 1023};
+
+
+/* Simulation Parameters */
+// No. of levels of Noise
+#define NUM_EbN0dB (6)
+// Number of Simulations
+#define NUM_SIM    (2000)
+// Maximum number of BP iterations
+#define MAX_ITER   (40)
+// Normalized min-sum scale of the processing element in 1/8
+#define ALPHA_Q    (7)
+// Adjacent stage swaps of every permuted factor graph of the ensemble
+#define NUM_SWAPS  (2)
+// Frames and Eb/N0 of the pruned vs dense schedule benchmark
+#define NUM_SIM_PRUNE (200)
+#define EbN0dB_PRUNE  (2.5f)
+
+/* Code Parameters */
+#define CODE_N     (1024)
+#define CODE_n     (10)
+// Number of information bits, CRC included (rate 1/2)
+#define CODE_K     (512)
+// Length of CRC
+#define CRC_L      (8)
+// Max received value and max integer received value
+#define RMAX       (3.0f)
+#define MAXQR      (31)
+
+/* CRC polynomial */
+static const int polynomial[CRC_L + 1] = {1, 1, 1, 0, 1, 0, 1, 0, 1};
+
+/* Stopping rules compared by the default simulation */
+static const BpStopRule stop_rules[] = {
+    BP_STOP_NONE, BP_STOP_G_MATRIX, BP_STOP_CRC};
+static const char *stop_names[] = {"fixed", "G-matrix", "CRC"};
+#define NUM_RULES ((int)(sizeof(stop_rules) / sizeof(stop_rules[0])))
+
+static float EbN0dB_at(const int i_sig) { return 1.0f + 0.5f * (float)i_sig; }
+
+static float sigma_of(const float EbN0dB, const float rate) {
+    return sqrtf(1.0f / (2.0f * rate) * powf(10.0f, -EbN0dB / 10.0f));
+}
+
+static float sigma_at(const int i_sig) {
+    return sigma_of(EbN0dB_at(i_sig), (float)CODE_K / (float)CODE_N);
+}
+
+/* K most reliable positions of the N < 1024 subsequence of Q */
+static void frozen_set(const int N, const int K, int *info_nodes,
+                       int *data_pos) {
+    int i_s = 0;
+    for (int i_Q = 0; i_Q < 1024; i_Q++) {
+        if (Q[i_Q] >= N) continue;
+        info_nodes[Q[i_Q]] = i_s >= N - K;
+        if (i_s >= N - K) {
+            data_pos[i_s - (N - K)] = Q[i_Q];
+        }
+        i_s++;
+    }
+}
+
+static double wall_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Random message with CRC, encoded, BPSK over AWGN and quantized */
+static void make_frame(const int N, const int K, const int *data_pos,
+                       const float sig, int *msg, int16_t *LLR_Q) {
+    for (int i_msg = 0; i_msg < K - CRC_L; i_msg++) {
+        msg[i_msg] = uni();
+    }
+    for (int i_msg = K - CRC_L; i_msg < K; i_msg++) {
+        msg[i_msg] = 0;
+    }
+    crcGen(msg, K, polynomial, CRC_L);
+
+    int u[N];
+    memset(u, 0, sizeof(u));
+    for (int i_ud = 0; i_ud < K; i_ud++) {
+        u[data_pos[i_ud]] = msg[i_ud];
+    }
+    encode(u, N);
+
+    for (int i_ch = 0; i_ch < N; i_ch++) {
+        const float y = (float)(1 - 2 * u[i_ch]) + randn(0, sig);
+        int q = (int)floorf(y / RMAX * (float)MAXQR);
+        q = q > MAXQR ? MAXQR : q < -(MAXQR + 1) ? -(MAXQR + 1) : q;
+        LLR_Q[i_ch] = (int16_t)q;
+    }
+}
+
+static int count_errors(const int K, const int *msg, const int *msg_cap) {
+    int cur_err = 0;
+    for (int i_err = 0; i_err < K - CRC_L; i_err++) {
+        cur_err += msg_cap[i_err] != msg[i_err];
+    }
+    return cur_err;
+}
+
+/* Fixed iterations vs G-matrix vs CRC early stopping on one factor graph */
+static void simulate_stop_rules(BpParams *params, const int *data_pos) {
+    float dec_time_used[NUM_RULES];
+    memset(dec_time_used, 0, sizeof(dec_time_used));
+
+    /* Wall-clock decode latency per rule, per Eb/N0 point and overall */
+    static LatHist lat[NUM_RULES], lat_all[NUM_RULES];
+    for (int i_rule = 0; i_rule < NUM_RULES; i_rule++) {
+        lat_reset(&lat_all[i_rule]);
+    }
+
+    for (int i_sig = 0; i_sig < NUM_EbN0dB; i_sig++) {
+        printf("Count %d of %d\n", i_sig + 1, NUM_EbN0dB);
+
+        int err_count[NUM_RULES], frame_err[NUM_RULES], iter_count[NUM_RULES];
+        memset(err_count, 0, sizeof(err_count));
+        memset(frame_err, 0, sizeof(frame_err));
+        memset(iter_count, 0, sizeof(iter_count));
+        for (int i_rule = 0; i_rule < NUM_RULES; i_rule++) {
+            lat_reset(&lat[i_rule]);
+        }
+
+        for (int i_num_sim = 0; i_num_sim < NUM_SIM; i_num_sim++) {
+            int msg[CODE_K];
+            int16_t LLR_Q[CODE_N];
+            make_frame(
+                CODE_N, CODE_K, data_pos, sigma_at(i_sig), msg, LLR_Q);
+
+            for (int i_rule = 0; i_rule < NUM_RULES; i_rule++) {
+                int msg_cap[CODE_K];
+                params->stop = stop_rules[i_rule];
+
+                const clock_t dec_start = clock();
+                const uint64_t lat_start = lat_now_ns();
+                iter_count[i_rule] += bp_decode(params, LLR_Q, msg_cap);
+                lat_record(&lat[i_rule], lat_now_ns() - lat_start);
+                dec_time_used[i_rule] += (float)(clock() - dec_start);
+
+                const int cur_err = count_errors(CODE_K, msg, msg_cap);
+                err_count[i_rule] += cur_err;
+                frame_err[i_rule] += cur_err > 0;
+            }
+        }  // end of no. of simulations loop
+
+        for (int i_rule = 0; i_rule < NUM_RULES; i_rule++) {
+            printf("EbN0dB %0.2f\t%-8s BER %lf\t BLER %lf\t iter %0.2f\n",
+                   EbN0dB_at(i_sig),
+                   stop_names[i_rule],
+                   (double)err_count[i_rule] / ((CODE_K - CRC_L) * NUM_SIM),
+                   (double)frame_err[i_rule] / NUM_SIM,
+                   (double)iter_count[i_rule] / NUM_SIM);
+            lat_print(stdout, stop_names[i_rule], &lat[i_rule]);
+            lat_merge(&lat_all[i_rule], &lat[i_rule]);
+        }
+    }  // end of noise var loop
+
+    for (int i_rule = 0; i_rule < NUM_RULES; i_rule++) {
+        printf("Decoder throughput with %s stopping is %0.2f Mbps\n",
+               stop_names[i_rule],
+               (float)(CODE_K - CRC_L) * NUM_SIM * NUM_EbN0dB
+                   / (dec_time_used[i_rule] / CLOCKS_PER_SEC * 1e6f));
+        lat_print(stdout, stop_names[i_rule], &lat_all[i_rule]);
+    }
+}
+
+/* Single factor graph vs an ensemble of M permuted factor graphs, both with
+ * CRC stopping. Latencies are wall clock times per frame. */
+static void simulate_ensemble(const BpParams *base, const int *data_pos,
+                              const int M) {
+    BpParams params = *base;
+
+    /* Graph 0 keeps the natural stage order */
+    int perms[BP_MAX_GRAPHS * CODE_n];
+    for (int t = 0; t < CODE_n; t++) {
+        perms[t] = t;
+    }
+    for (int m = 1; m < M; m++) {
+        bp_random_stage_perm(&perms[m * CODE_n], CODE_n, NUM_SWAPS);
+    }
+
+    /* Pruned schedule of every graph */
+    BpSchedule scheds[BP_MAX_GRAPHS];
+    for (int m = 0; m < M; m++) {
+        if (bp_build_schedule(&scheds[m],
+                              params.info_nodes,
+                              CODE_N,
+                              CODE_n,
+                              &perms[m * CODE_n])
+            != 0) {
+            fprintf(stderr, "out of memory for the schedule of graph %d\n", m);
+            while (m-- > 0) {
+                bp_free_schedule(&scheds[m]);
+            }
+            return;
+        }
+    }
+
+    params.stop = BP_STOP_CRC;
+    params.perm = NULL;
+    params.sched = &scheds[0];
+
+    static BpEnsemble ens;
+    if (bp_ensemble_init(&ens, M) != 0) {
+        fprintf(stderr, "cannot start the %d ensemble workers\n", M - 1);
+        for (int m = 0; m < M; m++) {
+            bp_free_schedule(&scheds[m]);
+        }
+        return;
+    }
+
+    static double lat_single[NUM_SIM], lat_ens[NUM_SIM];
+
+    for (int i_sig = 0; i_sig < NUM_EbN0dB; i_sig++) {
+        int frame_err_single = 0, frame_err_ens = 0;
+        int iter_single = 0, iter_ens = 0, crc_fail_ens = 0;
+        int win_count[BP_MAX_GRAPHS] = {0};
+
+        for (int i_num_sim = 0; i_num_sim < NUM_SIM; i_num_sim++) {
+            int msg[CODE_K], msg_cap[CODE_K];
+            int16_t LLR_Q[CODE_N];
+            make_frame(
+                CODE_N, CODE_K, data_pos, sigma_at(i_sig), msg, LLR_Q);
+
+            double dec_start = wall_us();
+            iter_single += bp_decode(&params, LLR_Q, msg_cap);
+            lat_single[i_num_sim] = wall_us() - dec_start;
+            frame_err_single += count_errors(CODE_K, msg, msg_cap) > 0;
+
+            int iter = 0;
+            dec_start = wall_us();
+            const int win = bp_ensemble_decode(
+                &ens, &params, perms, scheds, LLR_Q, msg_cap, &iter);
+            lat_ens[i_num_sim] = wall_us() - dec_start;
+            frame_err_ens += count_errors(CODE_K, msg, msg_cap) > 0;
+            iter_ens += iter;
+            if (win >= 0) {
+                win_count[win]++;
+            } else {
+                crc_fail_ens++;
+            }
+        }  // end of no. of simulations loop
+
+        qsort(lat_single, NUM_SIM, sizeof(double), cmp_double);
+        qsort(lat_ens, NUM_SIM, sizeof(double), cmp_double);
+
+        const double fer_single = (double)frame_err_single / NUM_SIM;
+        const double fer_ens = (double)frame_err_ens / NUM_SIM;
+        printf("EbN0dB %0.2f\n", EbN0dB_at(i_sig));
+        printf("  single   BLER %lf\t iter %0.2f\n",
+               fer_single,
+               (double)iter_single / NUM_SIM);
+        printf("  M = %-3d  BLER %lf\t iter %0.2f\t no CRC pass %d\n",
+               M,
+               fer_ens,
+               (double)iter_ens / NUM_SIM,
+               crc_fail_ens);
+        printf("  BLER gain %0.2fx\n",
+               fer_ens > 0 ? fer_single / fer_ens : INFINITY);
+        printf("  latency [us]  p50      p90      p99      max\n");
+        printf("  single   %8.1f %8.1f %8.1f %8.1f\n",
+               lat_single[NUM_SIM / 2],
+               lat_single[NUM_SIM * 9 / 10],
+               lat_single[NUM_SIM * 99 / 100],
+               lat_single[NUM_SIM - 1]);
+        printf("  ensemble %8.1f %8.1f %8.1f %8.1f\n",
+               lat_ens[NUM_SIM / 2],
+               lat_ens[NUM_SIM * 9 / 10],
+               lat_ens[NUM_SIM * 99 / 100],
+               lat_ens[NUM_SIM - 1]);
+        printf("  winning graph:");
+        for (int m = 0; m < M; m++) {
+            printf(" %d", win_count[m]);
+        }
+        printf("\n");
+    }  // end of noise var loop
+
+    bp_ensemble_free(&ens);
+    for (int m = 0; m < M; m++) {
+        bp_free_schedule(&scheds[m]);
+    }
+}
+
+/* Messages removed by the pruned schedule and its speedup over the dense
+ * schedule, per (N, K). Both run MAX_ITER iterations on the same frames. */
+static void simulate_pruning(void) {
+    static const int code_N[] = {128, 256, 512, 1024};
+    static const int code_n[] = {7, 8, 9, 10};
+    static const int num_rates = 3;
+
+    printf("    N     K  edges/iter    kept  removed  "
+           "dense [us]  pruned [us]  speedup  BLER dense/pruned\n");
+
+    for (int i_n = 0; i_n < 4; i_n++) {
+        const int N = code_N[i_n];
+        for (int i_r = 1; i_r <= num_rates; i_r++) {
+            const int K = N * i_r / (num_rates + 1);
+
+            int info_nodes[N], data_pos[K];
+            frozen_set(N, K, info_nodes, data_pos);
+
+            BpSchedule sched;
+            if (bp_build_schedule(&sched, info_nodes, N, code_n[i_n], NULL)
+                != 0) {
+                return;
+            }
+
+            BpParams params = {.N = N,
+                               .n = code_n[i_n],
+                               .K = K,
+                               .info_nodes = info_nodes,
+                               .data_pos = data_pos,
+                               .max_iter = MAX_ITER,
+                               .stop = BP_STOP_NONE,
+                               .polynomial = polynomial,
+                               .crc_l = CRC_L,
+                               .variant = MINSUM_NORMALIZED,
+                               .param = ALPHA_Q,
+                               .perm = NULL,
+                               .sched = NULL};
+
+            const float sig = sigma_of(EbN0dB_PRUNE, (float)K / (float)N);
+            double time_used[2] = {0, 0};
+            int frame_err[2] = {0, 0};
+
+            for (int i_num_sim = 0; i_num_sim < NUM_SIM_PRUNE; i_num_sim++) {
+                int msg[K], msg_cap[K];
+                int16_t LLR_Q[N];
+                make_frame(N, K, data_pos, sig, msg, LLR_Q);
+
+                for (int i_s = 0; i_s < 2; i_s++) {
+                    params.sched = i_s ? &sched : NULL;
+
+                    const double dec_start = wall_us();
+                    bp_decode(&params, LLR_Q, msg_cap);
+                    time_used[i_s] += wall_us() - dec_start;
+                    frame_err[i_s] += count_errors(K, msg, msg_cap) > 0;
+                }
+            }
+
+            printf("%5d %5d  %10d  %6d  %6.1f%%  %10.1f  %11.1f  %6.2fx  "
+                   "%lf/%lf\n",
+                   N,
+                   K,
+                   sched.edges_total,
+                   sched.edges_kept,
+                   100.0 * (sched.edges_total - sched.edges_kept)
+                       / sched.edges_total,
+                   time_used[0] / NUM_SIM_PRUNE,
+                   time_used[1] / NUM_SIM_PRUNE,
+                   time_used[0] / time_used[1],
+                   (double)frame_err[0] / NUM_SIM_PRUNE,
+                   (double)frame_err[1] / NUM_SIM_PRUNE);
+
+            bp_free_schedule(&sched);
+        }
+    }
+}
+
+/* Usage: hello [M | prune]
+ * Without arguments the stopping rules are compared on the natural factor
+ * graph. With M one graph is compared with an ensemble of M permuted factor
+ * graphs decoded in parallel threads, with prune the pruned schedule is
+ * compared with the dense one for several (N, K). */
+int main(int argc, char **argv) {
+    srand((unsigned)time(NULL));
+
+    if (argc > 1 && strcmp(argv[1], "prune") == 0) {
+        simulate_pruning();
+        return 0;
+    }
+
+    const int M = argc > 1 ? atoi(argv[1]) : 0;
+    if (argc > 1 && (M < 1 || M > BP_MAX_GRAPHS)) {
+        fprintf(stderr, "M must be in 1 ... %d\n", BP_MAX_GRAPHS);
+        return EXIT_FAILURE;
+    }
+
+    /* Boolean array with information nodes pos = 1 */
+    int info_nodes[CODE_N];
+
+    /* Position of Information bits */
+    int data_pos[CODE_K];
+
+    frozen_set(CODE_N, CODE_K, info_nodes, data_pos);
+
+    BpParams params = {.N = CODE_N,
+                       .n = CODE_n,
+                       .K = CODE_K,
+                       .info_nodes = info_nodes,
+                       .data_pos = data_pos,
+                       .max_iter = MAX_ITER,
+                       .stop = BP_STOP_NONE,
+                       .polynomial = polynomial,
+                       .crc_l = CRC_L,
+                       .variant = MINSUM_NORMALIZED,
+                       .param = ALPHA_Q,
+                       .perm = NULL,
+                       .sched = NULL};
+
+    if (M > 0) {
+        simulate_ensemble(&params, data_pos, M);
+    } else {
+        BpSchedule sched;
+        if (bp_build_schedule(&sched, info_nodes, CODE_N, CODE_n, NULL) != 0) {
+            return EXIT_FAILURE;
+        }
+        params.sched = &sched;
+        simulate_stop_rules(&params, data_pos);
+        bp_free_schedule(&sched);
+    }
+
+    return 0;
+}
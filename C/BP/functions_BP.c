@@ -0,0 +1,540 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "functions_BP.h"
+
+#pragma GCC optimize("Ofast")
+
+/*Uniform distribution number generator*/
+int uni() { return rand() % 2; }  // NOLINT(*-msc50-cpp)
+
+/*Gaussian random number generator*/
+// Box muller method, see
+// https://mathworld.wolfram.com/Box-MullerTransformation.html
+float randn(const float mu, const float sigma) {
+    float U1, U2, W;
+    static float X1, X2;
+    static bool call = false;
+
+    if (call) {
+        call = !call;
+        return mu + sigma * X2;
+    }
+
+    do {
+        U1 = -1 + (float)rand() / (float)(RAND_MAX) * 2;  // NOLINT(*-msc50-cpp)
+        U2 = -1 + (float)rand() / (float)(RAND_MAX) * 2;  // NOLINT(*-msc50-cpp)
+        W = U1 * U1 + U2 * U2;
+    } while (W >= 1 || W <= 0);
+
+    const float normalize_coefficient = sqrtf(-2.0f * logf(W) / W);
+    X1 = U1 * normalize_coefficient;
+    X2 = U2 * normalize_coefficient;
+
+    call = !call;
+
+    return mu + sigma * X1;
+}
+
+/*Encoder*/
+void encode(int *u, const int N) {
+    for (int del = 1; del < N; del <<= 1) {
+        /* Group after group in each stage */
+        for (int base = 0; base < N; base += 2 * del) {
+            /* Sub group after sub group */
+            for (int i_sg = 0; i_sg < del; i_sg++) {
+                u[base + i_sg] ^= u[base + i_sg + del];
+            }
+        }
+    }
+}
+
+void crcGen(int *msg, const int K, const int *polynomial, const int m) {
+    int msg_copy[K];
+    memcpy(msg_copy, msg, sizeof(int) * (size_t)K);
+
+    for (int i = 0; i < K - m + 1; i++) {
+        if (msg_copy[i] != 0) {
+            for (int j = 0; j < m; j++) {
+                msg_copy[i + j] ^= polynomial[j];
+            }
+        }
+    }
+
+    for (int i = K - m; i < K; i++) {
+        msg[i] = msg_copy[i];
+    }
+}
+
+void crcDet(const int *msg_cap, const int K, const int l,
+            const int *polynomial, const int m, int *crc_check) {
+    int msg_copy[K];
+
+    for (int il = 0; il < l; il++) {
+        memcpy(msg_copy, &msg_cap[il * K], sizeof(int) * (size_t)K);
+
+        for (int i = 0; i < K - m + 1; i++) {
+            if (msg_copy[i] != 0) {
+                for (int j = 0; j < m; j++) {
+                    msg_copy[i + j] ^= polynomial[j];
+                }
+            }
+        }
+
+        int sum = 0;
+        for (int i = K - m; i < K; i++) {
+            sum += msg_copy[i];
+        }
+        crc_check[il] = sum > 0;
+    }
+}
+
+/* Leftward (R to L) update of the butterflies j ... j+len-1 of stage t with
+ * distance d:
+ *   L[t][j]     = f(L[t+1][j], L[t+1][j+d] + R[t][j+d])   (if top)
+ *   L[t][j + d] = f(L[t+1][j], R[t][j]) + L[t+1][j+d]     (if bot)
+ * Each half is one vector min-sum PE of length len. */
+static void bp_segment_left(int16_t *L_t, const int16_t *L_t1,
+                            const int16_t *R_t, const int j, const int len,
+                            const int d, const bool top, const bool bot,
+                            const MinSumVariant variant, const int param) {
+    int16_t tmp[len];
+
+    if (top) {
+        for (int i = 0; i < len; i++) {
+            tmp[i] = sat_i16(L_t1[j + d + i] + R_t[j + d + i]);
+        }
+        boxplus_i16(&L_t[j], &L_t1[j], tmp, len, variant, param);
+    }
+    if (bot) {
+        boxplus_i16(tmp, &L_t1[j], &R_t[j], len, variant, param);
+        for (int i = 0; i < len; i++) {
+            L_t[j + d + i] = sat_i16(tmp[i] + L_t1[j + d + i]);
+        }
+    }
+}
+
+/* Rightward (L to R) update of the butterflies j ... j+len-1 of stage t:
+ *   R[t+1][j]     = f(R[t][j], L[t+1][j+d] + R[t][j+d])   (if top)
+ *   R[t+1][j + d] = f(R[t][j], L[t+1][j]) + R[t][j+d]     (if bot) */
+static void bp_segment_right(int16_t *R_t1, const int16_t *R_t,
+                             const int16_t *L_t1, const int j, const int len,
+                             const int d, const bool top, const bool bot,
+                             const MinSumVariant variant, const int param) {
+    int16_t tmp[len];
+
+    if (top) {
+        for (int i = 0; i < len; i++) {
+            tmp[i] = sat_i16(L_t1[j + d + i] + R_t[j + d + i]);
+        }
+        boxplus_i16(&R_t1[j], &R_t[j], tmp, len, variant, param);
+    }
+    if (bot) {
+        boxplus_i16(tmp, &R_t[j], &L_t1[j], len, variant, param);
+        for (int i = 0; i < len; i++) {
+            R_t1[j + d + i] = sat_i16(tmp[i] + R_t[j + d + i]);
+        }
+    }
+}
+
+/* Pruning of the factor graph (the butterfly counterpart of pruneGraph.m).
+ * The state of every node follows from the frozen set alone:
+ *   top output a ^ b:  FREE if a is FREE, FROZEN if a and b are FROZEN
+ *   bottom output b:   FROZEN if b is FROZEN, FREE if a and b are FREE
+ * otherwise MIXED. R messages of FREE (0) and FROZEN (+inf) nodes are
+ * constant, and L messages of FROZEN nodes never reach an information bit,
+ * so only the L outputs of non-FROZEN nodes and the R outputs of MIXED nodes
+ * are scheduled. Returns 0, or -1 if out of memory. */
+int bp_build_schedule(BpSchedule *s, const int *info_nodes, const int N,
+                      const int n, const int *perm) {
+    memset(s, 0, sizeof(*s));
+    s->N = N;
+    s->n = n;
+
+    s->state = malloc(sizeof(uint8_t) * (size_t)((n + 1) * N));
+    /* At most one segment per butterfly */
+    s->seg = malloc(sizeof(BpSegment) * (size_t)(n * N));
+    if (!s->state || !s->seg) {
+        bp_free_schedule(s);
+        return -1;
+    }
+
+    uint8_t(*state)[N] = (uint8_t(*)[N])s->state;
+    for (int i_N = 0; i_N < N; i_N++) {
+        state[0][i_N] = info_nodes[i_N] ? BP_NODE_FREE : BP_NODE_FROZEN;
+    }
+    for (int t = 0; t < n; t++) {
+        const int d = 1 << (perm ? perm[t] : t);
+        for (int base = 0; base < N; base += 2 * d) {
+            for (int j = base; j < base + d; j++) {
+                const uint8_t a = state[t][j];
+                const uint8_t b = state[t][j + d];
+
+                state[t + 1][j] = a == BP_NODE_FREE ? BP_NODE_FREE
+                                  : a == BP_NODE_FROZEN && b == BP_NODE_FROZEN
+                                      ? BP_NODE_FROZEN
+                                      : BP_NODE_MIXED;
+                state[t + 1][j + d] = b == BP_NODE_FROZEN ? BP_NODE_FROZEN
+                                      : a == BP_NODE_FREE && b == BP_NODE_FREE
+                                          ? BP_NODE_FREE
+                                          : BP_NODE_MIXED;
+            }
+        }
+    }
+
+    int num_seg = 0;
+    s->edges_total = 2 * n * N;
+    for (int i_sweep = 0; i_sweep < 2 * n; i_sweep++) {
+        const bool is_left = i_sweep < n;
+        const int t = is_left ? i_sweep : i_sweep - n;
+        const int d = 1 << (perm ? perm[t] : t);
+        /* L sweep writes stage t, R sweep writes stage t+1 */
+        const uint8_t *out = is_left ? state[t] : state[t + 1];
+
+        s->seg_start[i_sweep] = num_seg;
+        for (int base = 0; base < N; base += 2 * d) {
+            for (int j = base; j < base + d; j++) {
+                const uint8_t top = is_left ? out[j] != BP_NODE_FROZEN
+                                            : out[j] == BP_NODE_MIXED;
+                const uint8_t bot = is_left ? out[j + d] != BP_NODE_FROZEN
+                                            : out[j + d] == BP_NODE_MIXED;
+                s->edges_kept += top + bot;
+                if (!top && !bot) continue;
+
+                /* Extend the previous run if it ends right before j */
+                if (num_seg > s->seg_start[i_sweep]) {
+                    BpSegment *last = &s->seg[num_seg - 1];
+                    if (last->j + last->len == j && last->top == top
+                        && last->bot == bot) {
+                        last->len++;
+                        continue;
+                    }
+                }
+                s->seg[num_seg++]
+                    = (BpSegment){.j = j, .len = 1, .top = top, .bot = bot};
+            }
+        }
+    }
+    s->seg_start[2 * n] = num_seg;
+
+    return 0;
+}
+
+void bp_free_schedule(BpSchedule *s) {
+    free(s->state);
+    free(s->seg);
+    s->state = NULL;
+    s->seg = NULL;
+}
+
+/* One round trip over every butterfly of the graph */
+static void bp_sweep_dense(const int N, const int n, int16_t L[][N],
+                           int16_t R[][N], const int *dist,
+                           const MinSumVariant variant, const int param) {
+    for (int t = n - 1; t >= 0; t--) {
+        const int d = dist[t];
+        for (int base = 0; base < N; base += 2 * d) {
+            bp_segment_left(
+                L[t], L[t + 1], R[t], base, d, d, true, true, variant, param);
+        }
+    }
+    for (int t = 0; t < n; t++) {
+        const int d = dist[t];
+        for (int base = 0; base < N; base += 2 * d) {
+            bp_segment_right(R[t + 1],
+                             R[t],
+                             L[t + 1],
+                             base,
+                             d,
+                             d,
+                             true,
+                             true,
+                             variant,
+                             param);
+        }
+    }
+}
+
+/* One round trip over the segments of a pruned schedule */
+static void bp_sweep_pruned(const BpSchedule *sched, int16_t L[][sched->N],
+                            int16_t R[][sched->N], const int *dist,
+                            const MinSumVariant variant, const int param) {
+    const int n = sched->n;
+
+    for (int t = n - 1; t >= 0; t--) {
+        for (int i = sched->seg_start[t]; i < sched->seg_start[t + 1]; i++) {
+            const BpSegment *sg = &sched->seg[i];
+            bp_segment_left(L[t],
+                            L[t + 1],
+                            R[t],
+                            sg->j,
+                            sg->len,
+                            dist[t],
+                            sg->top,
+                            sg->bot,
+                            variant,
+                            param);
+        }
+    }
+    for (int t = 0; t < n; t++) {
+        const int *start = &sched->seg_start[n + t];
+        for (int i = start[0]; i < start[1]; i++) {
+            const BpSegment *sg = &sched->seg[i];
+            bp_segment_right(R[t + 1],
+                             R[t],
+                             L[t + 1],
+                             sg->j,
+                             sg->len,
+                             dist[t],
+                             sg->top,
+                             sg->bot,
+                             variant,
+                             param);
+        }
+    }
+}
+
+/* Belief propagation decoder on the N x (n+1) polar factor graph.
+ * Stage 0 is the u side, stage n the channel side and stage t -> t+1 is the
+ * butterfly of encode() with distance 2^perm[t]. The butterflies of different
+ * distances commute, so every stage order describes the same code.
+ * L messages travel towards u, R messages towards x; one iteration is a full
+ * round trip (L sweep from stage n-1 down to 0 followed by an R sweep from 0
+ * up to n-1). With winner != NULL the decoder is one member of an ensemble:
+ * it gives up as soon as another member has won and claims the win with id
+ * when its own stopping rule is met.
+ * Returns the number of iterations run. */
+static int bp_run(const BpParams *p, const int16_t *LLR_Q, int *msg_cap,
+                  atomic_int *winner, const int id) {
+    const int N = p->N;
+    const int n = p->n;
+
+    /* Butterfly distance of every stage */
+    int dist[BP_MAX_STAGES];
+    for (int t = 0; t < n; t++) {
+        dist[t] = 1 << (p->perm ? p->perm[t] : t);
+    }
+
+    /* Leftward and rightward messages of every stage */
+    int16_t L[n + 1][N];
+    int16_t R[n + 1][N];
+
+    memset(L, 0, sizeof(L));
+    memset(R, 0, sizeof(R));
+    memcpy(L[n], LLR_Q, sizeof(int16_t) * (size_t)N);
+
+    /* Frozen bits are known zeros */
+    for (int i_N = 0; i_N < N; i_N++) {
+        R[0][i_N] = p->info_nodes[i_N] ? 0 : BP_LLR_INF;
+    }
+    /* A pruned schedule never updates the constant nodes */
+    const BpSchedule *sched = p->sched;
+    if (sched) {
+        for (int t = 1; t <= n; t++) {
+            const uint8_t *state = &sched->state[t * N];
+            for (int i_N = 0; i_N < N; i_N++) {
+                R[t][i_N] = state[i_N] == BP_NODE_FROZEN ? BP_LLR_INF : 0;
+            }
+        }
+    }
+
+    int u_hat[N];
+    int prev_msg[p->K];
+    int iter = 0;
+
+    while (iter < p->max_iter) {
+        if (winner && atomic_load_explicit(winner, memory_order_relaxed) >= 0) {
+            break;
+        }
+        iter++;
+
+        if (sched) {
+            bp_sweep_pruned(sched, L, R, dist, p->variant, p->param);
+        } else {
+            bp_sweep_dense(N, n, L, R, dist, p->variant, p->param);
+        }
+
+        for (int i_N = 0; i_N < N; i_N++) {
+            u_hat[i_N] = L[0][i_N] + R[0][i_N] < 0;
+        }
+        for (int i_m = 0; i_m < p->K; i_m++) {
+            msg_cap[i_m] = u_hat[p->data_pos[i_m]];
+        }
+
+        bool is_done = false;
+        if (p->stop == BP_STOP_G_MATRIX) {
+            /* x_hat must be the encoding of u_hat */
+            encode(u_hat, N);
+
+            is_done = true;
+            for (int i_N = 0; i_N < N && is_done; i_N++) {
+                is_done = u_hat[i_N] == (L[n][i_N] + R[n][i_N] < 0);
+            }
+        } else if (p->stop == BP_STOP_CRC) {
+            /* A short CRC checked every iteration lets wrong intermediate
+             * decisions through, so the decision must also be stable */
+            bool is_stable = iter > 1;
+            for (int i_m = 0; i_m < p->K && is_stable; i_m++) {
+                is_stable = msg_cap[i_m] == prev_msg[i_m];
+            }
+            memcpy(prev_msg, msg_cap, sizeof(int) * (size_t)p->K);
+
+            int crc_check[1];
+            crcDet(msg_cap, p->K, 1, p->polynomial, p->crc_l, crc_check);
+            is_done = is_stable && crc_check[0] == 0;
+        }
+
+        if (is_done) {
+            if (winner) {
+                int expected = -1;
+                atomic_compare_exchange_strong(winner, &expected, id);
+            }
+            break;
+        }
+    }
+
+    return iter;
+}
+
+int bp_decode(const BpParams *p, const int16_t *LLR_Q, int *msg_cap) {
+    return bp_run(p, LLR_Q, msg_cap, NULL, 0);
+}
+
+/* Random stage order for a permuted factor graph. As in polar2bipartite.m the
+ * outermost stages stay in place; stages 1 ... n-2 are mixed by num_swaps
+ * random adjacent transpositions. Uniformly shuffled stage orders are valid
+ * too, but far from the natural order a single graph loses most of its
+ * BLER performance, which no practical ensemble size makes up for. */
+void bp_random_stage_perm(int *perm, const int n, const int num_swaps) {
+    for (int t = 0; t < n; t++) {
+        perm[t] = t;
+    }
+    if (n < 4) return;
+
+    for (int i_s = 0; i_s < num_swaps; i_s++) {
+        const int t = 1 + rand() % (n - 3);  // NOLINT(*-msc50-cpp)
+        const int tmp = perm[t];
+        perm[t] = perm[t + 1];
+        perm[t + 1] = tmp;
+    }
+}
+
+/* Member id of the frame the ensemble holds */
+static void bp_ensemble_member(BpEnsemble *e, const int id) {
+    BpParams p = *e->p;
+    p.perm = &e->perms[id * p.n];
+    p.sched = e->scheds ? &e->scheds[id] : NULL;
+    e->iter[id] = bp_run(&p, e->LLR_Q, &e->msg_all[id * p.K], &e->winner, id);
+}
+
+static void *bp_ensemble_thread(void *arg) {
+    BpEnsembleThread *t = arg;
+    BpEnsemble *e = t->e;
+
+    pthread_mutex_lock(&e->lock);
+    unsigned long seen = e->frame;
+    for (;;) {
+        while (e->frame == seen && !e->stop) {
+            pthread_cond_wait(&e->start, &e->lock);
+        }
+        if (e->stop) break;
+        seen = e->frame;
+        pthread_mutex_unlock(&e->lock);
+
+        bp_ensemble_member(e, t->id);
+
+        pthread_mutex_lock(&e->lock);
+        if (--e->pending == 0) pthread_cond_signal(&e->done);
+    }
+    pthread_mutex_unlock(&e->lock);
+    return NULL;
+}
+
+/* Stops and joins the first num_threads workers */
+static void bp_ensemble_stop(BpEnsemble *e, const int num_threads) {
+    pthread_mutex_lock(&e->lock);
+    e->stop = true;
+    pthread_cond_broadcast(&e->start);
+    pthread_mutex_unlock(&e->lock);
+    for (int m = 1; m <= num_threads; m++) {
+        pthread_join(e->threads[m].thread, NULL);
+    }
+}
+
+/* Starts the M - 1 workers of an ensemble of M graphs, which wait for the
+ * frames of bp_ensemble_decode(). Returns 0, or -1 if a worker could not be
+ * started. */
+int bp_ensemble_init(BpEnsemble *e, const int M) {
+    memset(e, 0, sizeof(*e));
+    if (M < 1 || M > BP_MAX_GRAPHS) return -1;
+    e->M = M;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->start, NULL);
+    pthread_cond_init(&e->done, NULL);
+
+    /* Graph 0 runs on the decoding thread */
+    for (int m = 1; m < M; m++) {
+        e->threads[m] = (BpEnsembleThread){.e = e, .id = m};
+        if (pthread_create(
+                &e->threads[m].thread, NULL, bp_ensemble_thread, &e->threads[m])
+            != 0) {
+            bp_ensemble_stop(e, m - 1);
+            pthread_mutex_destroy(&e->lock);
+            pthread_cond_destroy(&e->start);
+            pthread_cond_destroy(&e->done);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void bp_ensemble_free(BpEnsemble *e) {
+    bp_ensemble_stop(e, e->M - 1);
+    pthread_mutex_destroy(&e->lock);
+    pthread_cond_destroy(&e->start);
+    pthread_cond_destroy(&e->done);
+}
+
+/* Ensemble (multi-trellis) BP: the M decoders of e on the permuted factor
+ * graphs perms[m * n ... m * n + n - 1] run in parallel and the first one to
+ * meet the stopping rule of p (normally BP_STOP_CRC) ends the decoding.
+ * scheds holds the pruned schedule of every graph, or is NULL.
+ * Returns the index of that graph, or -1 if no graph succeeded, in which case
+ * msg_cap is the output of graph 0. iter receives the iterations of the
+ * returned graph. */
+int bp_ensemble_decode(BpEnsemble *e, const BpParams *p, const int *perms,
+                       const BpSchedule *scheds, const int16_t *LLR_Q,
+                       int *msg_cap, int *iter) {
+    int msg_all[e->M * p->K];
+
+    pthread_mutex_lock(&e->lock);
+    e->p = p;
+    e->perms = perms;
+    e->scheds = scheds;
+    e->LLR_Q = LLR_Q;
+    e->msg_all = msg_all;
+    atomic_store(&e->winner, -1);
+    e->pending = e->M - 1;
+    e->frame++;
+    pthread_cond_broadcast(&e->start);
+    pthread_mutex_unlock(&e->lock);
+
+    bp_ensemble_member(e, 0);
+
+    pthread_mutex_lock(&e->lock);
+    while (e->pending > 0) {
+        pthread_cond_wait(&e->done, &e->lock);
+    }
+    pthread_mutex_unlock(&e->lock);
+
+    const int win = atomic_load(&e->winner);
+    const int out = win >= 0 ? win : 0;
+    memcpy(msg_cap, &msg_all[out * p->K], sizeof(int) * (size_t)p->K);
+    *iter = e->iter[out];
+
+    return win;
+}
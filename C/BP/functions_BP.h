@@ -0,0 +1,131 @@
+#ifndef FUNCTIONS_BP_
+#define FUNCTIONS_BP_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "min_sum.h"
+
+/* Largest supported code: N = 2^BP_MAX_STAGES */
+#define BP_MAX_STAGES (12)
+/* Prior of a frozen bit on the u side of the factor graph */
+#define BP_LLR_INF    (MINSUM_I16_MAX)
+/* Largest number of permuted factor graphs decoded in parallel */
+#define BP_MAX_GRAPHS (16)
+
+typedef enum {
+    BP_STOP_NONE = 0, /* always run max_iter iterations */
+    BP_STOP_G_MATRIX, /* stop when encode(u_hat) equals x_hat */
+    BP_STOP_CRC       /* stop when a stable decision passes the CRC */
+} BpStopRule;
+
+/* Constant-ness of the R message of a factor graph node */
+typedef enum {
+    BP_NODE_MIXED = 0, /* carries information, computed every iteration */
+    BP_NODE_FREE,      /* only information bits below: R is always 0 */
+    BP_NODE_FROZEN     /* only frozen bits below: known zero, R is +inf */
+} BpNodeState;
+
+/* Run of len butterflies j ... j+len-1 of one stage (all inside one group of
+ * 2d nodes) whose top and/or bottom output message is computed */
+typedef struct BpSegment {
+    int j;
+    int len;
+    uint8_t top;
+    uint8_t bot;
+} BpSegment;
+
+/* Pruned edge schedule of one frozen set and stage order. Segments of the
+ * L sweep of stage t are seg[seg_start[t] ... seg_start[t+1]-1], those of the
+ * R sweep follow at seg_start[n + t]. */
+typedef struct BpSchedule {
+    int N;
+    int n;
+    uint8_t *state; /* (n+1) x N BpNodeState of every node */
+    BpSegment *seg;
+    int seg_start[2 * BP_MAX_STAGES + 1];
+    int edges_total; /* messages of one dense iteration, 2 n N */
+    int edges_kept;  /* messages of one pruned iteration */
+} BpSchedule;
+
+/* Code and decoder configuration of the polar BP decoder */
+typedef struct BpParams {
+    int N;                 /* code length */
+    int n;                 /* number of stages, N = 2^n */
+    int K;                 /* information bits (CRC included) */
+    const int *info_nodes; /* 1 for information positions of u */
+    const int *data_pos;   /* the K information positions */
+    int max_iter;
+    BpStopRule stop;
+    const int *polynomial; /* CRC polynomial for BP_STOP_CRC */
+    int crc_l;             /* CRC length for BP_STOP_CRC */
+    MinSumVariant variant; /* processing element correction */
+    int param;
+    const int *perm; /* stage order, layer t has distance 2^perm[t] (NULL for
+                        the natural order 0, 1, ..., n-1) */
+    const BpSchedule *sched; /* pruned schedule of info_nodes and perm (NULL
+                                to update every message) */
+} BpParams;
+
+typedef struct BpEnsemble BpEnsemble;
+
+/* Worker thread of an ensemble, decoding graph id */
+typedef struct BpEnsembleThread {
+    pthread_t thread;
+    BpEnsemble *e;
+    int id;
+} BpEnsembleThread;
+
+/* Ensemble of M permuted factor graphs: graph 0 is decoded by the caller of
+ * bp_ensemble_decode(), graphs 1 ... M-1 by workers started once by
+ * bp_ensemble_init(), which wait for the next frame between decodings. */
+struct BpEnsemble {
+    int M;
+    BpEnsembleThread threads[BP_MAX_GRAPHS]; /* 1 ... M-1 */
+    pthread_mutex_t lock;
+    pthread_cond_t start; /* a new frame, or stop */
+    pthread_cond_t done;  /* the last worker finished the frame */
+    unsigned long frame;  /* frames handed out so far */
+    int pending;          /* workers still decoding the frame */
+    bool stop;
+    /* The frame, valid while it is decoded */
+    const BpParams *p;
+    const int *perms;
+    const BpSchedule *scheds;
+    const int16_t *LLR_Q;
+    int *msg_all; /* M x K decisions */
+    int iter[BP_MAX_GRAPHS];
+    atomic_int winner;
+};
+
+int uni();
+
+float randn(float mu, float sigma);
+
+void encode(int *u, int N);
+
+void crcGen(int *msg, int K, const int *polynomial, int m);
+
+void crcDet(const int *msg_cap, int K, int l, const int *polynomial, int m,
+            int *crc_check);
+
+int bp_build_schedule(BpSchedule *s, const int *info_nodes, int N, int n,
+                      const int *perm);
+
+void bp_free_schedule(BpSchedule *s);
+
+int bp_decode(const BpParams *p, const int16_t *LLR_Q, int *msg_cap);
+
+void bp_random_stage_perm(int *perm, int n, int num_swaps);
+
+int bp_ensemble_init(BpEnsemble *e, int M);
+
+void bp_ensemble_free(BpEnsemble *e);
+
+int bp_ensemble_decode(BpEnsemble *e, const BpParams *p, const int *perms,
+                       const BpSchedule *scheds, const int16_t *LLR_Q,
+                       int *msg_cap, int *iter);
+
+#endif
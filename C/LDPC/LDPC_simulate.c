@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <string.h>
+
+#include "functions_LDPC.h"
+#include "latency.h"
+
+/* Simulation Parameters */
+// No. of levels of Noise
+#define NUM_EbN0dB    (6)
+// Number of Simulations per noise level for the QC decoder
+#define NUM_SIM       (2000)
+// Number of those frames also decoded by the dense (mex port) decoder
+#define NUM_SIM_DENSE (100)
+// Largest M x N run through the dense decoder: it keeps three M x N double
+// arrays besides H, so the 5G NR base graphs at large Z are skipped
+#define MAX_MN_DENSE  (1 << 21)
+// Maximum number of decoding iterations
+#define MAX_ITER      (20)
+// Offset of the offset min-sum check node update
+#define OFFSET        (0.5f)
+// Fixed-point LLR = round(LLR * LLR_SCALE), channel LLRs use 6 bits
+#define LLR_SCALE     (4.0f)
+#define MAXQR_CH      (31)
+// Offset (in LSBs) and scale (in 1/8) of the fixed-point check node updates
+#define OFFSET_Q      (2)
+#define ALPHA_Q       (6)
+
+/* Decoders compared by this simulation */
+enum {
+    DEC_FLOAT_OMS,
+    DEC_I16_OMS,
+    DEC_I8_OMS,
+    DEC_I8_NMS,
+    DEC_DENSE_TANH,
+    NUM_DECODERS
+};
+
+static const char *decoder_names[NUM_DECODERS] = {"float offset min-sum",
+                                                  "int16 offset min-sum",
+                                                  "int8 offset min-sum",
+                                                  "int8 normalized min-sum",
+                                                  "double tanh (mex port)"};
+
+/* Usage: hello [base_graph_file Z]
+ * Without arguments the rate 1/2 base matrix of MPA_Protograph_5G.m (Z = 81)
+ * is used, otherwise a 5G NR base graph (BG1/BG2) is loaded from file. */
+int main(int argc, char **argv) {
+    srand((unsigned)time(NULL));
+
+    QcBaseGraph bg;
+    if (argc > 2) {
+        if (qc_load_nr_base_graph(&bg, argv[1], atoi(argv[2])) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (qc_init_base_graph(&bg, 12, 24, 81, BASE_MATRIX_R12) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    /* Code Parameters */
+    const int N = bg.cols * bg.Z;
+    const int M = bg.rows * bg.Z;
+    const int K = N - M;
+    const float rate = (float)K / (float)N;
+
+    printf("QC-LDPC N = %d K = %d Z = %d, %d circulants\n",
+           N,
+           K,
+           bg.Z,
+           bg.num_blocks);
+
+    /* Expanded parity check matrix for the dense decoder, if it fits */
+    const int run_dense = (long long)M * N <= MAX_MN_DENSE;
+    uint8_t *H = NULL;
+    if (run_dense) {
+        H = malloc((size_t)M * (size_t)N);
+        if (!H) return EXIT_FAILURE;
+        qc_expand(&bg, H);
+    } else {
+        printf("%s skipped: M x N = %lld > %d\n",
+               decoder_names[DEC_DENSE_TANH],
+               (long long)M * N,
+               MAX_MN_DENSE);
+    }
+
+    /* Eb/N0 in dB */
+    float EbN0dB[NUM_EbN0dB];
+    for (unsigned i_e = 0; i_e < NUM_EbN0dB; i_e++) {
+        EbN0dB[i_e] = 1.0f + 0.5f * (float)i_e;
+    }
+
+    float time_used[NUM_DECODERS] = {0};
+    int frames_decoded[NUM_DECODERS] = {0};
+
+    /* Wall-clock decode latency per decoder, per Eb/N0 point and overall */
+    static LatHist lat[NUM_DECODERS], lat_all[NUM_DECODERS];
+    for (int i_dec = 0; i_dec < NUM_DECODERS; i_dec++) {
+        lat_reset(&lat_all[i_dec]);
+    }
+
+    for (unsigned i_sig = 0; i_sig < NUM_EbN0dB; i_sig++) {
+        const float sigma
+            = sqrtf(1.0f / (2.0f * rate) * powf(10.0f, -EbN0dB[i_sig] / 10.0f));
+
+        int err_count[NUM_DECODERS] = {0};
+        int frame_err[NUM_DECODERS] = {0};
+        int iter_count[NUM_DECODERS] = {0};
+        for (int i_dec = 0; i_dec < NUM_DECODERS; i_dec++) {
+            lat_reset(&lat[i_dec]);
+        }
+
+        for (unsigned i_num_sim = 0; i_num_sim < NUM_SIM; i_num_sim++) {
+            /* All-zero codeword, BPSK and AWGN */
+            float LLR[N];
+            for (int i_ch = 0; i_ch < N; i_ch++) {
+                const float y = 1.0f + randn(0, sigma);
+                LLR[i_ch] = 2.0f * y / (sigma * sigma);
+            }
+
+            /* Channel LLR Quantization */
+            int16_t LLR_Q16[N];
+            int8_t LLR_Q8[N];
+            quantize_i16(LLR, LLR_Q16, N, LLR_SCALE, MAXQR_CH);
+            quantize_i8(LLR, LLR_Q8, N, LLR_SCALE, MAXQR_CH);
+
+            for (int i_dec = 0; i_dec < NUM_DECODERS; i_dec++) {
+                if (i_dec == DEC_DENSE_TANH
+                    && (!run_dense || i_num_sim >= NUM_SIM_DENSE)) {
+                    continue;
+                }
+
+                uint8_t c_hat[N];
+                int iter = 0;
+
+                const clock_t dec_start = clock();
+                const uint64_t lat_start = lat_now_ns();
+                switch (i_dec) {
+                case DEC_FLOAT_OMS:
+                    iter = qc_decode(&bg, LLR, c_hat, MAX_ITER, OFFSET);
+                    break;
+                case DEC_I16_OMS:
+                    iter = qc_decode_i16(
+                        &bg, LLR_Q16, c_hat, MAX_ITER, MINSUM_OFFSET, OFFSET_Q);
+                    break;
+                case DEC_I8_OMS:
+                    iter = qc_decode_i8(
+                        &bg, LLR_Q8, c_hat, MAX_ITER, MINSUM_OFFSET, OFFSET_Q);
+                    break;
+                case DEC_I8_NMS:
+                    iter = qc_decode_i8(&bg,
+                                        LLR_Q8,
+                                        c_hat,
+                                        MAX_ITER,
+                                        MINSUM_NORMALIZED,
+                                        ALPHA_Q);
+                    break;
+                default:
+                    iter = ldpc_decode_dense(H, M, N, LLR, c_hat, MAX_ITER);
+                    break;
+                }
+                lat_record(&lat[i_dec], lat_now_ns() - lat_start);
+                time_used[i_dec] += (float)(clock() - dec_start);
+                frames_decoded[i_dec]++;
+
+                int cur_err = 0;
+                for (int i_err = 0; i_err < N; i_err++) {
+                    cur_err += c_hat[i_err];
+                }
+                err_count[i_dec] += cur_err;
+                frame_err[i_dec] += cur_err > 0;
+                iter_count[i_dec] += iter;
+            }
+        }  // end of no. of simulations loop
+
+        printf("EbN0dB %0.2f\n", EbN0dB[i_sig]);
+        for (int i_dec = 0; i_dec < NUM_DECODERS; i_dec++) {
+            if (i_dec == DEC_DENSE_TANH && !run_dense) continue;
+            const double num_frames
+                = i_dec == DEC_DENSE_TANH ? NUM_SIM_DENSE : NUM_SIM;
+            printf("  %-24s BER %lf\tBLER %lf\titer %0.2f\n",
+                   decoder_names[i_dec],
+                   (double)err_count[i_dec] / ((double)N * num_frames),
+                   (double)frame_err[i_dec] / num_frames,
+                   (double)iter_count[i_dec] / num_frames);
+            lat_print(stdout, decoder_names[i_dec], &lat[i_dec]);
+            lat_merge(&lat_all[i_dec], &lat[i_dec]);
+        }
+    }  // end of noise var loop
+
+    for (int i_dec = 0; i_dec < NUM_DECODERS; i_dec++) {
+        if (i_dec == DEC_DENSE_TANH && !run_dense) continue;
+        printf("%-24s throughput is %.4f Mbps\n",
+               decoder_names[i_dec],
+               (float)K * (float)frames_decoded[i_dec]
+                   / (time_used[i_dec] / CLOCKS_PER_SEC * 1e6f));
+        lat_print(stdout, decoder_names[i_dec], &lat_all[i_dec]);
+    }
+
+    free(H);
+    qc_free_base_graph(&bg);
+
+    return 0;
+}
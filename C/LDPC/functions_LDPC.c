@@ -0,0 +1,632 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "functions_LDPC.h"
+
+#pragma GCC optimize("Ofast")
+
+#define MIN(x, y) ((x < y) ? x : y)
+#define MAX(x, y) ((x < y) ? y : x)
+
+/* Base matrices of base_matrix.m, used by MPA_Protograph_5G.m with Z = 81 */
+const int BASE_MATRIX_R12[12 * 24] = {
+    57, -1, -1, -1, 50, -1, 11, -1, 50, -1, 79, -1, 1,  0,  -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, 3,  -1, 28, -1, 0,  -1, -1, -1, 55, 7,  -1, -1,
+    -1, 0,  0,  -1, -1, -1, -1, -1, -1, -1, -1, -1, 30, -1, -1, -1, 24, 37,
+    -1, -1, 56, 14, -1, -1, -1, -1, 0,  0,  -1, -1, -1, -1, -1, -1, -1, -1,
+    62, 53, -1, -1, 53, -1, -1, 3,  35, -1, -1, -1, -1, -1, -1, 0,  0,  -1,
+    -1, -1, -1, -1, -1, -1, 40, -1, -1, 20, 66, -1, -1, 22, 28, -1, -1, -1,
+    -1, -1, -1, -1, 0,  0,  -1, -1, -1, -1, -1, -1, 0,  -1, -1, -1, 8,  -1,
+    42, -1, 50, -1, -1, 8,  -1, -1, -1, -1, -1, 0,  0,  -1, -1, -1, -1, -1,
+    69, 79, 79, -1, -1, -1, 56, -1, 52, -1, -1, -1, 0,  -1, -1, -1, -1, -1,
+    0,  0,  -1, -1, -1, -1, 65, -1, -1, -1, 38, 57, -1, -1, 72, -1, 27, -1,
+    -1, -1, -1, -1, -1, -1, -1, 0,  0,  -1, -1, -1, 64, -1, -1, -1, 14, 52,
+    -1, -1, 30, -1, -1, 32, -1, -1, -1, -1, -1, -1, -1, -1, 0,  0,  -1, -1,
+    -1, 45, -1, 70, 0,  -1, -1, -1, 77, 9,  -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, 0,  0,  -1, 2,  56, -1, 57, 35, -1, -1, -1, -1, -1, 12, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0,  0,  24, -1, 61, -1, 60, -1,
+    -1, 27, 51, -1, -1, 16, 1,  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0};
+
+const int BASE_MATRIX_R23[8 * 24] = {
+    61, 75, 4,  63, 56, -1, -1, -1, -1, -1, -1, 8,  -1, 2,  17, 25, 1,  0,
+    -1, -1, -1, -1, -1, -1, 56, 74, 77, 20, -1, -1, -1, 64, 24, 4,  67, -1,
+    7,  -1, -1, -1, -1, 0,  0,  -1, -1, -1, -1, -1, 28, 21, 68, 10, 7,  14,
+    65, -1, -1, -1, 23, -1, -1, -1, 75, -1, -1, -1, 0,  0,  -1, -1, -1, -1,
+    48, 38, 43, 78, 76, -1, -1, -1, -1, 5,  36, -1, 15, 72, -1, -1, -1, -1,
+    -1, 0,  0,  -1, -1, -1, 40, 2,  53, 25, -1, 52, 62, -1, 20, -1, -1, 44,
+    -1, -1, -1, -1, 0,  -1, -1, -1, 0,  0,  -1, -1, 69, 23, 64, 10, 22, -1,
+    21, -1, -1, -1, -1, -1, 68, 23, 29, -1, -1, -1, -1, -1, -1, 0,  0,  -1,
+    12, 0,  68, 20, 55, 61, -1, 40, -1, -1, -1, 52, -1, -1, -1, 44, -1, -1,
+    -1, -1, -1, -1, 0,  0,  58, 8,  34, 64, 78, -1, -1, 11, 78, 24, -1, -1,
+    -1, -1, -1, 58, 1,  -1, -1, -1, -1, -1, -1, 0};
+
+const int BASE_MATRIX_R34[6 * 24] = {
+    48, 29, 28, 39, 9,  61, -1, -1, -1, 63, 45, 80, -1, -1, -1, 37, 32, 22,
+    1,  0,  -1, -1, -1, -1, 4,  49, 42, 48, 11, 30, -1, -1, -1, 49, 17, 41,
+    37, 15, -1, 54, -1, -1, -1, 0,  0,  -1, -1, -1, 35, 76, 78, 51, 37, 35,
+    21, -1, 17, 64, -1, -1, -1, 59, 7,  -1, -1, 32, -1, -1, 0,  0,  -1, -1,
+    9,  65, 44, 9,  54, 56, 73, 34, 42, -1, -1, -1, 35, -1, -1, -1, 46, 39,
+    0,  -1, -1, 0,  0,  -1, 3,  62, 7,  80, 68, 26, -1, 80, 55, -1, 36, -1,
+    26, -1, 9,  -1, 72, -1, -1, -1, -1, -1, 0,  0,  26, 75, 33, 21, 69, 59,
+    3,  38, -1, -1, -1, 35, -1, 62, 36, 26, -1, -1, 1,  -1, -1, -1, -1, 0};
+
+const int BASE_MATRIX_R56[4 * 24] = {
+    13, 48, 80, 66, 4,  74, 7,  30, 76, 52, 37, 60, -1, 49, 73, 31, 74, 73,
+    23, -1, 1,  0,  -1, -1, 69, 63, 74, 56, 64, 77, 57, 65, 6,  16, 51, -1,
+    64, -1, 68, 9,  48, 62, 54, 27, -1, 0,  0,  -1, 51, 15, 0,  80, 24, 25,
+    42, 54, 44, 71, 71, 9,  67, 35, -1, 58, -1, 29, -1, 53, 0,  -1, 0,  0,
+    16, 29, 36, 41, 44, 56, 59, 37, 50, 24, -1, 65, 4,  65, 52, -1, 4,  -1,
+    73, 52, 1,  -1, -1, 0};
+
+/*Gaussian random number generator*/
+// Box muller method, see
+// https://mathworld.wolfram.com/Box-MullerTransformation.html
+float randn(const float mean, const float std) {
+    float U1, U2, W;
+    static float X1, X2;
+    static bool call = false;
+
+    if (call) {
+        call = !call;
+        return mean + std * X2;
+    }
+
+    do {
+        U1 = -1 + (float)rand() / (float)(RAND_MAX) * 2;  // NOLINT(*-msc50-cpp)
+        U2 = -1 + (float)rand() / (float)(RAND_MAX) * 2;  // NOLINT(*-msc50-cpp)
+        W = U1 * U1 + U2 * U2;
+    } while (W >= 1 || W <= 0);
+
+    const float normalize_coefficient = sqrtf(-2.0f * logf(W) / W);
+    X1 = U1 * normalize_coefficient;
+    X2 = U2 * normalize_coefficient;
+
+    call = !call;
+
+    return mean + std * X1;
+}
+
+/* Build the base graph and its per-layer circulant list from a shift table */
+int qc_init_base_graph(QcBaseGraph *bg, const int rows, const int cols,
+                       const int Z, const int *table) {
+    memset(bg, 0, sizeof(*bg));
+    if (rows <= 0 || cols <= rows || Z <= 0 || Z > QC_MAX_Z) return -1;
+
+    bg->rows = rows;
+    bg->cols = cols;
+    bg->Z = Z;
+    bg->shift = malloc(sizeof(int) * (size_t)(rows * cols));
+    bg->row_start = malloc(sizeof(int) * (size_t)(rows + 1));
+    if (!bg->shift || !bg->row_start) {
+        qc_free_base_graph(bg);
+        return -1;
+    }
+
+    for (int i_b = 0; i_b < rows * cols; i_b++) {
+        bg->shift[i_b] = table[i_b] < 0 ? -1 : table[i_b] % Z;
+        bg->num_blocks += table[i_b] >= 0;
+    }
+
+    bg->blk_col = malloc(sizeof(int) * (size_t)bg->num_blocks);
+    bg->blk_shift = malloc(sizeof(int) * (size_t)bg->num_blocks);
+    if (!bg->blk_col || !bg->blk_shift) {
+        qc_free_base_graph(bg);
+        return -1;
+    }
+
+    int i_blk = 0;
+    for (int i_r = 0; i_r < rows; i_r++) {
+        bg->row_start[i_r] = i_blk;
+        for (int i_c = 0; i_c < cols; i_c++) {
+            if (bg->shift[i_r * cols + i_c] >= 0) {
+                bg->blk_col[i_blk] = i_c;
+                bg->blk_shift[i_blk] = bg->shift[i_r * cols + i_c];
+                i_blk++;
+            }
+        }
+        bg->max_row_deg = MAX(bg->max_row_deg, i_blk - bg->row_start[i_r]);
+    }
+    bg->row_start[rows] = i_blk;
+
+    return 0;
+}
+
+/* Set index i_LS of TS 38.212 Table 5.3.2-1, Z = a * 2^j */
+int qc_lifting_set(int Z) {
+    /* odd part of a for each set, a = 2 has odd part 1 */
+    static const int a_odd[QC_NUM_LIFT_SETS] = {1, 3, 5, 7, 9, 11, 13, 15};
+
+    if (Z < 2 || Z > QC_MAX_Z) return -1;
+    while (Z % 2 == 0) {
+        Z /= 2;
+    }
+    for (int i_ls = 0; i_ls < QC_NUM_LIFT_SETS; i_ls++) {
+        if (a_odd[i_ls] == Z) return i_ls;
+    }
+    return -1;
+}
+
+/* Base graph loader for the 5G NR base graphs (BG1: 46 x 68, BG2: 42 x 52).
+ * The file holds "rows cols" followed by one line per non-zero entry in the
+ * layout of TS 38.212 Tables 5.3.2-2/3: "i j V0 V1 V2 V3 V4 V5 V6 V7", where
+ * Vk is the shift of lifting set k. Lines starting with '#' are skipped. */
+int qc_load_nr_base_graph(QcBaseGraph *bg, const char *path, const int Z) {
+    memset(bg, 0, sizeof(*bg));
+
+    const int i_ls = qc_lifting_set(Z);
+    if (i_ls < 0) {
+        fprintf(stderr, "Z = %d is not a 5G NR lifting size\n", Z);
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Cannot open base graph %s\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int rows = 0, cols = 0;
+    int *table = NULL;
+    int status = -1;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        if (!table) {
+            if (sscanf(line, "%d %d", &rows, &cols) != 2 || rows <= 0
+                || cols <= rows) {
+                break;
+            }
+            table = malloc(sizeof(int) * (size_t)(rows * cols));
+            if (!table) break;
+            for (int i_b = 0; i_b < rows * cols; i_b++) {
+                table[i_b] = -1;
+            }
+            status = 0;
+            continue;
+        }
+
+        int i, j, V[QC_NUM_LIFT_SETS];
+        if (sscanf(line,
+                   "%d %d %d %d %d %d %d %d %d %d",
+                   &i,
+                   &j,
+                   &V[0],
+                   &V[1],
+                   &V[2],
+                   &V[3],
+                   &V[4],
+                   &V[5],
+                   &V[6],
+                   &V[7])
+                != 2 + QC_NUM_LIFT_SETS
+            || i < 0 || i >= rows || j < 0 || j >= cols || V[i_ls] < 0) {
+            status = -1;
+            break;
+        }
+        table[i * cols + j] = V[i_ls];
+    }
+    fclose(fp);
+
+    if (status == 0) {
+        status = qc_init_base_graph(bg, rows, cols, Z, table);
+    } else {
+        fprintf(stderr, "Malformed base graph %s\n", path);
+    }
+    free(table);
+
+    return status;
+}
+
+void qc_free_base_graph(QcBaseGraph *bg) {
+    free(bg->shift);
+    free(bg->row_start);
+    free(bg->blk_col);
+    free(bg->blk_shift);
+    memset(bg, 0, sizeof(*bg));
+}
+
+/* Dense expansion of the base graph, H is (rows*Z) x (cols*Z) row major */
+void qc_expand(const QcBaseGraph *bg, uint8_t *H) {
+    const int Z = bg->Z;
+    const int N = bg->cols * Z;
+
+    memset(H, 0, (size_t)(bg->rows * Z) * (size_t)N);
+    for (int i_r = 0; i_r < bg->rows; i_r++) {
+        for (int i_e = bg->row_start[i_r]; i_e < bg->row_start[i_r + 1];
+             i_e++) {
+            for (int z = 0; z < Z; z++) {
+                H[(i_r * Z + z) * N + bg->blk_col[i_e] * Z
+                  + (z + bg->blk_shift[i_e]) % Z]
+                    = 1;
+            }
+        }
+    }
+}
+
+/* Rotated load of one circulant: dst[z] = src[(z + s) % Z] */
+static inline void rotate_load(float *dst, const float *src, const int s,
+                               const int Z) {
+    for (int z = 0; z < Z - s; z++) {
+        dst[z] = src[z + s];
+    }
+    for (int z = Z - s; z < Z; z++) {
+        dst[z] = src[z + s - Z];
+    }
+}
+
+/* Rotated store of one circulant: dst[(z + s) % Z] = src[z] */
+static inline void rotate_store(float *dst, const float *src, const int s,
+                                const int Z) {
+    for (int z = 0; z < Z - s; z++) {
+        dst[z + s] = src[z];
+    }
+    for (int z = Z - s; z < Z; z++) {
+        dst[z + s - Z] = src[z];
+    }
+}
+
+/* Syndrome check on the base graph, one block row at a time */
+bool qc_syndrome_ok(const QcBaseGraph *bg, const uint8_t *c_hat) {
+    const int Z = bg->Z;
+    uint8_t parity[QC_MAX_Z];
+
+    for (int i_r = 0; i_r < bg->rows; i_r++) {
+        memset(parity, 0, (size_t)Z);
+        for (int i_e = bg->row_start[i_r]; i_e < bg->row_start[i_r + 1];
+             i_e++) {
+            const uint8_t *c_blk = &c_hat[bg->blk_col[i_e] * Z];
+            const int s = bg->blk_shift[i_e];
+            for (int z = 0; z < Z - s; z++) {
+                parity[z] ^= c_blk[z + s];
+            }
+            for (int z = Z - s; z < Z; z++) {
+                parity[z] ^= c_blk[z + s - Z];
+            }
+        }
+        for (int z = 0; z < Z; z++) {
+            if (parity[z]) return false;
+        }
+    }
+    return true;
+}
+
+/* Layered offset min-sum decoder on the quasi-cyclic base graph.
+ * Every circulant is processed as one vector of Z lanes: the APP LLRs of its
+ * block column are loaded rotated by the shift value, so lane z of every
+ * circulant of a block row belongs to check node z of that row.
+ * Returns the number of iterations run. */
+int qc_decode(const QcBaseGraph *bg, const float *LLR, uint8_t *c_hat,
+              const int max_iter, const float offset) {
+    const int Z = bg->Z;
+    const int N = bg->cols * Z;
+
+    /* A posteriori LLRs */
+    float APP[N];
+    memcpy(APP, LLR, sizeof(float) * (size_t)N);
+
+    /* Check to variable messages, Z lanes per circulant */
+    float R[bg->num_blocks * Z];
+    memset(R, 0, sizeof(R));
+
+    /* Variable to check messages of the current layer */
+    float T[bg->max_row_deg * Z];
+
+    float min1[QC_MAX_Z], min2[QC_MAX_Z], sign[QC_MAX_Z];
+    int idx1[QC_MAX_Z];
+
+    int iter = 0;
+    while (iter < max_iter) {
+        iter++;
+
+        for (int i_r = 0; i_r < bg->rows; i_r++) {
+            const int e_start = bg->row_start[i_r];
+            const int deg = bg->row_start[i_r + 1] - e_start;
+
+            for (int z = 0; z < Z; z++) {
+                min1[z] = (float)LDPC_INF;
+                min2[z] = (float)LDPC_INF;
+                sign[z] = 1.0f;
+                idx1[z] = 0;
+            }
+
+            /* Variable to check messages and min1/min2/index/sign */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                float *T_e = &T[i_e * Z];
+                const float *R_e = &R[(e_start + i_e) * Z];
+
+                rotate_load(T_e,
+                            &APP[bg->blk_col[e_start + i_e] * Z],
+                            bg->blk_shift[e_start + i_e],
+                            Z);
+
+                for (int z = 0; z < Z; z++) {
+                    T_e[z] -= R_e[z];
+                    const float mag = fabsf(T_e[z]);
+                    sign[z] *= T_e[z] < 0 ? -1.0f : 1.0f;
+                    min2[z] = mag < min1[z] ? min1[z] : MIN(mag, min2[z]);
+                    idx1[z] = mag < min1[z] ? i_e : idx1[z];
+                    min1[z] = MIN(mag, min1[z]);
+                }
+            }
+
+            for (int z = 0; z < Z; z++) {
+                min1[z] = MAX(min1[z] - offset, 0.0f);
+                min2[z] = MAX(min2[z] - offset, 0.0f);
+            }
+
+            /* Check to variable messages and APP update */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                float *T_e = &T[i_e * Z];
+                float *R_e = &R[(e_start + i_e) * Z];
+
+                for (int z = 0; z < Z; z++) {
+                    const float mag = idx1[z] == i_e ? min2[z] : min1[z];
+                    R_e[z] = (T_e[z] < 0 ? -sign[z] : sign[z]) * mag;
+                    T_e[z] += R_e[z];
+                }
+
+                rotate_store(&APP[bg->blk_col[e_start + i_e] * Z],
+                             T_e,
+                             bg->blk_shift[e_start + i_e],
+                             Z);
+            }
+        }
+
+        for (int i_N = 0; i_N < N; i_N++) {
+            c_hat[i_N] = APP[i_N] < 0;
+        }
+        if (qc_syndrome_ok(bg, c_hat)) break;
+    }
+
+    return iter;
+}
+
+/* Layered min-sum decoder with int16 messages and APP LLRs.
+ * Same schedule as qc_decode(); the check node update of a block row is one
+ * check_node_i16() call over its deg x Z message block. */
+int qc_decode_i16(const QcBaseGraph *bg, const int16_t *LLR_Q, uint8_t *c_hat,
+                  const int max_iter, const MinSumVariant variant,
+                  const int param) {
+    const int Z = bg->Z;
+    const int N = bg->cols * Z;
+
+    int16_t APP[N];
+    memcpy(APP, LLR_Q, sizeof(int16_t) * (size_t)N);
+
+    int16_t R[bg->num_blocks * Z];
+    memset(R, 0, sizeof(R));
+
+    int16_t T[bg->max_row_deg * Z];
+    int16_t blk[QC_MAX_Z];
+
+    int iter = 0;
+    while (iter < max_iter) {
+        iter++;
+
+        for (int i_r = 0; i_r < bg->rows; i_r++) {
+            const int e_start = bg->row_start[i_r];
+            const int deg = bg->row_start[i_r + 1] - e_start;
+            int16_t *R_row = &R[e_start * Z];
+
+            /* Variable to check messages, rotated into check order */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                const int16_t *src = &APP[bg->blk_col[e_start + i_e] * Z];
+                const int s = bg->blk_shift[e_start + i_e];
+                int16_t *T_e = &T[i_e * Z];
+                int16_t *R_e = &R_row[i_e * Z];
+
+                for (int z = 0; z < Z - s; z++) {
+                    T_e[z] = sat_i16(src[z + s] - R_e[z]);
+                }
+                for (int z = Z - s; z < Z; z++) {
+                    T_e[z] = sat_i16(src[z + s - Z] - R_e[z]);
+                }
+                memcpy(R_e, T_e, sizeof(int16_t) * (size_t)Z);
+            }
+
+            check_node_i16(R_row, deg, Z, variant, param);
+
+            /* APP update and rotated store */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                int16_t *dst = &APP[bg->blk_col[e_start + i_e] * Z];
+                const int s = bg->blk_shift[e_start + i_e];
+                const int16_t *T_e = &T[i_e * Z];
+                const int16_t *R_e = &R_row[i_e * Z];
+
+                for (int z = 0; z < Z; z++) {
+                    blk[z] = sat_i16(T_e[z] + R_e[z]);
+                }
+                memcpy(&dst[s], blk, sizeof(int16_t) * (size_t)(Z - s));
+                memcpy(dst, &blk[Z - s], sizeof(int16_t) * (size_t)s);
+            }
+        }
+
+        for (int i_N = 0; i_N < N; i_N++) {
+            c_hat[i_N] = APP[i_N] < 0;
+        }
+        if (qc_syndrome_ok(bg, c_hat)) break;
+    }
+
+    return iter;
+}
+
+/* Layered min-sum decoder with int8 messages and APP LLRs */
+int qc_decode_i8(const QcBaseGraph *bg, const int8_t *LLR_Q, uint8_t *c_hat,
+                 const int max_iter, const MinSumVariant variant,
+                 const int param) {
+    const int Z = bg->Z;
+    const int N = bg->cols * Z;
+
+    int8_t APP[N];
+    memcpy(APP, LLR_Q, sizeof(int8_t) * (size_t)N);
+
+    int8_t R[bg->num_blocks * Z];
+    memset(R, 0, sizeof(R));
+
+    int8_t T[bg->max_row_deg * Z];
+    int8_t blk[QC_MAX_Z];
+
+    int iter = 0;
+    while (iter < max_iter) {
+        iter++;
+
+        for (int i_r = 0; i_r < bg->rows; i_r++) {
+            const int e_start = bg->row_start[i_r];
+            const int deg = bg->row_start[i_r + 1] - e_start;
+            int8_t *R_row = &R[e_start * Z];
+
+            /* Variable to check messages, rotated into check order */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                const int8_t *src = &APP[bg->blk_col[e_start + i_e] * Z];
+                const int s = bg->blk_shift[e_start + i_e];
+                int8_t *T_e = &T[i_e * Z];
+                int8_t *R_e = &R_row[i_e * Z];
+
+                for (int z = 0; z < Z - s; z++) {
+                    T_e[z] = sat_i8(src[z + s] - R_e[z]);
+                }
+                for (int z = Z - s; z < Z; z++) {
+                    T_e[z] = sat_i8(src[z + s - Z] - R_e[z]);
+                }
+                memcpy(R_e, T_e, sizeof(int8_t) * (size_t)Z);
+            }
+
+            check_node_i8(R_row, deg, Z, variant, param);
+
+            /* APP update and rotated store */
+            for (int i_e = 0; i_e < deg; i_e++) {
+                int8_t *dst = &APP[bg->blk_col[e_start + i_e] * Z];
+                const int s = bg->blk_shift[e_start + i_e];
+                const int8_t *T_e = &T[i_e * Z];
+                const int8_t *R_e = &R_row[i_e * Z];
+
+                for (int z = 0; z < Z; z++) {
+                    blk[z] = sat_i8(T_e[z] + R_e[z]);
+                }
+                memcpy(&dst[s], blk, sizeof(int8_t) * (size_t)(Z - s));
+                memcpy(dst, &blk[Z - s], sizeof(int8_t) * (size_t)s);
+            }
+        }
+
+        for (int i_N = 0; i_N < N; i_N++) {
+            c_hat[i_N] = APP[i_N] < 0;
+        }
+        if (qc_syndrome_ok(bg, c_hat)) break;
+    }
+
+    return iter;
+}
+
+/* atanh with the same saturation as decode_ldpc_new.cpp */
+static double atanh_clamped(const double x) {
+    const double epsilon = 1e-16;
+
+    if (x > 1 - epsilon) return LDPC_INF;
+    if (x < -1 + epsilon) return -LDPC_INF;
+    return 0.5 * log((1 + x) / (1 - x));
+}
+
+/* C port of the decode_ldpc_new mex decoder: flooding schedule, tanh rule,
+ * dense M x N message arrays and a dense parity check after every iteration.
+ * LLR > 0 means bit 0. Returns the number of iterations run. */
+int ldpc_decode_dense(const uint8_t *H, const int M, const int N,
+                      const float *LLR, uint8_t *c_hat, const int max_iter) {
+    const size_t MN = (size_t)M * (size_t)N;
+
+    /* Column indices of the ones in each row */
+    int max_check_degree = 0;
+    for (int i_m = 0; i_m < M; i_m++) {
+        int degree = 0;
+        for (int i_n = 0; i_n < N; i_n++) {
+            degree += H[i_m * N + i_n];
+        }
+        max_check_degree = MAX(max_check_degree, degree);
+    }
+
+    int *check_node_ones
+        = malloc(sizeof(int) * (size_t)(M * max_check_degree));
+    int *check_degree = calloc((size_t)M, sizeof(int));
+    double *sg_array = malloc(sizeof(double) * MN);
+    double *sa_array = calloc(MN, sizeof(double));
+    double *bitmessage = malloc(sizeof(double) * MN);
+    double *sum_of_b = malloc(sizeof(double) * (size_t)N);
+    if (!check_node_ones || !check_degree || !sg_array || !sa_array
+        || !bitmessage || !sum_of_b) {
+        fprintf(stderr, "ldpc_decode_dense: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i_m = 0; i_m < M; i_m++) {
+        for (int i_n = 0; i_n < N; i_n++) {
+            if (H[i_m * N + i_n]) {
+                const int j = check_degree[i_m]++;
+                check_node_ones[i_m * max_check_degree + j] = i_n;
+            }
+            sg_array[i_m * N + i_n] = LLR[i_n];
+        }
+    }
+
+    int iteration = 0;
+    while (iteration < max_iter) {
+        iteration++;
+
+        /* bit-to-check messages */
+        for (int i_m = 0; i_m < M; i_m++) {
+            const int *ones = &check_node_ones[i_m * max_check_degree];
+            for (int j = 0; j < check_degree[i_m]; j++) {
+                const size_t e = (size_t)(i_m * N + ones[j]);
+                bitmessage[e] = tanh((sg_array[e] - sa_array[e]) / 2);
+            }
+        }
+
+        /* check-to-bit messages */
+        for (int i_m = 0; i_m < M; i_m++) {
+            const int *ones = &check_node_ones[i_m * max_check_degree];
+            for (int v = 0; v < check_degree[i_m]; v++) {
+                double temp = 1;
+                for (int w = 0; w < check_degree[i_m]; w++) {
+                    if (w != v) temp *= bitmessage[i_m * N + ones[w]];
+                }
+                sa_array[i_m * N + ones[v]] = 2 * atanh_clamped(temp);
+            }
+        }
+
+        /* sum across columns, APP update and hard decision */
+        for (int i_n = 0; i_n < N; i_n++) {
+            sum_of_b[i_n] = 0;
+            for (int i_m = 0; i_m < M; i_m++) {
+                if (H[i_m * N + i_n]) sum_of_b[i_n] += sa_array[i_m * N + i_n];
+            }
+            for (int i_m = 0; i_m < M; i_m++) {
+                if (H[i_m * N + i_n]) {
+                    sg_array[i_m * N + i_n] = sum_of_b[i_n] + LLR[i_n];
+                }
+            }
+            c_hat[i_n] = sum_of_b[i_n] + LLR[i_n] < 0;
+        }
+
+        /* check if valid codeword */
+        int cumsum = 0;
+        for (int i_m = 0; i_m < M && cumsum == 0; i_m++) {
+            int parity = 0;
+            for (int i_n = 0; i_n < N; i_n++) {
+                parity ^= H[i_m * N + i_n] & c_hat[i_n];
+            }
+            cumsum += parity;
+        }
+        if (cumsum == 0) break;
+    }
+
+    free(check_node_ones);
+    free(check_degree);
+    free(sg_array);
+    free(sa_array);
+    free(bitmessage);
+    free(sum_of_b);
+
+    return iteration;
+}
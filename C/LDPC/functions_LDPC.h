@@ -0,0 +1,65 @@
+#ifndef FUNCTIONS_LDPC_
+#define FUNCTIONS_LDPC_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "min_sum.h"
+
+/* Largest 5G NR lifting size */
+#define QC_MAX_Z          (384)
+/* Number of lifting sets in TS 38.212 Table 5.3.2-1 */
+#define QC_NUM_LIFT_SETS  (8)
+/* Maximum value of a check to variable message (same as the mex decoder) */
+#define LDPC_INF          (1000.0)
+
+/* Quasi-cyclic parity check matrix stored as base matrix and shift values.
+ * Block (r, c) with shift s >= 0 is the Z x Z identity cyclically shifted so
+ * that check r*Z + z is connected to variable c*Z + (z + s) % Z, which is the
+ * same expansion as cyclic_shift(s, eye(Z)) in MPA_Protograph_5G.m. */
+typedef struct QcBaseGraph {
+    int rows;        /* block rows (= layers of the layered decoder) */
+    int cols;        /* block columns */
+    int Z;           /* lifting size */
+    int *shift;      /* rows x cols shift table, -1 marks an all-zero block */
+    int num_blocks;  /* number of non-zero circulants */
+    int max_row_deg; /* largest number of circulants in one block row */
+    int *row_start;  /* rows + 1 offsets into blk_col / blk_shift */
+    int *blk_col;    /* block column of each circulant, row major */
+    int *blk_shift;  /* shift value of each circulant, row major */
+} QcBaseGraph;
+
+/* Built-in base matrices of base_matrix.m (Z = 81, 12 x 24 for rate 1/2) */
+extern const int BASE_MATRIX_R12[12 * 24];
+extern const int BASE_MATRIX_R23[8 * 24];
+extern const int BASE_MATRIX_R34[6 * 24];
+extern const int BASE_MATRIX_R56[4 * 24];
+
+float randn(float mean, float std);
+
+int qc_init_base_graph(QcBaseGraph *bg, int rows, int cols, int Z,
+                       const int *table);
+
+int qc_lifting_set(int Z);
+
+int qc_load_nr_base_graph(QcBaseGraph *bg, const char *path, int Z);
+
+void qc_free_base_graph(QcBaseGraph *bg);
+
+void qc_expand(const QcBaseGraph *bg, uint8_t *H);
+
+bool qc_syndrome_ok(const QcBaseGraph *bg, const uint8_t *c_hat);
+
+int qc_decode(const QcBaseGraph *bg, const float *LLR, uint8_t *c_hat,
+              int max_iter, float offset);
+
+int qc_decode_i16(const QcBaseGraph *bg, const int16_t *LLR_Q, uint8_t *c_hat,
+                  int max_iter, MinSumVariant variant, int param);
+
+int qc_decode_i8(const QcBaseGraph *bg, const int8_t *LLR_Q, uint8_t *c_hat,
+                 int max_iter, MinSumVariant variant, int param);
+
+int ldpc_decode_dense(const uint8_t *H, int M, int N, const float *LLR,
+                      uint8_t *c_hat, int max_iter);
+
+#endif
@@ -3,6 +3,8 @@
 #include <math.h>
 #include <time.h>
 #include "functions_SCD.h"
+#include "latency.h"
+#include "pmu.h"
 
 #include <string.h>
 
@@ -151,11 +153,16 @@ int main(void) {
     /* Bit Error Rate */
     float BER[NUM_EbN0dB] = {0};
 
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
     /* Simulations corresponding to each sig */
     for (unsigned i_sig = 0; i_sig < NUM_EbN0dB; i_sig++) {
         printf("Count %d of %d\n", i_sig + 1, NUM_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
 
         /*Each Simulation*/
         for (unsigned i_num_sim = 0; i_num_sim < NUM_SIM; i_num_sim++) {
@@ -229,9 +236,13 @@ int main(void) {
 
             /* Successive Cancellation Decoding */
             const clock_t dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
             treeDecode(msg_cap, K, LLR_float);
 
+            PMU_STOP(K);
+            lat_record(&lat, lat_now_ns() - lat_start);
             const clock_t dec_end = clock();
 
             dec_cpu_time_used += (float)(dec_end - dec_start);
@@ -248,6 +259,10 @@ int main(void) {
         printf("EbN0dB %0.2f\t", EbN0dB[i_sig]);
         BER[i_sig] = (float)err_count / (float)(K * NUM_SIM);
         printf("BER %lf\n", BER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     }  // end of noise var loop
 
@@ -271,5 +286,7 @@ int main(void) {
     printf("Encoder throughput is %.2f Mbps\n",
            (float)(NUM_SIM * NUM_EbN0dB * K) / (encode_time_used * 1000.0f));
 
+    lat_print(stdout, "all points", &lat_all);
+
     return 0;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include "functions_SCD.h"
+#include "sc_schedule.h"
 
 #include <string.h>
 
@@ -101,7 +102,7 @@ void Encode(int *codeword) {
     }
 }
 
-/* SC Decoder */
+/* SC Decoder, a straight loop over the leaves (see sc_schedule.h) */
 void Decode(int *msg_cap, const unsigned K, const int *LLR_Q,
             const bool *info_nodes, const int *data_pos) {
     /* Beliefs */
@@ -112,95 +113,51 @@ void Decode(int *msg_cap, const unsigned K, const int *LLR_Q,
     /* Decisions */
     int ucap[POLAR_CODE_STAGE + 1][POLAR_CODE_LENGTH];
 
-    /* Node state vector */
-    int ns[POW2(POLAR_CODE_STAGE + 1) - 1] = {0};
-
-    /* Propagation parameters */
-    unsigned node = 0;
-    unsigned depth = 0;
-    bool is_all_bits_decode = false;
-
-    /* Traverse until all bits are decoded */
-    while (!is_all_bits_decode) {
-        /* Position of node in node state vector */
-        const unsigned npos = POW2(depth) - 1U + node;
-
-        /* Check for leaf node */
-        if (depth == POLAR_CODE_STAGE) {
-            /* Check for frozen node and take decision */
-            ucap[POLAR_CODE_STAGE][node] = 0;
-
-            if (info_nodes[node] != 0 && L[POLAR_CODE_STAGE][0] < 0) {
-                ucap[POLAR_CODE_STAGE][node] = 1;
+    for (unsigned i = 0; i < POLAR_CODE_LENGTH; i++) {
+        /* Depth of the right child to continue from, root for leaf 0 */
+        unsigned depth = 0;
+
+        if (i > 0) {
+            depth = sc_turn_depth(i, POLAR_CODE_STAGE);
+
+            /* Combine the completed nodes that end at bit i */
+            for (unsigned d = POLAR_CODE_STAGE - 1; d >= depth; d--) {
+                const unsigned temp = POW2(POLAR_CODE_STAGE - d - 1);
+                const unsigned node_type_ind = i - temp * 2;
+                for (unsigned i_L = 0; i_L < temp; i_L++) {
+                    ucap[d][i_L + node_type_ind]
+                        = ucap[d + 1][i_L + node_type_ind]
+                        ^ ucap[d + 1][i_L + node_type_ind + temp];
+                    ucap[d][i_L + node_type_ind + temp]
+                        = ucap[d + 1][i_L + node_type_ind + temp];
+                }
             }
 
-            node == POLAR_CODE_LENGTH - 1 ? (is_all_bits_decode = true)
-                                          : (node /= 2, depth -= 1);
-            continue;
+            /* g_minsum into the right child */
+            const unsigned temp = POW2(POLAR_CODE_STAGE - depth);
+            for (unsigned i_L = 0; i_L < temp; i_L++) {
+                L[depth][i_L] = g_macro(ucap[depth][i_L + i - temp],
+                                        L[depth - 1][i_L],
+                                        L[depth - 1][i_L + temp]);
+            }
         }
 
-        /* Non-leaf nodes */
-        switch (ns[npos]) {
-        case 0: { /* Propagate to left child */
-            /* Length of current sub-vector */
-            // eq (4.3) of the 2^(n-s-1)
+        /* f_minsum down to the leaf */
+        for (; depth < POLAR_CODE_STAGE; depth++) {
             const unsigned temp = POW2(POLAR_CODE_STAGE - depth - 1);
-            /* f_minsum and storage */
             for (unsigned i_L = 0; i_L < temp; i_L++) {
                 L[depth + 1][i_L]
                     = f_macro(L[depth][i_L], L[depth][i_L + temp]);
             }
-
-            /* Next node: Left child */
-            node *= 2;
-            depth += 1;
-
-            ns[npos] = 1;
-            break;
         }
-        case 1: { /* Propagate to right child */
-            /* Length of current sub-vector */
-            const unsigned temp = POW2(POLAR_CODE_STAGE - depth - 1);
-            /* Index of current node in node_type vector */
-            const unsigned node_type_ind = node * (temp * 2);
-            /* g_minsum and storage */
-            for (unsigned i_L = 0; i_L < temp; i_L++) {
-                L[depth + 1][i_L]
-                    = g_macro(ucap[depth + 1][i_L + node_type_ind],
-                              L[depth][i_L],
-                              L[depth][i_L + temp]);
-            }
 
-            /* Next node: right child */
-            node = node * 2 + 1;
-            depth += 1;
+        /* Check for frozen node and take decision */
+        ucap[POLAR_CODE_STAGE][i] = 0;
 
-            ns[npos] = 2;
-            break;
+        if (info_nodes[i] != 0 && L[POLAR_CODE_STAGE][0] < 0) {
+            ucap[POLAR_CODE_STAGE][i] = 1;
         }
-        case 2: { /* Propagate to parent node */
-            /* Length of current sub-vector */
-            const unsigned temp = POW2(POLAR_CODE_STAGE - depth - 1);
-            /* Index of current node in node_type vector */
-            const unsigned node_type_ind = node * (temp * 2);
-            /* Combine */
-            for (unsigned i_L = 0, count = 0; i_L < temp * 2; i_L++, count++) {
-                ucap[depth][i_L + node_type_ind]
-                    = count < temp
-                        ? ucap[depth + 1][i_L + node_type_ind]
-                              ^ ucap[depth + 1][i_L + node_type_ind + temp]
-                        : ucap[depth + 1][i_L + node_type_ind];
-            }
-
-            node /= 2;
-            depth -= 1;
-            break;
-        }
-        default: {
-            break;
-        }
-        }
-    }  // end of while loop
+    }
 
     for (unsigned i_m = 0; i_m < K; i_m++) {
         msg_cap[i_m] = ucap[POLAR_CODE_STAGE][data_pos[i_m]];
@@ -0,0 +1,114 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scan_decode.h"
+
+/* Min-sum box-plus */
+static inline float boxplus(const float a, const float b) {
+    const float mag = fminf(fabsf(a), fabsf(b));
+    return ((a < 0) != (b < 0)) ? -mag : mag;
+}
+
+/* Start of depth d in the packed rows of L and B_l */
+static inline int scan_off(const ScanDecoder *s, const int d) {
+    return 2 * s->N - 2 * (s->N >> d);
+}
+
+/* B of node i at depth d > 0, as the parent reads or writes it */
+static float *scan_b(ScanDecoder *s, const int d, const int i) {
+    const int len = s->N >> d;
+    if (d == s->n) return &s->prior[i];
+    if (i & 1) return &s->B_r[(size_t)(d - 1) * (size_t)(s->N / 2)
+                             + (size_t)(i >> 1) * (size_t)len];
+    return &s->B_l[scan_off(s, d)];
+}
+
+int scan_init(ScanDecoder *s, const int N, const int *info_nodes,
+              const int max_iter) {
+    memset(s, 0, sizeof(*s));
+    if (N < 2 || (N & (N - 1)) != 0 || max_iter < 1) return -1;
+    s->N = N;
+    while ((1 << s->n) < N) s->n++;
+    s->max_iter = max_iter;
+
+    const size_t inner = s->n > 1 ? (size_t)(s->n - 1) * (size_t)(N / 2) : 1;
+    s->L = malloc(sizeof(float) * 2 * (size_t)N);
+    s->B_l = malloc(sizeof(float) * 2 * (size_t)N);
+    s->B_r = malloc(sizeof(float) * inner);
+    s->prior = malloc(sizeof(float) * (size_t)N);
+    s->u_hat = malloc(sizeof(int) * (size_t)N);
+    if (!s->L || !s->B_l || !s->B_r || !s->prior || !s->u_hat) {
+        scan_free(s);
+        return -1;
+    }
+    for (int i = 0; i < N; i++) {
+        s->prior[i] = info_nodes[i] ? 0.0f : SCAN_LLR_MAX;
+    }
+    return 0;
+}
+
+void scan_free(ScanDecoder *s) {
+    free(s->L);
+    free(s->B_l);
+    free(s->B_r);
+    free(s->prior);
+    free(s->u_hat);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Node i of depth d: L to the left child, left child, L to the right child,
+ * right child, then the node's own B into out */
+static void scan_node(ScanDecoder *s, const int d, const int i, float *out) {
+    if (d == s->n) {
+        /* Leaf: out is its prior, the decision needs L + B */
+        const float llr = s->L[scan_off(s, d)] + *out;
+        s->u_hat[i] = llr < 0;
+        return;
+    }
+
+    const int half = s->N >> (d + 1);
+    const float *Lp = &s->L[scan_off(s, d)];
+    float *Lc = &s->L[scan_off(s, d + 1)];
+    float *Bl = scan_b(s, d + 1, 2 * i);
+    float *Br = scan_b(s, d + 1, 2 * i + 1);
+
+    for (int j = 0; j < half; j++) {
+        Lc[j] = boxplus(Lp[j], Lp[j + half] + Br[j]);
+    }
+    scan_node(s, d + 1, 2 * i, Bl);
+
+    for (int j = 0; j < half; j++) {
+        Lc[j] = Lp[j + half] + boxplus(Lp[j], Bl[j]);
+    }
+    scan_node(s, d + 1, 2 * i + 1, Br);
+
+    for (int j = 0; j < half; j++) {
+        const float bl = Bl[j], br = Br[j];
+        out[j] = boxplus(bl, br + Lp[j + half]);
+        out[j + half] = br + boxplus(bl, Lp[j]);
+    }
+}
+
+void scan_decode(ScanDecoder *s, const float *LLR, float *LLR_out,
+                 int *msg_cap, const int K, const int *data_pos) {
+    const int N = s->N;
+    float B_root[N];
+
+    /* Right children carry nothing before the first iteration */
+    if (s->n > 1) {
+        memset(s->B_r, 0, sizeof(float) * (size_t)(s->n - 1) * (size_t)(N / 2));
+    }
+    memcpy(s->L, LLR, sizeof(float) * (size_t)N);
+
+    for (int iter = 0; iter < s->max_iter; iter++) {
+        scan_node(s, 0, 0, B_root);
+    }
+
+    if (LLR_out) memcpy(LLR_out, B_root, sizeof(float) * (size_t)N);
+    if (msg_cap) {
+        for (int i_m = 0; i_m < K; i_m++) {
+            msg_cap[i_m] = s->u_hat[data_pos[i_m]];
+        }
+    }
+}
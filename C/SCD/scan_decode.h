@@ -0,0 +1,62 @@
+#ifndef SCAN_DECODE_H
+#define SCAN_DECODE_H
+
+/**
+ * @file scan_decode.h
+ * @brief Soft cancellation (SCAN) polar decoder with soft output
+ *
+ * SCAN runs the schedule of the SC decoder Decode(), but a node's children
+ * exchange LLRs instead of hard partial sums: L messages go down towards u
+ * as in SC, B messages (soft partial sums) come back up towards the channel.
+ * Leaves start from the frozen set, +SCAN_LLR_MAX for frozen bits and 0 for
+ * information bits. The left child of a node uses the B of its right sibling
+ * from the previous iteration, the right child the B its left sibling has
+ * just produced. After the last iteration the B of the root are the
+ * extrinsic LLRs of the coded bits for an outer detector, and the leaves'
+ * L + B give the information bits.
+ *
+ * Storage follows the level-indexed rows of Decode() packed into 2N: depth d
+ * holds the N >> d beliefs of its current node only and is updated in
+ * place, as are the B of the current left child per depth. Only the B of the
+ * right children are kept for the next iteration, N / 2 per inner depth.
+ */
+
+/* Prior of a frozen bit, a known zero */
+#define SCAN_LLR_MAX (1e6f)
+
+typedef struct ScanDecoder {
+    int N;
+    int n;
+    int max_iter;
+    float *L;     /* 2N: beliefs of the current node of depth d */
+    float *B_l;   /* 2N: soft partial sums of the current left child */
+    float *B_r;   /* (n - 1) x N / 2: those of every right child */
+    float *prior; /* N: B of the leaves */
+    int *u_hat;   /* N: leaf decisions of the last iteration */
+} ScanDecoder;
+
+/**
+ * @brief Set up a decoder for one frozen set
+ * @param s Decoder
+ * @param N Code length, a power of 2 >= 2
+ * @param info_nodes N flags, non-zero for information positions
+ * @param max_iter Iterations per frame, >= 1
+ * @return 0, or -1 for bad parameters or no memory
+ */
+int scan_init(ScanDecoder *s, int N, const int *info_nodes, int max_iter);
+
+void scan_free(ScanDecoder *s);
+
+/**
+ * @brief Decode one frame
+ * @param s Decoder
+ * @param LLR N channel LLRs, positive for 0
+ * @param LLR_out N extrinsic LLRs of the coded bits, or NULL
+ * @param msg_cap K information bits, or NULL
+ * @param K Number of information bits
+ * @param data_pos The K information positions
+ */
+void scan_decode(ScanDecoder *s, const float *LLR, float *LLR_out,
+                 int *msg_cap, int K, const int *data_pos);
+
+#endif  // SCAN_DECODE_H
@@ -5,10 +5,30 @@
 #include <string.h>
 
 #include "functions_SCL.h"
+#include "../common/latency.h"
+#include "../common/llr_trace.h"
+#include "../common/pmu.h"
+#include "../common/reliability.h"
+
+/* Usage: hello [interleaved] [systematic]
+ * interleaved selects the list-major LLR layout (decode_interleaved),
+ * systematic the systematic code (encode_sys, decode_*_sys) */
+int main(int argc, char **argv){
+
+    /* L paths interleaved per LLR index instead of N apart */
+    int interleaved = 0;
+    /* Message bits sent in the codeword, read at the root by the decoder */
+    int systematic = 0;
+    int i_arg;
+    for (i_arg = 1; i_arg < argc; i_arg++)
+    {
+        interleaved |= (strcmp(argv[i_arg], "interleaved") == 0);
+        systematic |= (strcmp(argv[i_arg], "systematic") == 0);
+    }
 
-int main(){
-
-    srand(time(NULL));
+    /* rand() seed, POLAR_SEED overrides it; goes into the LLR trace */
+    const unsigned seed = llr_trace_seed((unsigned)time(NULL));
+    srand(seed);
 
 	clock_t start, end;
     clock_t enc_start, enc_end;
@@ -82,6 +102,9 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 	/* Number of information bits */
 	int K = (int)N*rate;
 
+    /* Reliability sequence from the file POLAR_Q names (reliability.h) */
+    if (rel_order_env(N, Q) != 0) return EXIT_FAILURE;
+
     /* Boolean array with information nodes pos = 1 */
     int info_nodes[N];
 
@@ -144,11 +167,20 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     /*Simulations corresponding to each sig*/
     int i_sig = 0;
     int count[1];
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
+    /* Frames to a binary LLR trace if POLAR_TRACE names a file */
+    LlrTraceWriter trace;
+    llr_trace_create(&trace, getenv("POLAR_TRACE"), LLR_TRACE_INT8, N, K, crc_l, maxqr, (float)rmax, seed, data_pos);
+
     for (i_sig = 0; i_sig < num_EbN0dB; i_sig++)
     {
         printf("Count %d of %d\n", i_sig+1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
         
         BER[i_sig] = 0;
@@ -193,7 +225,14 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
                 u[data_pos[i_ud]] = msg[i_ud];
             }
 
-            encode(u, N);
+            if (systematic)
+            {
+                encode_sys(u, N, info_nodes);
+            }
+            else
+            {
+                encode(u, N);
+            }
             enc_end = clock();
 
             enc_cpu_time_used = enc_cpu_time_used + ( enc_end - enc_start );
@@ -237,9 +276,20 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 
             int crc_check[l];
 
+            llr_trace_write_int(&trace, EbN0dB[i_sig], LLR_Q, msg);
+
             dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
-            decode_unrolled(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap);
+            if (interleaved)
+            {
+                (systematic ? decode_interleaved_sys : decode_interleaved)(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap);
+            }
+            else
+            {
+                (systematic ? decode_unrolled_sys : decode_unrolled)(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap);
+            }
 
             crcDet(msg_cap, K, l, polynomial, crc_l, crc_check);
 
@@ -259,6 +309,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
                 crc_ind = 0;
             }
 
+            PMU_STOP(K - crc_l);
+            lat_record(&lat, lat_now_ns() - lat_start);
             dec_end = clock();
 
             dec_cpu_time_used = dec_cpu_time_used + ( dec_end - dec_start );
@@ -283,6 +335,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         BER[i_sig] = (double) err_count/(N*num_sim);
         BLER[i_sig] = (double) BLER[i_sig]/(num_sim);
         printf("BER %lf\t BLER %lf\n", BER[i_sig], BLER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     } // end of noise var loop
 
@@ -292,10 +348,13 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     dec_cpu_time_used_rec = ((float) dec_cpu_time_used_rec ) / CLOCKS_PER_SEC;
     dec_cpu_time_used = ((float) dec_cpu_time_used ) / CLOCKS_PER_SEC;
     printf("Time taken encode %d messages is %0.2f secs\n", num_sim*num_EbN0dB, enc_cpu_time_used);
-    printf("Time taken decode %d codewords for unrolled decoder with l '%d' is %0.2f secs\n", num_sim*num_EbN0dB, l, dec_cpu_time_used);
+    printf("Time taken decode %d codewords for %s decoder with l '%d' is %0.2f secs\n", num_sim*num_EbN0dB, interleaved ? "interleaved" : "unrolled", l, dec_cpu_time_used);
     printf("Time taken to run %d simulations is %0.2f secs\n\n", num_sim, cpu_time_used);
     printf("Decoder throughput is %0.2f Mbps for list size %d\n", ((float)(num_sim*num_EbN0dB)/(dec_cpu_time_used*1000)),l);
     printf("Encoder throughput is %0.2f Mbps\n", ((float)(num_sim*num_EbN0dB)/(enc_cpu_time_used*1000)));
 
+    llr_trace_finish(&trace);
+    lat_print(stdout, "all points", &lat_all);
+
 return 0;
 }
\ No newline at end of file
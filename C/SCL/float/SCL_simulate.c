@@ -5,10 +5,16 @@
 #include <string.h>
 
 #include "functions_SCL.h"
+#include "../../common/latency.h"
+#include "../../common/llr_trace.h"
+#include "../../common/pmu.h"
 
 int main(){
 
     // srand(time(NULL));
+    /* rand() seed, POLAR_SEED overrides it; goes into the LLR trace */
+    const unsigned seed = llr_trace_seed(1);
+    srand(seed);
 
 	clock_t start, end;
     clock_t enc_start, enc_end;
@@ -144,11 +150,20 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     /*Simulations corresponding to each sig*/
     int i_sig = 0;
     int count[1];
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
+    /* Frames to a binary LLR trace if POLAR_TRACE names a file */
+    LlrTraceWriter trace;
+    llr_trace_create(&trace, getenv("POLAR_TRACE"), LLR_TRACE_FLOAT, N, K, crc_l, maxqr, (float)rmax, seed, data_pos);
+
     for (i_sig = 0; i_sig < num_EbN0dB; i_sig++)
     {
         printf("Count %d of %d\n", i_sig+1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
         
         BER[i_sig] = 0;
@@ -237,7 +252,11 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 
             int crc_check[l];
 
+            llr_trace_write_float(&trace, EbN0dB[i_sig], LLR, msg);
+
             dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
             decode_unrolled(N, K, l, info_nodes, data_pos, LLR, msg_cap);
 
@@ -259,6 +278,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
                 crc_ind = 0;
             }
 
+            PMU_STOP(K - crc_l);
+            lat_record(&lat, lat_now_ns() - lat_start);
             dec_end = clock();
 
             dec_cpu_time_used = dec_cpu_time_used + ( dec_end - dec_start );
@@ -283,6 +304,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         BER[i_sig] = (double) err_count/(N*num_sim);
         BLER[i_sig] = (double) BLER[i_sig]/(num_sim);
         printf("BER %lf\t BLER %lf\n", BER[i_sig], BLER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     } // end of noise var loop
 
@@ -309,5 +334,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         printf("%lf ", BLER[disp]);
     }
 
+    llr_trace_finish(&trace);
+    lat_print(stdout, "all points", &lat_all);
+
 return 0;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <string.h>
 
 #include "functions_SCL.h"
+#include "../../common/sc_schedule.h"
 #define maxqr 31
 #define sign_macro(x) ((x > 0) - (x < 0))
 #define f_macro(L1, L2) sign_macro(L1)*sign_macro(L2)*mini_macro(absl_macro(L1),absl_macro(L2))
@@ -104,8 +105,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, float
     int i_N;
     int node = 0;
     int depth = 0;
-    int done = 0;
-    int npos = 0;
+    int i_leaf;
     int temp = 0;
     int node_type_ind;
     
@@ -128,14 +128,6 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, float
     float key_arr;
     int key_ind, cur_index;
 
-    /* Node state vector */
-    int ns[2*N-1];
-
-    for (i_N = 0; i_N < 2*N-1; i_N++)
-    {
-        ns[i_N] = 0;
-    }
-
     /* Belief initialization */
     for (i_list = 0; i_list < l; i_list++)
     {
@@ -154,330 +146,323 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, float
     /* Variable to count no. of decoded data bits */
     int counter = 0;
 
-    while (!(done == 1 && depth == -1)) //traverse till all bits are decoded and root node is reached again
+    /* Leaf after leaf (see sc_schedule.h); i_leaf = N completes the root */
+    for (i_leaf = 0; i_leaf <= N; i_leaf++)
     {
-        /* Position of node in node state vector */
-        npos = (1 << depth) - 1 + node;
+        /* Depth of the right child to continue from, root for leaf 0 */
+        int turn = (i_leaf == 0) ? 0 : (int)sc_turn_depth((unsigned)i_leaf, (unsigned)n);
 
-        /* Length of current sub-vector */
-        temp = 1 << (n - depth);
+        /* Propogate to parent nodes: the completed nodes that end at i_leaf */
+        for (depth = (i_leaf == 0) ? -1 : n-1; depth >= turn; depth--)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-        /* Index of current node in node_type vector */
-        node_type_ind = node*temp;
+            /* Current node and its index in node_type vector */
+            node = (i_leaf >> (n - depth)) - 1;
+            node_type_ind = node*temp;
 
-        /* Check for leaf node */
-        if (depth == n && done == 0)
-        {
-            if ( info_nodes[node_type_ind] == 0 )
+            /* Updating beta */
+            int i_up;
+            int i_temp_ord;
+            int i_temp;
+            int ind_ord_temp2[l];
+
+            for (i_list = 0; i_list < l; i_list++)
             {
-                /* Assigning 0 to decoded bits and updating path metrics */
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    beta[depth][node_type_ind + i_list*N] = 0;
-                    
-                    ( L[depth][i_list*N] < 0 ) ? ( PM[i_list] = PM[i_list] - L[depth][i_list*N] ) : 1 ;
-                }
-            
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    ind_ord_l[i_list] = i_list;
-                }
+                /* Order of surviving decoders from left */
+                ind_ord_temp[i_list] = ind_ord_mat[depth +1][2*node + i_list*N];
 
-                /* Sorting the Path Metrics -- Insertion Sort */
-                for (i_list = 1; i_list < l; i_list++) 
-                {
-                    key_arr = PM[i_list];
-                    key_ind = ind_ord_l[i_list]; 
-                    cur_index = i_list-1; 
- 
-                    while (cur_index >= 0 && PM[cur_index] > key_arr) 
-                    { 
-                        PM[cur_index+1] = PM[cur_index];
-                        ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
-                        cur_index = cur_index-1; 
-                    } 
-                    PM[cur_index+1] = key_arr;
-                    ind_ord_l[cur_index+1] = key_ind;
-                }
+                /* Order of surviving decoders from right */
+                ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
+            }
 
-                /* New ordering */
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
-                }
+            /* Final Order of surviving decoders to be passed to parent node */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = ind_ord_temp2[i_list];
 
-            } // end of frozen leaf node check
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[i_temp];
+            }
 
-            else
+            /* Updating beta to be passed to parent node */
+            for (i_list = 0; i_list < l; i_list++)
             {
-                if (counter > ln - 1)
-                {
-                    /* Duplicating the old data */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        PM_temp[i_list] = PM[i_list];
-                        PM_temp[i_list + l] = PM[i_list];
-                    }
+                i_temp = node_type_ind + i_list*N;
+                i_temp_ord = node_type_ind + (ind_ord_mat[depth + 1][2*node + 1 + i_list*N])*N;
 
-                    /* Forking into Path 0 and Path 1 */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        codeword_temp[i_list] = 0;
-                        
-                        if ( L[depth][i_list*N] < 0 )
-                        {
-                            PM_temp[i_list] = PM_temp[i_list] - L[depth][i_list*N];
-                        }
-                    }
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                }
 
-                    for (i_list = l; i_list < 2*l; i_list++)
-                    {
-                        codeword_temp[i_list] = 1;
-                        
-                        if (  L[depth][(i_list-l)*N] > 0 )
-                        {
-                            PM_temp[i_list] = PM_temp[i_list] + L[depth][(i_list-l)*N];
-                        }
-                    }
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + temp/2 + i_temp] =  beta[depth+1][i_temp + temp/2 + i_up];
+                }
+            }
+        } // end of parent node propagation
 
-                    
-                    for (i_list = 0; i_list < 2*l; i_list++)
-                    {
-                        ind_ord[i_list] = i_list;
-                    }
+        if (i_leaf == N) break;
 
-                    /* Sorting the Path Metrics -- Insertion Sort */
-                    for (i_list = 1; i_list < 2*l; i_list++) 
-                    {
+        /* Propogate to right child */
+        if (i_leaf > 0)
+        {
+            depth = turn - 1;
 
-                        key_arr = PM_temp[i_list];
-                        key_ind = ind_ord[i_list]; 
-                        cur_index = i_list-1; 
-     
-                        while (cur_index >= 0 && PM_temp[cur_index] > key_arr) 
-                        { 
-                            PM_temp[cur_index+1] = PM_temp[cur_index];
-                            ind_ord[cur_index+1] = ind_ord[cur_index];
-                            cur_index = cur_index-1; 
-                        } 
-                        PM_temp[cur_index+1] = key_arr;
-                        ind_ord[cur_index+1] = key_ind;
-                    }
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        PM[i_list] = PM_temp[i_list];
-                    }
-                    
-                    /* Re-ordering the estimated vector and updating beta*/
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        beta[depth][node_type_ind + i_list*N] = codeword_temp[ind_ord[i_list]];
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord[i_list]%l;
-                    }
+            int i_temp;
+            int i_temp_ord;
 
-                    counter++;
-                } // end of normal data leaf node check
+            /* g_minsum and storage */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+                i_temp_ord = (ind_ord_mat[depth+1][2*node + i_list*N])*N;
 
-                else
+                for (i_L = 0; i_L < temp/2; i_L++)
                 {
-                    int init;
+                    L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node_type_ind + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
+                }
+            }
+        } // end of right child propogation
 
-                    if (counter > 0)
-                    {
-                        for (init = 0; init < 2*counter; init++)
-                        {
-                            start_ind = 0 + init*(l/(2*counter)); end_ind = start_ind + l/(4*counter);
-
-                            for (i_list = start_ind; i_list < end_ind; i_list++)
-                            {
-                                codeword[i_list] = 0;
-                            }
-                            start_ind = end_ind; end_ind = start_ind + l/(4*counter);
-
-                            for (i_list = start_ind; i_list < end_ind; i_list++)
-                            {
-                                codeword[i_list] = 1;
-                            }
-                        }
-                    }
+        /* Propogate to left child, down to the leaf */
+        for (depth = turn; depth < n; depth++)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-                    else
-                    {
-                        for (i_list = 0; i_list < l/2; i_list++)
-                        {
-                            codeword[i_list] = 0;
-                        }
-                        for (i_list = l/2; i_list < l; i_list++)
-                        {
-                            codeword[i_list] = 1;
-                        }
-                    }
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
 
-                    /* Updating the Path Metric */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        if (codeword[i_list] != 0.5*(1 - sign_macro(L[depth][i_list*N])))
-                        {
-                            PM[i_list] = PM[i_list] + absl_macro(L[depth][i_list*N]);
-                        }
-                    }
+            int i_temp;
 
-                    /* Initialization for new estimate */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        ind_ord_l[i_list] = i_list;
-                    }
+            /* f_minsum and storage */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
 
-                    /* Sorting the Path Metrics  */
-                    for (i_list = 1; i_list < l; i_list++) 
-                    {
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                }
+            }
+        } // end of left child propogation
 
-                        key_arr = PM[i_list];
-                        key_ind = ind_ord_l[i_list]; 
-                        cur_index = i_list-1; 
-     
-                        while (cur_index >= 0 && PM[cur_index] > key_arr) 
-                        { 
-                            PM[cur_index+1] = PM[cur_index];
-                            ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
-                            cur_index = cur_index-1; 
-                        } 
-                        PM[cur_index+1] = key_arr;
-                        ind_ord_l[cur_index+1] = key_ind;
-                    }
+        /* Leaf node */
+        depth = n;
+        temp = 1;
+        node = i_leaf;
+        node_type_ind = i_leaf;
 
-                    /* New ordering */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        ind_ord[i_list] = ind_ord_l[i_list];
-                        ind_ord[i_list + l] = ind_ord_l[i_list];
+        if ( info_nodes[node_type_ind] == 0 )
+        {
+            /* Assigning 0 to decoded bits and updating path metrics */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                beta[depth][node_type_ind + i_list*N] = 0;
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
-                    }
+                ( L[depth][i_list*N] < 0 ) ? ( PM[i_list] = PM[i_list] - L[depth][i_list*N] ) : 1 ;
+            }
 
-                    /* Re-ordering the estimated vector */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        beta[depth][node_type_ind + i_list*N] = codeword[ind_ord[i_list]];
-                    }
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_l[i_list] = i_list;
+            }
 
-                    counter++;
-                } //end of data leaf node check
+            /* Sorting the Path Metrics -- Insertion Sort */
+            for (i_list = 1; i_list < l; i_list++) 
+            {
+                key_arr = PM[i_list];
+                key_ind = ind_ord_l[i_list]; 
+                cur_index = i_list-1; 
+
+                while (cur_index >= 0 && PM[cur_index] > key_arr) 
+                { 
+                    PM[cur_index+1] = PM[cur_index];
+                    ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
+                    cur_index = cur_index-1; 
+                } 
+                PM[cur_index+1] = key_arr;
+                ind_ord_l[cur_index+1] = key_ind;
+            }
 
-            } // end of else 
+            /* New ordering */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
+            }
 
-            (node == N-1) ? (done = 1, node >>= 1 , depth -= 1) :  (node >>= 1 , depth -= 1 );
-        } // end of leaf node
+        } // end of frozen leaf node check
 
         else
         {
-            /* Propogate to left child */
-            if (ns[npos] == 0 && done == 0)
+            if (counter > ln - 1)
             {
-                int i_temp;
+                /* Duplicating the old data */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    PM_temp[i_list] = PM[i_list];
+                    PM_temp[i_list + l] = PM[i_list];
+                }
 
-                /* f_minsum and storage */
+                /* Forking into Path 0 and Path 1 */
                 for (i_list = 0; i_list < l; i_list++)
                 {
-                    i_temp = i_list*N;
+                    codeword_temp[i_list] = 0;
 
-                    for (i_L = 0; i_L < temp/2; i_L++)
+                    if ( L[depth][i_list*N] < 0 )
                     {
-                        L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                        PM_temp[i_list] = PM_temp[i_list] - L[depth][i_list*N];
                     }
                 }
 
-                /* Next node: Left child */
-                node <<= 1 ; depth += 1 ;
-
-                /* Incoming belief length for left child */
-                temp>>=1;
-
-                ns[npos] = 1;
-            } // end of left child propogation
-
-            else
-            {
-                /* Propogate to right child */               
-                if (ns[npos] == 1 && done == 0)
+                for (i_list = l; i_list < 2*l; i_list++)
                 {
-                    int i_temp;
-                    int i_temp_ord;
+                    codeword_temp[i_list] = 1;
 
-                    /* g_minsum and storage */
-                    for (i_list = 0; i_list < l; i_list++)
+                    if (  L[depth][(i_list-l)*N] > 0 )
                     {
-                        i_temp = i_list*N;
-                        i_temp_ord = (ind_ord_mat[depth+1][2*node + i_list*N])*N;
-
-                        for (i_L = 0; i_L < temp/2; i_L++)
-                        {
-                            L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node_type_ind + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
-                        }
+                        PM_temp[i_list] = PM_temp[i_list] + L[depth][(i_list-l)*N];
                     }
+                }
 
-                    /* Next node: right child */
-                    node = (node << 1) + 1; depth += 1;
 
-                    /* Incoming belief length for right child */
-                    temp >>= 1;
+                for (i_list = 0; i_list < 2*l; i_list++)
+                {
+                    ind_ord[i_list] = i_list;
+                }
 
-                    ns[npos] = 2;
-                } // end of right child propogation
+                /* Sorting the Path Metrics -- Insertion Sort */
+                for (i_list = 1; i_list < 2*l; i_list++) 
+                {
 
-                /* Propogate to parent node */
-                else
+                    key_arr = PM_temp[i_list];
+                    key_ind = ind_ord[i_list]; 
+                    cur_index = i_list-1; 
+
+                    while (cur_index >= 0 && PM_temp[cur_index] > key_arr) 
+                    { 
+                        PM_temp[cur_index+1] = PM_temp[cur_index];
+                        ind_ord[cur_index+1] = ind_ord[cur_index];
+                        cur_index = cur_index-1; 
+                    } 
+                    PM_temp[cur_index+1] = key_arr;
+                    ind_ord[cur_index+1] = key_ind;
+                }
+
+                for (i_list = 0; i_list < l; i_list++)
                 {
-                    /* Updating beta */
-                    int i_up;
-                    int i_temp_ord;
-                    int i_temp;
-                    int ind_ord_temp2[l];
+                    PM[i_list] = PM_temp[i_list];
+                }
 
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        /* Order of surviving decoders from left */
-                        ind_ord_temp[i_list] = ind_ord_mat[depth +1][2*node + i_list*N];
+                /* Re-ordering the estimated vector and updating beta*/
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    beta[depth][node_type_ind + i_list*N] = codeword_temp[ind_ord[i_list]];
 
-                        /* Order of surviving decoders from right */
-                        ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
-                    }
+                    ind_ord_mat[depth][node + i_list*N] = ind_ord[i_list]%l;
+                }
 
-                    /* Final Order of surviving decoders to be passed to parent node */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        i_temp = ind_ord_temp2[i_list];
+                counter++;
+            } // end of normal data leaf node check
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[i_temp];
-                    }
+            else
+            {
+                int init;
 
-                    /* Updating beta to be passed to parent node */
-                    for (i_list = 0; i_list < l; i_list++)
+                if (counter > 0)
+                {
+                    for (init = 0; init < 2*counter; init++)
                     {
-                        i_temp = node_type_ind + i_list*N;
-                        i_temp_ord = node_type_ind + (ind_ord_mat[depth + 1][2*node + 1 + i_list*N])*N;
+                        start_ind = 0 + init*(l/(2*counter)); end_ind = start_ind + l/(4*counter);
 
-                        for (i_up = 0; i_up < temp/2; i_up++)
+                        for (i_list = start_ind; i_list < end_ind; i_list++)
                         {
-                            beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                            codeword[i_list] = 0;
                         }
+                        start_ind = end_ind; end_ind = start_ind + l/(4*counter);
 
-                        for (i_up = 0; i_up < temp/2; i_up++)
+                        for (i_list = start_ind; i_list < end_ind; i_list++)
                         {
-                            beta[depth][i_up + temp/2 + i_temp] =  beta[depth+1][i_temp + temp/2 + i_up];
+                            codeword[i_list] = 1;
                         }
                     }
+                }
+
+                else
+                {
+                    for (i_list = 0; i_list < l/2; i_list++)
+                    {
+                        codeword[i_list] = 0;
+                    }
+                    for (i_list = l/2; i_list < l; i_list++)
+                    {
+                        codeword[i_list] = 1;
+                    }
+                }
+
+                /* Updating the Path Metric */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    if (codeword[i_list] != 0.5*(1 - sign_macro(L[depth][i_list*N])))
+                    {
+                        PM[i_list] = PM[i_list] + absl_macro(L[depth][i_list*N]);
+                    }
+                }
+
+                /* Initialization for new estimate */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    ind_ord_l[i_list] = i_list;
+                }
 
-                    node >>= 1; depth -= 1;
-                } // end of parent node propagation
+                /* Sorting the Path Metrics  */
+                for (i_list = 1; i_list < l; i_list++) 
+                {
 
-            } // end of else for left child propagation
+                    key_arr = PM[i_list];
+                    key_ind = ind_ord_l[i_list]; 
+                    cur_index = i_list-1; 
+
+                    while (cur_index >= 0 && PM[cur_index] > key_arr) 
+                    { 
+                        PM[cur_index+1] = PM[cur_index];
+                        ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
+                        cur_index = cur_index-1; 
+                    } 
+                    PM[cur_index+1] = key_arr;
+                    ind_ord_l[cur_index+1] = key_ind;
+                }
+
+                /* New ordering */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    ind_ord[i_list] = ind_ord_l[i_list];
+                    ind_ord[i_list + l] = ind_ord_l[i_list];
+
+                    ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
+                }
+
+                /* Re-ordering the estimated vector */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    beta[depth][node_type_ind + i_list*N] = codeword[ind_ord[i_list]];
+                }
 
-        } // end of non-leaf node check
+                counter++;
+            } //end of data leaf node check
 
-    }   // end of while loop ==> decoder stops
+        } // end of else
+    } // end of loop over leaves ==> decoder stops
 
     int temp_beta[N];
     int i_n;   
@@ -3,8 +3,11 @@
 #include <math.h>
 #include <time.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "functions_SCL.h"
+#include "../common/sc_schedule.h"
+#include "../common/min_sum.h"
 #define maxqr 31
 #define sign_macro(x) ((x > 0) - (x < 0))
 #define f_macro(L1, L2) sign_macro(L1)*sign_macro(L2)*mini_macro(absl_macro(L1),absl_macro(L2))
@@ -83,8 +86,27 @@ void encode(int *u, int N)
     }
 }
 
-/* SCL Decoder */
-void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
+/* Systematic encoder: u holds the message at the information positions
+ * and zeros elsewhere, and gets the codeword x with x[data_pos] = message.
+ * Two passes of encode() with the frozen positions zeroed in between, exact
+ * for information sets whose positions dominate each other as the
+ * reliability sequence of the simulations does */
+void encode_sys(int *u, int N, int *info_nodes)
+{
+    int i;
+
+    encode(u, N);
+    for (i = 0; i < N; i++)
+    {
+        u[i] = u[i] & (info_nodes[i] != 0);
+    }
+    encode(u, N);
+}
+
+/* SCL Decoder; with systematic set, msg_cap gets the codeword bits at
+ * data_pos straight from beta[0] (encode_sys() codes) instead of the
+ * re-encoded decisions */
+static inline void scl_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap, int systematic)
 {
     int n = 0, N_log = N, l0_log = l, ln = 0;
      /* log function */
@@ -104,8 +126,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *L
     int i_N;
     int node = 0;
     int depth = 0;
-    int done = 0;
-    int npos = 0;
+    int i_leaf;
     int temp = 0;
     int node_type_ind;
     
@@ -127,14 +148,6 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *L
 
     int key_arr, key_ind, cur_index;
 
-    /* Node state vector */
-    int ns[2*N-1];
-
-    for (i_N = 0; i_N < 2*N-1; i_N++)
-    {
-        ns[i_N] = 0;
-    }
-
     /* Belief initialization */
     for (i_list = 0; i_list < l; i_list++)
     {
@@ -153,335 +166,347 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *L
     /* Variable to count no. of decoded data bits */
     int counter = 0;
 
-    while (!(done == 1 && depth == -1)) //traverse till all bits are decoded and root node is reached again
+    /* Leaf after leaf (see sc_schedule.h); i_leaf = N completes the root */
+    for (i_leaf = 0; i_leaf <= N; i_leaf++)
     {
-        /* Position of node in node state vector */
-        npos = (1 << depth) - 1 + node;
+        /* Depth of the right child to continue from, root for leaf 0 */
+        int turn = (i_leaf == 0) ? 0 : (int)sc_turn_depth((unsigned)i_leaf, (unsigned)n);
 
-        /* Length of current sub-vector */
-        temp = 1 << (n - depth);
+        /* Propogate to parent nodes: the completed nodes that end at i_leaf */
+        for (depth = (i_leaf == 0) ? -1 : n-1; depth >= turn; depth--)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-        /* Index of current node in node_type vector */
-        node_type_ind = node*temp;
+            /* Current node and its index in node_type vector */
+            node = (i_leaf >> (n - depth)) - 1;
+            node_type_ind = node*temp;
 
-        /* Check for leaf node */
-        if (depth == n && done == 0)
-        {
-            if ( info_nodes[node_type_ind] == 0 )
+            /* Updating beta */
+            int i_up;
+            int i_temp_ord;
+            int i_temp;
+            int ind_ord_temp2[l];
+
+            for (i_list = 0; i_list < l; i_list++)
             {
-                /* Assigning 0 to decoded bits and updating path metrics */
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    beta[depth][node_type_ind + i_list*N] = 0;
-                    
-                    ( L[depth][i_list*N] < 0 ) ? ( PM[i_list] = PM[i_list] - L[depth][i_list*N] ) : 1 ;
-                }
-            
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    ind_ord_l[i_list] = i_list;
-                }
+                /* Order of surviving decoders from left */
+                ind_ord_temp[i_list] = ind_ord_mat[depth +1][2*node + i_list*N];
 
-                /* Sorting the Path Metrics -- Insertion Sort */
-                for (i_list = 1; i_list < l; i_list++) 
-                {
-                    key_arr = PM[i_list];
-                    key_ind = ind_ord_l[i_list]; 
-                    cur_index = i_list-1; 
- 
-                    while (cur_index >= 0 && PM[cur_index] > key_arr) 
-                    { 
-                        PM[cur_index+1] = PM[cur_index];
-                        ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
-                        cur_index = cur_index-1; 
-                    } 
-                    PM[cur_index+1] = key_arr;
-                    ind_ord_l[cur_index+1] = key_ind;
-                }
+                /* Order of surviving decoders from right */
+                ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
+            }
 
-                /* New ordering */
-                for (i_list = 0; i_list < l; i_list++)
-                {
-                    ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
-                }
+            /* Final Order of surviving decoders to be passed to parent node */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = ind_ord_temp2[i_list];
 
-            } // end of frozen leaf node check
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[i_temp];
+            }
 
-            else
+            /* Updating beta to be passed to parent node */
+            for (i_list = 0; i_list < l; i_list++)
             {
-                if (counter > ln - 1)
-                {
-                    /* Duplicating the old data */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        PM_temp[i_list] = PM[i_list];
-                        PM_temp[i_list + l] = PM[i_list];
-                    }
+                i_temp = node_type_ind + i_list*N;
+                i_temp_ord = node_type_ind + (ind_ord_mat[depth + 1][2*node + 1 + i_list*N])*N;
 
-                    /* Forking into Path 0 and Path 1 */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        codeword_temp[i_list] = 0;
-                        
-                        if ( L[depth][i_list*N] < 0 )
-                        {
-                            PM_temp[i_list] = PM_temp[i_list] - L[depth][i_list*N];
-                        }
-                    }
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                }
 
-                    for (i_list = l; i_list < 2*l; i_list++)
-                    {
-                        codeword_temp[i_list] = 1;
-                        
-                        if (  L[depth][(i_list-l)*N] > 0 )
-                        {
-                            PM_temp[i_list] = PM_temp[i_list] + L[depth][(i_list-l)*N];
-                        }
-                    }
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + temp/2 + i_temp] =  beta[depth+1][i_temp + temp/2 + i_up];
+                }
+            }
+        } // end of parent node propagation
 
-                    
-                    for (i_list = 0; i_list < 2*l; i_list++)
-                    {
-                        ind_ord[i_list] = i_list;
-                    }
+        if (i_leaf == N) break;
 
-                    /* Sorting the Path Metrics -- Insertion Sort */
-                    for (i_list = 1; i_list < 2*l; i_list++) 
-                    {
+        /* Propogate to right child */
+        if (i_leaf > 0)
+        {
+            depth = turn - 1;
 
-                        key_arr = PM_temp[i_list];
-                        key_ind = ind_ord[i_list]; 
-                        cur_index = i_list-1; 
-     
-                        while (cur_index >= 0 && PM_temp[cur_index] > key_arr) 
-                        { 
-                            PM_temp[cur_index+1] = PM_temp[cur_index];
-                            ind_ord[cur_index+1] = ind_ord[cur_index];
-                            cur_index = cur_index-1; 
-                        } 
-                        PM_temp[cur_index+1] = key_arr;
-                        ind_ord[cur_index+1] = key_ind;
-                    }
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        PM[i_list] = PM_temp[i_list];
-                    }
-                    
-                    /* Re-ordering the estimated vector and updating beta*/
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        beta[depth][node_type_ind + i_list*N] = codeword_temp[ind_ord[i_list]];
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord[i_list]%l;
-                    }
+            int i_temp;
+            int i_temp_ord;
 
-                    counter++;
-                } // end of normal data leaf node check
+            /* g_minsum and storage */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+                i_temp_ord = (ind_ord_mat[depth+1][2*node + i_list*N])*N;
 
-                else
+                for (i_L = 0; i_L < temp/2; i_L++)
                 {
-                    int init;
+                    L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node_type_ind + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
+                }
+            }
+        } // end of right child propogation
 
-                    if (counter > 0)
-                    {
-                        for (init = 0; init < 2*counter; init++)
-                        {
-                            start_ind = 0 + init*(l/(2*counter)); end_ind = start_ind + l/(4*counter);
-
-                            for (i_list = start_ind; i_list < end_ind; i_list++)
-                            {
-                                codeword[i_list] = 0;
-                            }
-                            start_ind = end_ind; end_ind = start_ind + l/(4*counter);
-
-                            for (i_list = start_ind; i_list < end_ind; i_list++)
-                            {
-                                codeword[i_list] = 1;
-                            }
-                        }
-                    }
+        /* Propogate to left child, down to the leaf */
+        for (depth = turn; depth < n; depth++)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
 
-                    else
-                    {
-                        for (i_list = 0; i_list < l/2; i_list++)
-                        {
-                            codeword[i_list] = 0;
-                        }
-                        for (i_list = l/2; i_list < l; i_list++)
-                        {
-                            codeword[i_list] = 1;
-                        }
-                    }
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
 
-                    /* Updating the Path Metric */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        if (codeword[i_list] != 0.5*(1 - sign_macro(L[depth][i_list*N])))
-                        {
-                            PM[i_list] = PM[i_list] + absl_macro(L[depth][i_list*N]);
-                        }
-                    }
+            int i_temp;
 
-                    /* Initialization for new estimate */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        ind_ord_l[i_list] = i_list;
-                    }
+            /* f_minsum and storage */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
 
-                    /* Sorting the Path Metrics  */
-                    for (i_list = 1; i_list < l; i_list++) 
-                    {
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                }
+            }
+        } // end of left child propogation
 
-                        key_arr = PM[i_list];
-                        key_ind = ind_ord_l[i_list]; 
-                        cur_index = i_list-1; 
-     
-                        while (cur_index >= 0 && PM[cur_index] > key_arr) 
-                        { 
-                            PM[cur_index+1] = PM[cur_index];
-                            ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
-                            cur_index = cur_index-1; 
-                        } 
-                        PM[cur_index+1] = key_arr;
-                        ind_ord_l[cur_index+1] = key_ind;
-                    }
+        /* Leaf node */
+        depth = n;
+        temp = 1;
+        node = i_leaf;
+        node_type_ind = i_leaf;
 
-                    /* New ordering */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        ind_ord[i_list] = ind_ord_l[i_list];
-                        ind_ord[i_list + l] = ind_ord_l[i_list];
+        if ( info_nodes[node_type_ind] == 0 )
+        {
+            /* Assigning 0 to decoded bits and updating path metrics */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                beta[depth][node_type_ind + i_list*N] = 0;
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
-                    }
+                ( L[depth][i_list*N] < 0 ) ? ( PM[i_list] = PM[i_list] - L[depth][i_list*N] ) : 1 ;
+            }
 
-                    /* Re-ordering the estimated vector */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        beta[depth][node_type_ind + i_list*N] = codeword[ind_ord[i_list]];
-                    }
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_l[i_list] = i_list;
+            }
 
-                    counter++;
-                } //end of data leaf node check
+            /* Sorting the Path Metrics -- Insertion Sort */
+            for (i_list = 1; i_list < l; i_list++) 
+            {
+                key_arr = PM[i_list];
+                key_ind = ind_ord_l[i_list]; 
+                cur_index = i_list-1; 
+
+                while (cur_index >= 0 && PM[cur_index] > key_arr) 
+                { 
+                    PM[cur_index+1] = PM[cur_index];
+                    ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
+                    cur_index = cur_index-1; 
+                } 
+                PM[cur_index+1] = key_arr;
+                ind_ord_l[cur_index+1] = key_ind;
+            }
 
-            } // end of else 
+            /* New ordering */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
+            }
 
-            (node == N-1) ? (done = 1, node >>= 1 , depth -= 1) :  (node >>= 1 , depth -= 1 );
-        } // end of leaf node
+        } // end of frozen leaf node check
 
         else
         {
-            /* Propogate to left child */
-            if (ns[npos] == 0 && done == 0)
+            if (counter > ln - 1)
             {
-                int i_temp;
+                /* Duplicating the old data */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    PM_temp[i_list] = PM[i_list];
+                    PM_temp[i_list + l] = PM[i_list];
+                }
 
-                /* f_minsum and storage */
+                /* Forking into Path 0 and Path 1 */
                 for (i_list = 0; i_list < l; i_list++)
                 {
-                    i_temp = i_list*N;
+                    codeword_temp[i_list] = 0;
 
-                    for (i_L = 0; i_L < temp/2; i_L++)
+                    if ( L[depth][i_list*N] < 0 )
                     {
-                        L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                        PM_temp[i_list] = PM_temp[i_list] - L[depth][i_list*N];
                     }
                 }
 
-                /* Next node: Left child */
-                node <<= 1 ; depth += 1 ;
-
-                /* Incoming belief length for left child */
-                temp>>=1;
-
-                ns[npos] = 1;
-            } // end of left child propogation
-
-            else
-            {
-                /* Propogate to right child */               
-                if (ns[npos] == 1 && done == 0)
+                for (i_list = l; i_list < 2*l; i_list++)
                 {
-                    int i_temp;
-                    int i_temp_ord;
+                    codeword_temp[i_list] = 1;
 
-                    /* g_minsum and storage */
-                    for (i_list = 0; i_list < l; i_list++)
+                    if (  L[depth][(i_list-l)*N] > 0 )
                     {
-                        i_temp = i_list*N;
-                        i_temp_ord = (ind_ord_mat[depth+1][2*node + i_list*N])*N;
-
-                        for (i_L = 0; i_L < temp/2; i_L++)
-                        {
-                            L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node_type_ind + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
-                        }
+                        PM_temp[i_list] = PM_temp[i_list] + L[depth][(i_list-l)*N];
                     }
+                }
+
+
+                for (i_list = 0; i_list < 2*l; i_list++)
+                {
+                    ind_ord[i_list] = i_list;
+                }
 
-                    /* Next node: right child */
-                    node = (node << 1) + 1; depth += 1;
+                /* Sorting the Path Metrics -- Insertion Sort */
+                for (i_list = 1; i_list < 2*l; i_list++) 
+                {
 
-                    /* Incoming belief length for right child */
-                    temp >>= 1;
+                    key_arr = PM_temp[i_list];
+                    key_ind = ind_ord[i_list]; 
+                    cur_index = i_list-1; 
 
-                    ns[npos] = 2;
-                } // end of right child propogation
+                    while (cur_index >= 0 && PM_temp[cur_index] > key_arr) 
+                    { 
+                        PM_temp[cur_index+1] = PM_temp[cur_index];
+                        ind_ord[cur_index+1] = ind_ord[cur_index];
+                        cur_index = cur_index-1; 
+                    } 
+                    PM_temp[cur_index+1] = key_arr;
+                    ind_ord[cur_index+1] = key_ind;
+                }
 
-                /* Propogate to parent node */
-                else
+                for (i_list = 0; i_list < l; i_list++)
                 {
-                    /* Updating beta */
-                    int i_up;
-                    int i_temp_ord;
-                    int i_temp;
-                    int ind_ord_temp2[l];
+                    PM[i_list] = PM_temp[i_list];
+                }
 
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        /* Order of surviving decoders from left */
-                        ind_ord_temp[i_list] = ind_ord_mat[depth +1][2*node + i_list*N];
+                /* Re-ordering the estimated vector and updating beta*/
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    beta[depth][node_type_ind + i_list*N] = codeword_temp[ind_ord[i_list]];
 
-                        /* Order of surviving decoders from right */
-                        ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
-                    }
+                    ind_ord_mat[depth][node + i_list*N] = ind_ord[i_list]%l;
+                }
 
-                    /* Final Order of surviving decoders to be passed to parent node */
-                    for (i_list = 0; i_list < l; i_list++)
-                    {
-                        i_temp = ind_ord_temp2[i_list];
+                counter++;
+            } // end of normal data leaf node check
 
-                        ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[i_temp];
-                    }
+            else
+            {
+                int init;
 
-                    /* Updating beta to be passed to parent node */
-                    for (i_list = 0; i_list < l; i_list++)
+                if (counter > 0)
+                {
+                    for (init = 0; init < 2*counter; init++)
                     {
-                        i_temp = node_type_ind + i_list*N;
-                        i_temp_ord = node_type_ind + (ind_ord_mat[depth + 1][2*node + 1 + i_list*N])*N;
+                        start_ind = 0 + init*(l/(2*counter)); end_ind = start_ind + l/(4*counter);
 
-                        for (i_up = 0; i_up < temp/2; i_up++)
+                        for (i_list = start_ind; i_list < end_ind; i_list++)
                         {
-                            beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                            codeword[i_list] = 0;
                         }
+                        start_ind = end_ind; end_ind = start_ind + l/(4*counter);
 
-                        for (i_up = 0; i_up < temp/2; i_up++)
+                        for (i_list = start_ind; i_list < end_ind; i_list++)
                         {
-                            beta[depth][i_up + temp/2 + i_temp] =  beta[depth+1][i_temp + temp/2 + i_up];
+                            codeword[i_list] = 1;
                         }
                     }
+                }
+
+                else
+                {
+                    for (i_list = 0; i_list < l/2; i_list++)
+                    {
+                        codeword[i_list] = 0;
+                    }
+                    for (i_list = l/2; i_list < l; i_list++)
+                    {
+                        codeword[i_list] = 1;
+                    }
+                }
+
+                /* Updating the Path Metric */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    if (codeword[i_list] != 0.5*(1 - sign_macro(L[depth][i_list*N])))
+                    {
+                        PM[i_list] = PM[i_list] + absl_macro(L[depth][i_list*N]);
+                    }
+                }
+
+                /* Initialization for new estimate */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    ind_ord_l[i_list] = i_list;
+                }
+
+                /* Sorting the Path Metrics  */
+                for (i_list = 1; i_list < l; i_list++) 
+                {
+
+                    key_arr = PM[i_list];
+                    key_ind = ind_ord_l[i_list]; 
+                    cur_index = i_list-1; 
+
+                    while (cur_index >= 0 && PM[cur_index] > key_arr) 
+                    { 
+                        PM[cur_index+1] = PM[cur_index];
+                        ind_ord_l[cur_index+1] = ind_ord_l[cur_index];
+                        cur_index = cur_index-1; 
+                    } 
+                    PM[cur_index+1] = key_arr;
+                    ind_ord_l[cur_index+1] = key_ind;
+                }
+
+                /* New ordering */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    ind_ord[i_list] = ind_ord_l[i_list];
+                    ind_ord[i_list + l] = ind_ord_l[i_list];
 
-                    node >>= 1; depth -= 1;
-                } // end of parent node propagation
+                    ind_ord_mat[depth][node + i_list*N] = ind_ord_l[i_list];
+                }
+
+                /* Re-ordering the estimated vector */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    beta[depth][node_type_ind + i_list*N] = codeword[ind_ord[i_list]];
+                }
 
-            } // end of else for left child propagation
+                counter++;
+            } //end of data leaf node check
 
-        } // end of non-leaf node check
+        } // end of else
 
-    }   // end of while loop ==> decoder stops
+        /* Path metrics relative to the best path, which the sort put first:
+         * the order is unchanged and the metrics stay bounded */
+        for (i_list = l - 1; i_list >= 0; i_list--)
+        {
+            PM[i_list] -= PM[0];
+        }
+    } // end of loop over leaves ==> decoder stops
 
     int temp_beta[N];
     int i_n;   
     int i_m = 0;
 
+    if (systematic)
+    {
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            for (i_m = 0; i_m < K; i_m++)
+            {
+                msg_cap[i_list*K + i_m] = beta[0][i_list*N + data_pos[i_m]];
+            }
+        }
+        return;
+    }
+
     for (i_list = 0; i_list < l; i_list++)
     {
         i_n = i_list*N;
@@ -516,153 +541,1840 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *L
     }
 }
 
-/* quickSort_int function for int data type */
-void quickSort_int(int arr[], int ind_ord[], int low, int high) 
+void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
 {
-    if (low < high) 
-    { 
-        int pi = partition_int(arr, ind_ord, low, high); 
-
-        quickSort_int(arr, ind_ord, low, pi - 1); 
-        quickSort_int(arr, ind_ord, pi + 1, high); 
-    } 
+    scl_unrolled(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap, 0);
 }
 
-/* swap function for integer data type */
-void swap_int(int* a, int* b) 
-{ 
-    int t = *a; 
-    *a = *b; 
-    *b = t; 
+void decode_unrolled_sys(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
+{
+    scl_unrolled(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap, 1);
 }
 
-/* Partition function for integer data type */
-int partition_int(int arr[], int ind_ord[], int low, int high) 
-{ 
-    int pivot = arr[high]; 
-    int i = (low - 1);
-  
-    int j = low;
-    for (j = low; j <= high - 1; j++) 
-    { 
-        if (arr[j] <= pivot) 
-        { 
-            i++; 
-            swap_int(&arr[i], &arr[j]);
-            swap_int(&ind_ord[i], &ind_ord[j]);
-        } 
-    } 
-    swap_int(&arr[i + 1], &arr[high]);
-    swap_int(&ind_ord[i + 1], &ind_ord[high]);
-    return (i + 1);
+/* Binary digits of i in str[0..n), most significant first */
+void dec2bin(int i, int *str, int n)
+{
+    int k = 0;
+    int j = n-1;
+
+    for (k = 0; k < n; k++)
+    {
+        str[k] = 0;
+    }
+
+    while (i > 0)
+    {
+        str[j] = i%2;
+        i = i/2;
+        j--;
+    }
 }
 
-/* Function to find position of minimum element in a vector */
-void min_pos(int l, int N, int* arr, int ind_min[])
+/* SCL Decoder with multi-bit leaves
+ *
+ * The tree of decode_unrolled() stops at depth n - log2(M): each leaf is a
+ * node of M bits. Every path enumerates the 2^k sub-codewords of a leaf with
+ * k information bits (dec2bin() of the candidate index, frozen bits 0,
+ * encode() of the M bits) with the metric of their disagreements with the
+ * node's beliefs, and the l best of the paths x 2^k candidates survive.
+ * Over a node this metric is the min-sum path metric of bit-by-bit SCL, so
+ * the list only gains from pruning once per leaf; there are N/M sequential
+ * decisions instead of N.
+ *
+ * M is 1, 2, 4 or 8 and divides N. Paths are distinct from the start (no
+ * duplicates while there are fewer than l), candidates of equal metric keep
+ * the order of decode_unrolled(). msg_cap gets l paths in metric order,
+ * the best one repeated while fewer than l exist. */
+void decode_multibit(int N, int K, int l, int M, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
 {
-    int min_val;
-    int i_list, i_N;
-    int temp = N/l;
+    int n = 0, m = 0, N_log = N, M_log = M;
+    while (N_log >>= 1) n++;
+    while (M_log >>= 1) m++;
+
+    /* Leaf depth */
+    int dl = n - m;
+
+    /* Beliefs */
+    int L[dl+1][l*N];
+    /* Decisions */
+    int beta[dl+1][l*N];
+    /* Orders of surviving decoders */
+    int ind_ord_mat[dl+1][l*N];
+
+    int i_list, i_L, i_N, i_up, j, c, t;
+    int node, depth, temp, turn;
+    int i_leaf;
+    int i_temp, i_temp_ord;
+    int ind_ord_temp[l], ind_ord_temp2[l];
+
+    int PM[l], PM_new[l];
+    int num_paths = 1, num_cand, num_new;
+    int sel_pm[l], sel_ind[l];
+    int k, pos_info[M], bits[M], u[M];
+    int cw[M << M];
+    int metric, lambda, pm, cur;
+
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        for (i_N = 0; i_N < N; i_N++)
+        {
+            L[0][i_N + i_list*N] = LLR_Q[i_N];
+        }
+        PM[i_list] = 0;
+    }
+
+    /* Leaf after leaf; i_leaf = N completes the root */
+    for (i_leaf = 0; i_leaf <= N; i_leaf += M)
+    {
+        turn = (i_leaf == 0) ? 0 : (int)sc_turn_depth((unsigned)i_leaf, (unsigned)n);
+
+        /* Propagate to parent nodes: the completed nodes that end at i_leaf */
+        for (depth = (i_leaf == 0) ? -1 : dl-1; depth >= turn; depth--)
+        {
+            temp = 1 << (n - depth);
+            node = (i_leaf >> (n - depth)) - 1;
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_temp[i_list] = ind_ord_mat[depth + 1][2*node + i_list*N];
+                ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
+            }
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[ind_ord_temp2[i_list]];
+            }
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = node*temp + i_list*N;
+                i_temp_ord = node*temp + ind_ord_temp2[i_list]*N;
+
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                    beta[depth][i_up + temp/2 + i_temp] = beta[depth+1][i_temp + temp/2 + i_up];
+                }
+            }
+        }
+
+        if (i_leaf == N) break;
+
+        /* Propagate to right child */
+        if (i_leaf > 0)
+        {
+            depth = turn - 1;
+            temp = 1 << (n - depth);
+            node = i_leaf >> (n - depth);
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+                i_temp_ord = ind_ord_mat[depth+1][2*node + i_list*N]*N;
+
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node*temp + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
+                }
+            }
+        }
+
+        /* Propagate to left child, down to the leaf */
+        for (depth = turn; depth < dl; depth++)
+        {
+            temp = 1 << (n - depth);
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                }
+            }
+        }
+
+        /* Leaf node: the sub-codewords of its information bits */
+        node = i_leaf >> m;
+        k = 0;
+        for (j = 0; j < M; j++)
+        {
+            if (info_nodes[i_leaf + j])
+            {
+                pos_info[k++] = j;
+            }
+        }
+        for (c = 0; c < (1 << k); c++)
+        {
+            dec2bin(c, bits, k);
+            for (j = 0; j < M; j++)
+            {
+                u[j] = 0;
+            }
+            for (t = 0; t < k; t++)
+            {
+                u[pos_info[t]] = bits[t];
+            }
+            encode(u, M);
+            for (j = 0; j < M; j++)
+            {
+                cw[c*M + j] = u[j];
+            }
+        }
+
+        /* The l best of candidate c of path i_list, c-major as
+         * decode_unrolled() orders them; a tie keeps the earlier one */
+        num_cand = num_paths << k;
+        num_new = (num_cand < l) ? num_cand : l;
+        cur = 0;
+        for (c = 0; c < (1 << k); c++)
+        {
+            for (i_list = 0; i_list < num_paths; i_list++)
+            {
+                metric = 0;
+                for (j = 0; j < M; j++)
+                {
+                    lambda = L[dl][j + i_list*N];
+                    if (cw[c*M + j] != (lambda < 0))
+                    {
+                        metric += absl_macro(lambda);
+                    }
+                }
+                pm = PM[i_list] + metric;
+                if (cur == num_new && pm >= sel_pm[num_new - 1])
+                {
+                    continue;
+                }
+                t = (cur < num_new) ? cur++ : num_new - 1;
+                while (t > 0 && sel_pm[t - 1] > pm)
+                {
+                    sel_pm[t] = sel_pm[t - 1];
+                    sel_ind[t] = sel_ind[t - 1];
+                    t--;
+                }
+                sel_pm[t] = pm;
+                sel_ind[t] = c*num_paths + i_list;
+            }
+        }
+
+        /* Survivors in metric order; slots beyond them follow the best */
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            t = (i_list < num_new) ? i_list : 0;
+            c = sel_ind[t] / num_paths;
+            PM_new[i_list] = sel_pm[t];
+            ind_ord_mat[dl][node + i_list*N] = sel_ind[t] % num_paths;
+            for (j = 0; j < M; j++)
+            {
+                beta[dl][i_leaf + j + i_list*N] = cw[c*M + j];
+            }
+        }
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            PM[i_list] = PM_new[i_list];
+        }
+        num_paths = num_new;
+    }
+
+    /* Information bits of each path from the root's codeword */
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        int temp_beta[N];
+        t = (i_list < num_paths) ? i_list : 0;
+
+        for (i_N = 0; i_N < N; i_N++)
+        {
+            temp_beta[i_N] = beta[0][t*N + i_N];
+        }
+        encode(temp_beta, N);
+        for (j = 0; j < K; j++)
+        {
+            msg_cap[i_list*K + j] = temp_beta[data_pos[j]];
+        }
+    }
+}
+
+/* f_macro without the sign products: the same values, in a form that
+ * compiles to abs/min/sign-select vector instructions */
+static inline int f_minsum(int L1, int L2)
+{
+    int m = mini_macro(abs(L1), abs(L2));
+
+    return ((L1 ^ L2) < 0) ? -m : m;
+}
+
+/* g_macro with the decision as a mask m = -u (0 or -1): a conditional
+ * negation, without the multiply */
+static inline int g_minsum(int m, int L1, int L2)
+{
+    return ((L1 ^ m) - m) + L2;
+}
+
+/* Bits [p, p+len) of a packed decision vector, len <= 64 and p a multiple
+ * of len, so that the field never crosses a word */
+static inline uint64_t bits_get(const uint64_t *w, int p, int len)
+{
+    uint64_t v = w[p >> 6] >> (p & 63);
+
+    return (len == 64) ? v : (v & ((1ULL << len) - 1));
+}
+
+/* Writes v to bits [p, p+len) of a packed decision vector, as bits_get() */
+static inline void bits_put(uint64_t *w, int p, int len, uint64_t v)
+{
+    uint64_t mask = (len == 64) ? ~0ULL : (((1ULL << len) - 1) << (p & 63));
+
+    w[p >> 6] = (w[p >> 6] & ~mask) | ((v << (p & 63)) & mask);
+}
+
+/* SCL Decoder, list-major (path-interleaved) layout
+ *
+ * Same decoder as decode_unrolled(), bit for bit, with a working set sized
+ * to what the depth-first traversal actually keeps alive:
+ *
+ * - Beliefs of the l paths are interleaved per index, L[i*l + i_list], and
+ *   depth d only holds its current node, 2^(n-d) rows. Every f/g is one flat
+ *   loop over temp/2*l contiguous values that vectorizes across the paths,
+ *   also near the leaves where a node has only 1-8 beliefs per path.
+ * - Decisions are packed bits, one vector per path. Depth d holds both
+ *   children of the current parent, 2^(n-d+1) bits, so the partial sum
+ *   combine is a word-wide XOR (or one masked field for nodes below 64 bits)
+ *   and a path copy is the choice of the source path's words.
+ * - Survivor orders are uint8_t, and only the two children of the current
+ *   parent are kept per depth.
+ *
+ * A path copy of beliefs is a permutation by ind_ord inside each row of l
+ * values, and is skipped when no path moved. For N = 1024, l = 16 the three
+ * arrays take 135 KB instead of the 2.1 MB of decode_unrolled(). The
+ * systematic flag is that of scl_unrolled(). */
+static inline void scl_interleaved(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap, int systematic)
+{
+    int n = 0, N_log = N, l0_log = l, ln = 0;
+    /* log function */
+    while (N_log >>= 1) n++;
+    while (l0_log >>= 1) ln++;
+
+    /* Offsets of the depths in the belief and decision arrays */
+    int L_off[n+2];
+    int beta_bits[n+1];
+    int beta_words[n+1];
+    int beta_off[n+2];
+    int d;
+
+    L_off[0] = 0;
+    beta_off[0] = 0;
+    for (d = 0; d <= n; d++)
+    {
+        L_off[d+1] = L_off[d] + (1 << (n - d))*l;
+
+        beta_bits[d] = (d == 0) ? N : (2 << (n - d));
+        beta_words[d] = (beta_bits[d] + 63) >> 6;
+        beta_off[d+1] = beta_off[d] + beta_words[d]*l;
+    }
+
+    /* Beliefs, L[L_off[depth] + i*l + i_list] */
+    int L[L_off[n+1]];
+    /* Decisions, bit i of the words at beta[beta_off[depth] + i_list*beta_words[depth]] */
+    uint64_t beta[beta_off[n+1]];
+    /* Orders of surviving decoders, ind_ord_mat[depth][(node & 1)*l + i_list] */
+    uint8_t ind_ord_mat[n+1][2*l];
+
+    /* Propagation Parameters */
+    int i_list;
+    int i_L;
+    int i_N;
+    int node = 0;
+    int depth = 0;
+    int i_leaf;
+    int temp = 0;
+    int node_type_ind;
+
+    int ind_ord[2*l];
+    int ind_ord_l[l];
+    int codeword[l];
+    int codeword_temp[2*l];
+    int PM[l];
+    int PM_temp[2*l];
+    /* Decisions of the left child, unpacked to masks for g */
+    int u[64*l];
+
+    int start_ind, end_ind;
+    int del;
+    int base;
+    int i_s;
+    int i_g;
+    int i_sg;
+
+    /* Belief initialization */
+    for (i_N = 0; i_N < N; i_N++)
+    {
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            L[i_N*l + i_list] = LLR_Q[i_N];
+        }
+    }
+
+    /* Initializing Path Metrics */
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        PM[i_list] = 0;
+    }
+
+    /* Variable to count no. of decoded data bits */
+    int counter = 0;
+
+    /* Leaf after leaf (see sc_schedule.h); i_leaf = N completes the root */
+    for (i_leaf = 0; i_leaf <= N; i_leaf++)
+    {
+        /* Depth of the right child to continue from, root for leaf 0 */
+        int turn = (i_leaf == 0) ? 0 : (int)sc_turn_depth((unsigned)i_leaf, (unsigned)n);
+
+        /* Propogate to parent nodes: the completed nodes that end at i_leaf */
+        for (depth = (i_leaf == 0) ? -1 : n-1; depth >= turn; depth--)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
+
+            /* Current node and its index in node_type vector */
+            node = (i_leaf >> (n - depth)) - 1;
+            node_type_ind = node*temp;
+
+            /* Length of one child, and its decisions in the vectors of its depth */
+            int h = temp/2;
+            int p_left = node_type_ind & (beta_bits[depth + 1] - 1);
+            uint64_t *beta_child = &beta[beta_off[depth + 1]];
+            int w_child = beta_words[depth + 1];
+
+            uint8_t *ord_left = ind_ord_mat[depth + 1];
+            uint8_t *ord_right = ind_ord_mat[depth + 1] + l;
+            int p_out = node_type_ind & (beta_bits[depth] - 1);
+            int i_w;
+
+            /* Final Order of surviving decoders to be passed to parent node */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_mat[depth][(node & 1)*l + i_list] = ord_left[ord_right[i_list]];
+            }
+
+            /* Updating beta to be passed to parent node: left ^ right, right */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                uint64_t *b_left = &beta_child[ord_right[i_list]*w_child];
+                uint64_t *b_right = &beta_child[i_list*w_child];
+                uint64_t *b_out = &beta[beta_off[depth] + i_list*beta_words[depth]];
+
+                if (h >= 64)
+                {
+                    b_left += p_left >> 6;
+                    b_right += (p_left + h) >> 6;
+                    b_out += p_out >> 6;
+
+                    for (i_w = 0; i_w < h >> 6; i_w++)
+                    {
+                        b_out[i_w] = b_left[i_w] ^ b_right[i_w];
+                        b_out[i_w + (h >> 6)] = b_right[i_w];
+                    }
+                }
+                else
+                {
+                    uint64_t f_left = bits_get(b_left, p_left, h);
+                    uint64_t f_right = bits_get(b_right, p_left + h, h);
+
+                    bits_put(b_out, p_out, temp, (f_left ^ f_right) | (f_right << h));
+                }
+            }
+        } // end of parent node propagation
+
+        if (i_leaf == N) break;
+
+        /* Propogate to right child */
+        if (i_leaf > 0)
+        {
+            depth = turn - 1;
+
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
+
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
+
+            /* Number of beliefs of one child per path, and for all paths */
+            int h = temp/2;
+            int half = h*l;
+            /* Decisions of the children in the vectors of their depth */
+            int p_left = node_type_ind & (beta_bits[depth + 1] - 1);
+            uint64_t *beta_child = &beta[beta_off[depth + 1]];
+            int w_child = beta_words[depth + 1];
+
+            int *L_in = &L[L_off[depth]];
+            int *L_out = &L[L_off[depth + 1]];
+            uint8_t *ord = ind_ord_mat[depth + 1];
+            int moved = 0;
+            int i_c, len, i_r;
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                moved |= (ord[i_list] != i_list);
+            }
+
+            /* g_minsum and storage, 64 rows of left decisions at a time */
+            len = mini_macro(64, h);
+
+            for (i_c = 0; i_c < half; i_c += len*l)
+            {
+                /* Unpacking the decisions to masks in the layout of the beliefs */
+                for (i_list = 0; i_list < l; i_list++)
+                {
+                    uint64_t w = bits_get(&beta_child[i_list*w_child], p_left + i_c/l, len);
+
+                    for (i_r = 0; i_r < len; i_r++)
+                    {
+                        u[i_r*l + i_list] = -(int)((w >> i_r) & 1);
+                    }
+                }
+
+                if (!moved)
+                {
+                    for (i_L = 0; i_L < len*l; i_L++)
+                    {
+                        L_out[i_c + i_L] = g_minsum(u[i_L], L_in[i_c + i_L], L_in[i_c + i_L + half]);
+                    }
+                }
+                else
+                {
+                    /* Surviving paths take the beliefs of their parent path */
+                    for (i_r = 0; i_r < len*l; i_r += l)
+                    {
+                        i_L = i_c + i_r;
+
+                        for (i_list = 0; i_list < l; i_list++)
+                        {
+                            L_out[i_L + i_list] = g_minsum(u[i_r + i_list], L_in[i_L + ord[i_list]], L_in[i_L + half + ord[i_list]]);
+                        }
+                    }
+                }
+            }
+        } // end of right child propogation
+
+        /* Propogate to left child, down to the leaf */
+        for (depth = turn; depth < n; depth++)
+        {
+            /* Length of current sub-vector */
+            temp = 1 << (n - depth);
+
+            /* Current node and its index in node_type vector */
+            node = i_leaf >> (n - depth);
+            node_type_ind = node*temp;
+
+            /* Number of beliefs of one child, all paths */
+            int half = (temp/2)*l;
+
+            int *L_in = &L[L_off[depth]];
+            int *L_out = &L[L_off[depth + 1]];
+
+            /* f_minsum and storage, all paths at once */
+            for (i_L = 0; i_L < half; i_L++)
+            {
+                L_out[i_L] = f_minsum(L_in[i_L], L_in[i_L + half]);
+            }
+        } // end of left child propogation
+
+        /* Leaf node */
+        depth = n;
+        temp = 1;
+        node = i_leaf;
+        node_type_ind = i_leaf;
+
+        /* Beliefs of the leaf, one per path */
+        int *L_leaf = &L[L_off[depth]];
+        /* Decision bit of the leaf in the vectors of its depth */
+        int p_leaf = node_type_ind & (beta_bits[depth] - 1);
+        int bit[l];
+
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            ind_ord_l[i_list] = i_list;
+        }
+
+        if ( info_nodes[node_type_ind] == 0 )
+        {
+            /* Assigning 0 to decoded bits and updating path metrics */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                bit[i_list] = 0;
+
+                ( L_leaf[i_list] < 0 ) ? ( PM[i_list] = PM[i_list] - L_leaf[i_list] ) : 1 ;
+            }
+
+            /* Sorting the Path Metrics -- Insertion Sort */
+            insertionSort(PM, ind_ord_l, l);
+        } // end of frozen leaf node check
+
+        else if (counter > ln - 1)
+        {
+            /* Forking into Path 0 and Path 1 */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                codeword_temp[i_list] = 0;
+                codeword_temp[i_list + l] = 1;
+
+                PM_temp[i_list] = PM[i_list];
+                PM_temp[i_list + l] = PM[i_list];
+
+                if ( L_leaf[i_list] < 0 )
+                {
+                    PM_temp[i_list] = PM_temp[i_list] - L_leaf[i_list];
+                }
+                if ( L_leaf[i_list] > 0 )
+                {
+                    PM_temp[i_list + l] = PM_temp[i_list + l] + L_leaf[i_list];
+                }
+            }
+
+            for (i_list = 0; i_list < 2*l; i_list++)
+            {
+                ind_ord[i_list] = i_list;
+            }
+
+            /* Sorting the Path Metrics -- Insertion Sort */
+            insertionSort(PM_temp, ind_ord, 2*l);
+
+            /* The l best paths survive */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                PM[i_list] = PM_temp[i_list];
+                bit[i_list] = codeword_temp[ind_ord[i_list]];
+                ind_ord_l[i_list] = ind_ord[i_list]%l;
+            }
+
+            counter++;
+        } // end of normal data leaf node check
+
+        else
+        {
+            int init;
+
+            /* The first ln data bits take all 2^ln values */
+            if (counter > 0)
+            {
+                for (init = 0; init < 2*counter; init++)
+                {
+                    start_ind = 0 + init*(l/(2*counter)); end_ind = start_ind + l/(4*counter);
+
+                    for (i_list = start_ind; i_list < end_ind; i_list++)
+                    {
+                        codeword[i_list] = 0;
+                    }
+                    start_ind = end_ind; end_ind = start_ind + l/(4*counter);
+
+                    for (i_list = start_ind; i_list < end_ind; i_list++)
+                    {
+                        codeword[i_list] = 1;
+                    }
+                }
+            }
+
+            else
+            {
+                for (i_list = 0; i_list < l/2; i_list++)
+                {
+                    codeword[i_list] = 0;
+                }
+                for (i_list = l/2; i_list < l; i_list++)
+                {
+                    codeword[i_list] = 1;
+                }
+            }
+
+            /* Updating the Path Metric */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                if (codeword[i_list] != (L_leaf[i_list] < 0))
+                {
+                    PM[i_list] = PM[i_list] + absl_macro(L_leaf[i_list]);
+                }
+            }
+
+            /* Sorting the Path Metrics */
+            insertionSort(PM, ind_ord_l, l);
+
+            /* Re-ordering the estimated vector */
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                bit[i_list] = codeword[ind_ord_l[i_list]];
+            }
+
+            counter++;
+        } //end of data leaf node check
+
+        /* New ordering and decisions */
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            ind_ord_mat[depth][(node & 1)*l + i_list] = (uint8_t)ind_ord_l[i_list];
+
+            bits_put(&beta[beta_off[depth] + i_list*beta_words[depth]], p_leaf, 1, (uint64_t)bit[i_list]);
+        }
+
+        /* Path metrics relative to the best path, which the sort put first:
+         * the order is unchanged and the metrics stay bounded */
+        for (i_list = l - 1; i_list >= 0; i_list--)
+        {
+            PM[i_list] -= PM[0];
+        }
+    } // end of loop over leaves ==> decoder stops
+
+    int temp_beta[N];
+    int i_n;
+    int i_m = 0;
+
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        for (i_N = 0; i_N < N; i_N++)
+        {
+            temp_beta[i_N] = (int)(bits_get(&beta[i_list*beta_words[0]], i_N, 1));
+        }
+
+        if (systematic)
+        {
+            for (i_m = 0; i_m < K; i_m++)
+            {
+                msg_cap[i_list*K + i_m] = temp_beta[data_pos[i_m]];
+            }
+            continue;
+        }
+
+        /* encoding the decidions to get information at corresponding leaf nodes*/
+        for (i_s = 0; i_s < n; i_s++)
+        {
+            del = (1 << i_s);
+
+            /* Group after group in each stage */
+            for (i_g = 0; i_g < (1 << (n-i_s-1)); i_g++)
+            {
+                base = (del << 1)*i_g;
+
+                /* Sub group after sub group */
+                for (i_sg = 0; i_sg < del; i_sg++)
+                {
+                    temp_beta[base + i_sg] = temp_beta[base + i_sg]^temp_beta[base + i_sg + del];
+                }
+            }
+        }
+
+        i_n = i_list*K;
+        for(i_m = 0; i_m < K; i_m++)
+        {
+            msg_cap[i_n + i_m] = temp_beta[data_pos[i_m]];
+        }
+    }
+}
+
+void decode_interleaved(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
+{
+    scl_interleaved(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap, 0);
+}
+
+void decode_interleaved_sys(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap)
+{
+    scl_interleaved(N, K, l, info_nodes, data_pos, LLR_Q, msg_cap, 1);
+}
+
+/* SCL Decoder in narrow lanes: int8 beliefs, int16 path metrics
+ *
+ * decode_unrolled() with every belief an int8_t: f cannot grow, g saturates
+ * at +-MINSUM_I8_MAX (the clamped g_macro), so LLR_Q must lie within it.
+ * Path metrics are int16_t: renormalized at each leaf by subtracting the
+ * best one, they only hold the spread of the list, and an addition that
+ * would still overflow saturates at MINSUM_I16_MAX. Decisions and survivor
+ * orders are uint8_t, so l <= 256. Paths are distinct from the start and
+ * ties break as in decode_unrolled(); the arithmetic differs only where a
+ * belief or a metric saturates. msg_cap gets l paths in metric order, the
+ * best one repeated while fewer than l exist. */
+void decode_unrolled_i8(int N, int K, int l, int *info_nodes, int *data_pos, int8_t *LLR_Q, int *msg_cap)
+{
+    int n = 0, N_log = N;
+    while (N_log >>= 1) n++;
+
+    /* Beliefs */
+    int8_t L[n+1][l*N];
+    /* Decisions */
+    uint8_t beta[n+1][l*N];
+    /* Orders of surviving decoders */
+    uint8_t ind_ord_mat[n+1][l*N];
+
+    int i_list, i_L, i_N, i_up, j, c, t;
+    int node, depth, temp, turn;
+    int i_leaf;
+    int i_temp, i_temp_ord;
+    uint8_t ind_ord_temp[l], ind_ord_temp2[l];
+
+    int16_t PM[l];
+    int num_paths = 1, num_cand, num_new;
+    int sel_pm[l], sel_ind[l];
+    int lambda, pm, cur;
+
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        for (i_N = 0; i_N < N; i_N++)
+        {
+            L[0][i_N + i_list*N] = LLR_Q[i_N];
+        }
+        PM[i_list] = 0;
+    }
+
+    /* Leaf after leaf; i_leaf = N completes the root */
+    for (i_leaf = 0; i_leaf <= N; i_leaf++)
+    {
+        turn = (i_leaf == 0) ? 0 : (int)sc_turn_depth((unsigned)i_leaf, (unsigned)n);
+
+        /* Propagate to parent nodes: the completed nodes that end at i_leaf */
+        for (depth = (i_leaf == 0) ? -1 : n-1; depth >= turn; depth--)
+        {
+            temp = 1 << (n - depth);
+            node = (i_leaf >> (n - depth)) - 1;
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_temp[i_list] = ind_ord_mat[depth + 1][2*node + i_list*N];
+                ind_ord_temp2[i_list] = ind_ord_mat[depth + 1][2*node + 1 + i_list*N];
+            }
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                ind_ord_mat[depth][node + i_list*N] = ind_ord_temp[ind_ord_temp2[i_list]];
+            }
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = node*temp + i_list*N;
+                i_temp_ord = node*temp + ind_ord_temp2[i_list]*N;
+
+                for (i_up = 0; i_up < temp/2; i_up++)
+                {
+                    beta[depth][i_up + i_temp] = beta[depth+1][i_up + i_temp_ord] ^ beta[depth+1][i_temp + temp/2 + i_up];
+                    beta[depth][i_up + temp/2 + i_temp] = beta[depth+1][i_temp + temp/2 + i_up];
+                }
+            }
+        }
+
+        if (i_leaf == N) break;
+
+        /* Propagate to right child */
+        if (i_leaf > 0)
+        {
+            depth = turn - 1;
+            temp = 1 << (n - depth);
+            node = i_leaf >> (n - depth);
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+                i_temp_ord = ind_ord_mat[depth+1][2*node + i_list*N]*N;
+
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = sat_i8(g_minsum(-beta[depth + 1][i_L + node*temp + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]));
+                }
+            }
+        }
+
+        /* Propagate to left child, down to the leaf */
+        for (depth = turn; depth < n; depth++)
+        {
+            temp = 1 << (n - depth);
+
+            for (i_list = 0; i_list < l; i_list++)
+            {
+                i_temp = i_list*N;
+
+                for (i_L = 0; i_L < temp/2; i_L++)
+                {
+                    L[depth + 1][i_L + i_temp] = (int8_t)f_minsum(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
+                }
+            }
+        }
+
+        /* Leaf node: the l best of decision c of path i_list, c-major as
+         * decode_unrolled() orders them; a tie keeps the earlier one */
+        num_cand = info_nodes[i_leaf] ? 2*num_paths : num_paths;
+        num_new = (num_cand < l) ? num_cand : l;
+        cur = 0;
+        for (c = 0; c < num_cand/num_paths; c++)
+        {
+            for (i_list = 0; i_list < num_paths; i_list++)
+            {
+                lambda = L[n][i_list*N];
+                pm = PM[i_list] + ((c != (lambda < 0)) ? absl_macro(lambda) : 0);
+                if (cur == num_new && pm >= sel_pm[num_new - 1])
+                {
+                    continue;
+                }
+                t = (cur < num_new) ? cur++ : num_new - 1;
+                while (t > 0 && sel_pm[t - 1] > pm)
+                {
+                    sel_pm[t] = sel_pm[t - 1];
+                    sel_ind[t] = sel_ind[t - 1];
+                    t--;
+                }
+                sel_pm[t] = pm;
+                sel_ind[t] = c*num_paths + i_list;
+            }
+        }
+
+        /* Survivors in metric order, relative to the best; slots beyond
+         * them follow the best */
+        for (i_list = 0; i_list < l; i_list++)
+        {
+            t = (i_list < num_new) ? i_list : 0;
+            PM[i_list] = sat_i16(sel_pm[t] - sel_pm[0]);
+            ind_ord_mat[n][i_leaf + i_list*N] = (uint8_t)(sel_ind[t] % num_paths);
+            beta[n][i_leaf + i_list*N] = (uint8_t)(sel_ind[t] / num_paths);
+        }
+        num_paths = num_new;
+    }
+
+    /* Information bits of each path from the root's codeword */
+    for (i_list = 0; i_list < l; i_list++)
+    {
+        int temp_beta[N];
+        t = (i_list < num_paths) ? i_list : 0;
+
+        for (i_N = 0; i_N < N; i_N++)
+        {
+            temp_beta[i_N] = beta[0][t*N + i_N];
+        }
+        encode(temp_beta, N);
+        for (j = 0; j < K; j++)
+        {
+            msg_cap[i_list*K + j] = temp_beta[data_pos[j]];
+        }
+    }
+}
+
+/* quickSort_int function for int data type */
+void quickSort_int(int arr[], int ind_ord[], int low, int high) 
+{
+    if (low < high) 
+    { 
+        int pi = partition_int(arr, ind_ord, low, high); 
+
+        quickSort_int(arr, ind_ord, low, pi - 1); 
+        quickSort_int(arr, ind_ord, pi + 1, high); 
+    } 
+}
+
+/* swap function for integer data type */
+void swap_int(int* a, int* b) 
+{ 
+    int t = *a; 
+    *a = *b; 
+    *b = t; 
+}
+
+/* Partition function for integer data type */
+int partition_int(int arr[], int ind_ord[], int low, int high) 
+{ 
+    int pivot = arr[high]; 
+    int i = (low - 1);
+  
+    int j = low;
+    for (j = low; j <= high - 1; j++) 
+    { 
+        if (arr[j] <= pivot) 
+        { 
+            i++; 
+            swap_int(&arr[i], &arr[j]);
+            swap_int(&ind_ord[i], &ind_ord[j]);
+        } 
+    } 
+    swap_int(&arr[i + 1], &arr[high]);
+    swap_int(&ind_ord[i + 1], &ind_ord[high]);
+    return (i + 1);
+}
+
+/* Function to find position of minimum element in a vector */
+void min_pos(int l, int N, int* arr, int ind_min[])
+{
+    int min_val;
+    int i_list, i_N;
+    int temp = N/l;
 
     for (i_list = 0; i_list < l; i_list++)
     {
-        ind_min[i_list] = 0;
-        min_val = absl_macro(arr[0 + i_list*temp]);
-        for (i_N = 1; i_N < temp; i_N++)
+        ind_min[i_list] = 0;
+        min_val = absl_macro(arr[0 + i_list*temp]);
+        for (i_N = 1; i_N < temp; i_N++)
+        {
+            if (absl_macro(arr[i_N + i_list*temp]) < min_val)
+            {
+                min_val = absl_macro(arr[i_N + i_list*temp]);
+                ind_min[i_list] = i_N;
+            }
+        }
+    }
+
+}
+
+void crcGen(int* msg, int K, int* polynomial, int m)
+{
+    int i;
+    int msg_copy[K];
+    for (i = 0; i < K; i++)
+    {
+        msg_copy[i] = msg[i];
+    }
+
+    int j;
+    for ( i = 0; i < K - m + 1; i++)
+    {
+        if ( msg_copy[i] != 0)
+        {
+            for ( j = 0; j <  m; j++)
+            {
+                msg_copy[i + j] = msg_copy[i + j] ^ polynomial[j];
+            }
+        }
+    }
+
+    for ( i = K - m; i < K; i++)
+    {
+        msg[i] = msg_copy[i];
+    }
+}
+
+void crcDet(int* msg_cap, int K, int l, int* polynomial, int m, int* crc_check)
+{
+    int il,i,j;
+    int sum;
+    int msg_copy[K];
+
+    for(il = 0; il < l; il++)
+    {
+        crc_check[il] = 0;
+
+        for (i = 0; i < K; i++)
+        {
+            msg_copy[i] = msg_cap[i + il*K];
+        }
+        
+        for ( i = 0; i < K - m + 1; i++)
+        {
+            if ( msg_copy[i] != 0)
+            {
+                for ( j = 0; j <  m; j++)
+                {
+                    msg_copy[i + j] = msg_copy[i + j] ^ polynomial[j];
+                }
+            }
+        }
+
+        sum = 0;
+        for ( i = K - m; i < K; i++)
+        {
+            sum += msg_copy[i];
+        }
+
+        if (sum > 0)
+        {
+            crc_check[il] = 1;
+        }
+    }
+}
+
+/* Function to sort an array using insertion sort*/
+void insertionSort(int arr[], int ind_ord[], int n) 
+{ 
+   int i_in, key_arr, key_ind, cur_index; 
+   for (i_in = 1; i_in < n; i_in++) 
+   { 
+       key_arr = arr[i_in];
+       key_ind = ind_ord[i_in]; 
+       cur_index = i_in-1; 
+
+       while (cur_index >= 0 && arr[cur_index] > key_arr) 
+       { 
+           arr[cur_index+1] = arr[cur_index];
+           ind_ord[cur_index+1] = ind_ord[cur_index];
+           cur_index = cur_index-1; 
+       } 
+       arr[cur_index+1] = key_arr;
+       ind_ord[cur_index+1] = key_ind;
+   } 
+}
+
+/* Parity-check (PC) polar codes, TS 38.212 5.3.1.2
+ *
+ * Besides the K information bits (CRC included), n_pc of the K + n_pc
+ * positions of Q_I carry parity bits: the n_pc - n_pc_wm least reliable
+ * ones, and n_pc_wm at the minimum row weight (2^popcount(i)) among the
+ * K most reliable, the most reliable of them on a tie. Q_I comes
+ * least reliable first, as the data_pos of the simulations. bit_type gets
+ * PC_FROZEN, PC_INFO or PC_PARITY per position. */
+void pc_construct(int N, int K, int n_pc, int n_pc_wm, int *Q_I, int *bit_type)
+{
+    int i, w, wm_pos, wm_weight;
+
+    for (i = 0; i < N; i++)
+    {
+        bit_type[i] = PC_FROZEN;
+    }
+    for (i = 0; i < K + n_pc; i++)
+    {
+        bit_type[Q_I[i]] = PC_INFO;
+    }
+    for (i = 0; i < n_pc - n_pc_wm; i++)
+    {
+        bit_type[Q_I[i]] = PC_PARITY;
+    }
+    if (n_pc_wm > 0)
+    {
+        wm_pos = -1;
+        wm_weight = N + 1;
+        for (i = n_pc; i < K + n_pc; i++)
+        {
+            w = 1 << __builtin_popcount((unsigned)Q_I[i]);
+            if (w <= wm_weight)
+            {
+                wm_weight = w;
+                wm_pos = Q_I[i];
+            }
+        }
+        bit_type[wm_pos] = PC_PARITY;
+    }
+}
+
+/* u of a PC polar code before encode(): the K bits of msg in natural order
+ * of their positions, each parity bit the y0 of the 5-bit cyclic register
+ * y0..y4 that every position shifts and every information bit updates */
+void pc_encode(int N, int *bit_type, int *msg, int *u)
+{
+    int i, k = 0;
+    int reg = 0;
+
+    for (i = 0; i < N; i++)
+    {
+        reg = pc_shift(reg);
+        if (bit_type[i] == PC_INFO)
+        {
+            u[i] = msg[k++];
+            reg ^= u[i];
+        }
+        else if (bit_type[i] == PC_PARITY)
+        {
+            u[i] = reg & 1;
+        }
+        else
+        {
+            u[i] = 0;
+        }
+    }
+}
+
+/* State of decode_pcscl(): per path, beliefs at depth d from pcscl_off(d)
+ * of a 2N row, the partial sums of the even and odd child at depth d in two
+ * such rows, the decided information bits and the parity register */
+typedef struct PcsclState
+{
+    int N, n, K, l;
+    int *bit_type;
+    int num_paths;
+    int k;
+    int *L, *B, *msg, *reg, *PM;
+    int *L_new, *B_new, *msg_new, *reg_new, *PM_new;
+} PcsclState;
+
+#define pcscl_off(s, d) (2*(s)->N - 2*((s)->N >> (d)))
+
+static void pcscl_swap(int **a, int **b)
+{
+    int *t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/* Leaf i of every path: frozen and parity bits follow from the path, an
+ * information bit forks it and the l best of the 2*num_paths survive */
+static void pcscl_leaf(PcsclState *s, int i)
+{
+    int N = s->N, K = s->K;
+    int off = pcscl_off(s, s->n);
+    int p, q, c, u, lambda, num_cand, num_new;
+    int cand[2*s->l], cand_pm[2*s->l];
+
+    for (p = 0; p < s->num_paths; p++)
+    {
+        s->reg[p] = pc_shift(s->reg[p]);
+    }
+
+    if (s->bit_type[i] != PC_INFO)
+    {
+        for (p = 0; p < s->num_paths; p++)
         {
-            if (absl_macro(arr[i_N + i_list*temp]) < min_val)
+            lambda = s->L[p*2*N + off];
+            u = (s->bit_type[i] == PC_PARITY) ? (s->reg[p] & 1) : 0;
+            if (u != (lambda < 0))
             {
-                min_val = absl_macro(arr[i_N + i_list*temp]);
-                ind_min[i_list] = i_N;
+                s->PM[p] += absl_macro(lambda);
             }
+            s->B[p*4*N + (i & 1)*2*N + off] = u;
         }
+        return;
+    }
+
+    /* Candidates 2p + u, sorted by metric; the sort keeps equal metrics in
+     * order */
+    num_cand = 2*s->num_paths;
+    for (c = 0; c < num_cand; c++)
+    {
+        p = c >> 1;
+        u = c & 1;
+        lambda = s->L[p*2*N + off];
+        cand[c] = c;
+        cand_pm[c] = s->PM[p] + ((u != (lambda < 0)) ? absl_macro(lambda) : 0);
     }
+    insertionSort(cand_pm, cand, num_cand);
+    num_new = (num_cand < s->l) ? num_cand : s->l;
 
+    for (q = 0; q < num_new; q++)
+    {
+        p = cand[q] >> 1;
+        u = cand[q] & 1;
+        memcpy(&s->L_new[q*2*N], &s->L[p*2*N], sizeof(int)*2*(size_t)N);
+        memcpy(&s->B_new[q*4*N], &s->B[p*4*N], sizeof(int)*4*(size_t)N);
+        memcpy(&s->msg_new[q*K], &s->msg[p*K], sizeof(int)*(size_t)s->k);
+        s->B_new[q*4*N + (i & 1)*2*N + off] = u;
+        s->msg_new[q*K + s->k] = u;
+        s->reg_new[q] = s->reg[p] ^ u;
+        s->PM_new[q] = cand_pm[q];
+    }
+    pcscl_swap(&s->L, &s->L_new);
+    pcscl_swap(&s->B, &s->B_new);
+    pcscl_swap(&s->msg, &s->msg_new);
+    pcscl_swap(&s->reg, &s->reg_new);
+    pcscl_swap(&s->PM, &s->PM_new);
+    s->num_paths = num_new;
+    s->k++;
 }
 
-void crcGen(int* msg, int K, int* polynomial, int m)
+/* Node i of depth d, depth first: f, left child, g, right child, combine */
+static void pcscl_node(PcsclState *s, int d, int i)
 {
-    int i;
-    int msg_copy[K];
-    for (i = 0; i < K; i++)
+    int N = s->N;
+    int half, j, p;
+    int *Lp, *Lc, *bl, *br, *out;
+
+    if (d == s->n)
     {
-        msg_copy[i] = msg[i];
+        pcscl_leaf(s, i);
+        return;
     }
+    half = N >> (d + 1);
 
-    int j;
-    for ( i = 0; i < K - m + 1; i++)
+    for (p = 0; p < s->num_paths; p++)
     {
-        if ( msg_copy[i] != 0)
+        Lp = &s->L[p*2*N + pcscl_off(s, d)];
+        Lc = &s->L[p*2*N + pcscl_off(s, d + 1)];
+        for (j = 0; j < half; j++)
         {
-            for ( j = 0; j <  m; j++)
-            {
-                msg_copy[i + j] = msg_copy[i + j] ^ polynomial[j];
-            }
+            Lc[j] = f_macro(Lp[j], Lp[j + half]);
         }
     }
+    pcscl_node(s, d + 1, 2*i);
 
-    for ( i = K - m; i < K; i++)
+    for (p = 0; p < s->num_paths; p++)
     {
-        msg[i] = msg_copy[i];
+        Lp = &s->L[p*2*N + pcscl_off(s, d)];
+        Lc = &s->L[p*2*N + pcscl_off(s, d + 1)];
+        bl = &s->B[p*4*N + pcscl_off(s, d + 1)];
+        for (j = 0; j < half; j++)
+        {
+            Lc[j] = g_macro(bl[j], Lp[j], Lp[j + half]);
+        }
+    }
+    pcscl_node(s, d + 1, 2*i + 1);
+
+    for (p = 0; p < s->num_paths; p++)
+    {
+        bl = &s->B[p*4*N + pcscl_off(s, d + 1)];
+        br = &s->B[p*4*N + 2*N + pcscl_off(s, d + 1)];
+        out = &s->B[p*4*N + (i & 1)*2*N + pcscl_off(s, d)];
+        for (j = 0; j < half; j++)
+        {
+            out[j] = bl[j] ^ br[j];
+            out[j + half] = br[j];
+        }
     }
 }
 
-void crcDet(int* msg_cap, int K, int l, int* polynomial, int m, int* crc_check)
+/* SCL Decoder for PC polar codes
+ *
+ * Parity bits are neither frozen nor decided: every path carries its own
+ * cyclic register, shifted at each leaf and updated by the information bits
+ * it decided, and a parity leaf takes the register's y0 with the path metric
+ * penalty of any other frozen bit that disagrees with its LLR. Paths are
+ * copied whole at each information bit, which is cheap at the PC code sizes
+ * (K <= 25, N <= 256 for UCI) and keeps the register with its path.
+ *
+ * msg_cap gets the K information bits of the l paths in natural order of
+ * their positions (as pc_encode() takes them), best metric first; with
+ * fewer than l paths the best one fills the rest. */
+void decode_pcscl(int N, int K, int l, int *bit_type, int *LLR_Q, int *msg_cap)
 {
-    int il,i,j;
-    int sum;
-    int msg_copy[K];
+    int n = 0;
+    int i, r, src;
+    int L[2][l*2*N], B[2][l*4*N], msg[2][l*K], reg[2][l], PM[2][l];
+    int ord[l];
+    PcsclState s;
+
+    while ((1 << n) < N) n++;
+
+    s.N = N;
+    s.n = n;
+    s.K = K;
+    s.l = l;
+    s.bit_type = bit_type;
+    s.num_paths = 1;
+    s.k = 0;
+    s.L = L[0];
+    s.B = B[0];
+    s.msg = msg[0];
+    s.reg = reg[0];
+    s.PM = PM[0];
+    s.L_new = L[1];
+    s.B_new = B[1];
+    s.msg_new = msg[1];
+    s.reg_new = reg[1];
+    s.PM_new = PM[1];
+
+    for (i = 0; i < N; i++)
+    {
+        s.L[i] = LLR_Q[i];
+    }
+    s.reg[0] = 0;
+    s.PM[0] = 0;
 
-    for(il = 0; il < l; il++)
+    pcscl_node(&s, 0, 0);
+
+    for (r = 0; r < s.num_paths; r++)
     {
-        crc_check[il] = 0;
+        ord[r] = r;
+    }
+    insertionSort(s.PM, ord, s.num_paths);
+    for (r = 0; r < l; r++)
+    {
+        src = ord[(r < s.num_paths) ? r : 0];
+        memcpy(&msg_cap[r*K], &s.msg[src*K], sizeof(int)*(size_t)K);
+    }
+}
 
-        for (i = 0; i < K; i++)
+/* State of decode_scs(): P = D + 2 path slots (the stack, the path being
+ * extended and its fork). A slot holds one buffer id per depth for its
+ * beliefs and for its partial sums; buffers are shared between slots and
+ * reference counted, and a slot writes to a shared buffer only after taking
+ * a copy (copy-on-write). Beliefs of depth d are the N >> d of the current
+ * node, partial sums of depth d >= 1 the 2*(N >> d) of both children of the
+ * current parent, as in decode_interleaved(). */
+typedef struct ScsPool
+{
+    int *mem, *off, *size;
+    int *ref, *free_ids, *num_free;
+} ScsPool;
+
+typedef struct ScsState
+{
+    int N, n, P, D;
+    ScsPool L, U;
+    int *L_id, *U_id, *PM, *len;
+    int *free_slots, num_free_slots;
+    int *stk, num_stk;
+    int *seq, num_pushed;
+    int ops;
+} ScsState;
+
+static int *scs_take(int **mem, int count)
+{
+    int *r = *mem;
+    *mem += count;
+    return r;
+}
+
+/* Buffers of b->size[d] ints, P per depth, all free */
+static void scs_pool_init(ScsPool *b, int n, int P, int **mem)
+{
+    int d, id, total = 0;
+
+    b->off = scs_take(mem, n + 1);
+    for (d = 0; d <= n; d++)
+    {
+        b->off[d] = total;
+        total += P*b->size[d];
+    }
+    b->mem = scs_take(mem, total);
+    b->ref = scs_take(mem, (n + 1)*P);
+    b->free_ids = scs_take(mem, (n + 1)*P);
+    b->num_free = scs_take(mem, n + 1);
+    for (d = 0; d <= n; d++)
+    {
+        for (id = 0; id < P; id++)
         {
-            msg_copy[i] = msg_cap[i + il*K];
+            b->ref[d*P + id] = 0;
+            b->free_ids[d*P + id] = P - 1 - id;
         }
-        
-        for ( i = 0; i < K - m + 1; i++)
+        b->num_free[d] = P;
+    }
+}
+
+static int *scs_buf(ScsPool *b, int d, int id)
+{
+    return &b->mem[b->off[d] + id*b->size[d]];
+}
+
+static int scs_alloc(ScsState *s, ScsPool *b, int d)
+{
+    int id = b->free_ids[d*s->P + --b->num_free[d]];
+
+    b->ref[d*s->P + id] = 1;
+    return id;
+}
+
+static void scs_release(ScsState *s, ScsPool *b, int d, int id)
+{
+    if (--b->ref[d*s->P + id] == 0)
+    {
+        b->free_ids[d*s->P + b->num_free[d]++] = id;
+    }
+}
+
+/* Buffer d of ids for writing: a shared one is replaced by a private one,
+ * which gets its contents if keep */
+static int *scs_write(ScsState *s, ScsPool *b, int *ids, int d, int keep)
+{
+    int id = ids[d];
+
+    if (b->ref[d*s->P + id] > 1)
+    {
+        ids[d] = scs_alloc(s, b, d);
+        b->ref[d*s->P + id]--;
+        if (keep)
         {
-            if ( msg_copy[i] != 0)
+            memcpy(scs_buf(b, d, ids[d]), scs_buf(b, d, id), sizeof(int)*(size_t)b->size[d]);
+        }
+    }
+    return scs_buf(b, d, ids[d]);
+}
+
+static void scs_drop(ScsState *s, int p)
+{
+    int d;
+
+    for (d = 0; d <= s->n; d++)
+    {
+        scs_release(s, &s->L, d, s->L_id[p*(s->n + 1) + d]);
+        scs_release(s, &s->U, d, s->U_id[p*(s->n + 1) + d]);
+    }
+    s->free_slots[s->num_free_slots++] = p;
+}
+
+/* A second slot sharing every buffer of p */
+static int scs_fork(ScsState *s, int p)
+{
+    int d, q = s->free_slots[--s->num_free_slots];
+    int w = s->n + 1;
+
+    for (d = 0; d <= s->n; d++)
+    {
+        s->L_id[q*w + d] = s->L_id[p*w + d];
+        s->U_id[q*w + d] = s->U_id[p*w + d];
+        s->L.ref[d*s->P + s->L_id[q*w + d]]++;
+        s->U.ref[d*s->P + s->U_id[q*w + d]]++;
+    }
+    s->PM[q] = s->PM[p];
+    s->len[q] = s->len[p];
+    return q;
+}
+
+/* The stack is a min-max heap of slots (Atkinson et al.): the best path at
+ * the root, the worst among its children, both taken in O(log D). Paths
+ * compare by metric, and on a tie the one pushed last is the better, so
+ * that the search goes on depth first. */
+static int scs_better(ScsState *s, int a, int b)
+{
+    return s->PM[a] < s->PM[b] || (s->PM[a] == s->PM[b] && s->seq[a] > s->seq[b]);
+}
+
+static int scs_min_level(int i)
+{
+    return ((31 - __builtin_clz((unsigned)(i + 1))) & 1) == 0;
+}
+
+static void scs_swap(int *h, int i, int j)
+{
+    int t = h[i];
+    h[i] = h[j];
+    h[j] = t;
+}
+
+/* Entry i towards the root among the levels of its kind; best selects the
+ * min levels */
+static void scs_bubble_up(ScsState *s, int i, int best)
+{
+    int *h = s->stk;
+    int g;
+
+    while (i > 2)
+    {
+        g = ((i - 1)/2 - 1)/2;
+        if (scs_better(s, h[i], h[g]) != best)
+        {
+            break;
+        }
+        scs_swap(h, i, g);
+        i = g;
+    }
+}
+
+static void scs_heap_up(ScsState *s, int i)
+{
+    int *h = s->stk;
+    int parent, min_level;
+
+    if (i == 0)
+    {
+        return;
+    }
+    parent = (i - 1)/2;
+    min_level = scs_min_level(i);
+    if (scs_better(s, h[parent], h[i]) == min_level)
+    {
+        scs_swap(h, i, parent);
+        scs_bubble_up(s, parent, !min_level);
+    }
+    else
+    {
+        scs_bubble_up(s, i, min_level);
+    }
+}
+
+/* Entry i away from the root: the best (min level) or worst (max level)
+ * of its children and grandchildren takes its place */
+static void scs_heap_down(ScsState *s, int i)
+{
+    int *h = s->stk;
+    int n = s->num_stk;
+    int best = scs_min_level(i);
+    int c, m, last;
+
+    for (;;)
+    {
+        m = -1;
+        last = 4*i + 6;
+        for (c = 2*i + 1; c <= last && c < n; c = (c == 2*i + 2) ? 4*i + 3 : c + 1)
+        {
+            if (m < 0 || scs_better(s, h[c], h[m]) == best)
             {
-                for ( j = 0; j <  m; j++)
-                {
-                    msg_copy[i + j] = msg_copy[i + j] ^ polynomial[j];
-                }
+                m = c;
             }
         }
+        if (m < 0 || scs_better(s, h[m], h[i]) != best)
+        {
+            return;
+        }
+        scs_swap(h, i, m);
+        if (m <= 2*i + 2)
+        {
+            return;
+        }
+        if (scs_better(s, h[(m - 1)/2], h[m]) == best)
+        {
+            scs_swap(h, m, (m - 1)/2);
+        }
+        i = m;
+    }
+}
 
-        sum = 0;
-        for ( i = K - m; i < K; i++)
+/* Removes entry i, a root of its levels */
+static int scs_heap_take(ScsState *s, int i)
+{
+    int p = s->stk[i];
+
+    s->num_stk--;
+    if (i < s->num_stk)
+    {
+        s->stk[i] = s->stk[s->num_stk];
+        scs_heap_down(s, i);
+    }
+    return p;
+}
+
+static int scs_pop(ScsState *s)
+{
+    return scs_heap_take(s, 0);
+}
+
+/* A full stack drops its worst path for a better one, or refuses the new
+ * one */
+static void scs_push(ScsState *s, int p)
+{
+    int worst;
+
+    s->seq[p] = s->num_pushed++;
+    if (s->num_stk == s->D)
+    {
+        worst = 0;
+        if (s->num_stk > 1)
         {
-            sum += msg_copy[i];
+            worst = 1;
+        }
+        if (s->num_stk > 2 && scs_better(s, s->stk[1], s->stk[2]))
+        {
+            worst = 2;
         }
+        if (!scs_better(s, p, s->stk[worst]))
+        {
+            scs_drop(s, p);
+            return;
+        }
+        scs_drop(s, scs_heap_take(s, worst));
+    }
+    s->stk[s->num_stk] = p;
+    scs_heap_up(s, s->num_stk++);
+}
 
-        if (sum > 0)
+/* Partial sums of path p from the leaf before bit i up to depth */
+static void scs_combine(ScsState *s, int p, int i, int depth)
+{
+    int *Uid = &s->U_id[p*(s->n + 1)];
+    int d, j, h, o;
+    int *in, *out;
+
+    for (d = s->n - 1; d >= depth; d--)
+    {
+        h = s->N >> (d + 1);
+        o = (i - 2*h) & (s->U.size[d] - 1);
+        in = scs_buf(&s->U, d + 1, Uid[d + 1]);
+        out = scs_write(s, &s->U, Uid, d, o != 0);
+        for (j = 0; j < h; j++)
         {
-            crc_check[il] = 1;
+            out[o + j] = in[j] ^ in[j + h];
+            out[o + h + j] = in[j + h];
         }
     }
 }
 
-/* Function to sort an array using insertion sort*/
-void insertionSort(int arr[], int ind_ord[], int n) 
-{ 
-   int i_in, key_arr, key_ind, cur_index; 
-   for (i_in = 1; i_in < n; i_in++) 
-   { 
-       key_arr = arr[i_in];
-       key_ind = ind_ord[i_in]; 
-       cur_index = i_in-1; 
+/* LLR of leaf len[p] of path p: the g of the turn and the f below it, as
+ * Decode() of the SC decoder */
+static int scs_leaf_llr(ScsState *s, int p)
+{
+    int N = s->N, n = s->n, i = s->len[p];
+    int *Lid = &s->L_id[p*(n + 1)];
+    int d, j, h, depth = 0;
+    int *Lp, *Lc, *bl;
 
-       while (cur_index >= 0 && arr[cur_index] > key_arr) 
-       { 
-           arr[cur_index+1] = arr[cur_index];
-           ind_ord[cur_index+1] = ind_ord[cur_index];
-           cur_index = cur_index-1; 
-       } 
-       arr[cur_index+1] = key_arr;
-       ind_ord[cur_index+1] = key_ind;
-   } 
+    if (i > 0)
+    {
+        depth = (int)sc_turn_depth((unsigned)i, (unsigned)n);
+        scs_combine(s, p, i, depth);
+        h = N >> depth;
+        Lp = scs_buf(&s->L, depth - 1, Lid[depth - 1]);
+        bl = scs_buf(&s->U, depth, s->U_id[p*(n + 1) + depth]);
+        Lc = scs_write(s, &s->L, Lid, depth, 0);
+        for (j = 0; j < h; j++)
+        {
+            Lc[j] = g_macro(bl[j], Lp[j], Lp[j + h]);
+        }
+        s->ops += h;
+    }
+    for (d = depth; d < n; d++)
+    {
+        h = N >> (d + 1);
+        Lp = scs_buf(&s->L, d, Lid[d]);
+        Lc = scs_write(s, &s->L, Lid, d + 1, 0);
+        for (j = 0; j < h; j++)
+        {
+            Lc[j] = f_macro(Lp[j], Lp[j + h]);
+        }
+        s->ops += h;
+    }
+    return scs_buf(&s->L, n, Lid[n])[0];
+}
+
+/* Decision u at leaf len[p] of path p */
+static void scs_decide(ScsState *s, int p, int u)
+{
+    int i = s->len[p];
+
+    scs_write(s, &s->U, &s->U_id[p*(s->n + 1)], s->n, i & 1)[i & 1] = u;
+    s->len[p]++;
+}
+
+/* log2(N) */
+static int scs_log2(int N)
+{
+    int n = 0;
+
+    while ((1 << n) < N) n++;
+    return n;
+}
+
+/* (2N + 3N) ints of buffers per slot, with the ids and counts */
+static size_t scs_work_size(int N, int D)
+{
+    int n = scs_log2(N);
+    int P = D + 2;
+
+    return (size_t)P*(size_t)(5*N + 6*(n + 1) + 5) + (size_t)D + 6*(size_t)(n + 1);
+}
+
+/* Allocates the slot pool once, so that decode_scs() does not; 0, or -1 if
+ * out of memory */
+int scs_work_init(ScsWork *w, int N, int D)
+{
+    w->N = N;
+    w->D = D;
+    w->mem = malloc(sizeof(int)*scs_work_size(N, D));
+    return (w->mem == NULL) ? -1 : 0;
+}
+
+void scs_work_free(ScsWork *w)
+{
+    free(w->mem);
+    w->mem = NULL;
+}
+
+/* SC-Stack (SCS) Decoder
+ *
+ * Best-first search of the code tree: a stack of at most D partial paths
+ * sorted by path metric (the SCL penalty metric), of which only the best is
+ * extended. The popped path runs through the frozen bits to its next
+ * information bit and forks there, both children going back on the stack;
+ * at most l paths fork at each information bit, so the work is bounded by
+ * that of SCL with l paths. At high SNR the correct path stays on top and
+ * the decoder does the work of SC; it only backtracks when a decision costs
+ * more than the metric of a shorter path. Paths share the beliefs and
+ * partial sums of their common prefix (copy-on-write), so extending a
+ * popped path recomputes only the nodes below its turn, as SC does.
+ *
+ * The first path to reach length N that passes the CRC of crc_l bits (any
+ * path when crc_l is 0) gives msg_cap[K]; without one, the first complete
+ * path, or zeros if the stack ran out. The code length and the stack depth
+ * D are those of w (scs_work_init()). Returns the number of f and g
+ * evaluations, N*n for one SC decoding. */
+int decode_scs(ScsWork *w, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *polynomial, int crc_l, int *msg_cap)
+{
+    int N = w->N;
+    int D = w->D;
+    int n = scs_log2(N);
+    int P = D + 2;
+    int d, i, k, p, q, lambda, crc_check;
+    int found = 0;
+    int *mem = w->mem;
+    int count[N], u[N], msg[K];
+    ScsState s;
+
+    s.N = N;
+    s.n = n;
+    s.P = P;
+    s.D = D;
+    s.ops = 0;
+    s.num_stk = 0;
+    s.num_pushed = 0;
+
+    s.L.size = scs_take(&mem, n + 1);
+    s.U.size = scs_take(&mem, n + 1);
+    for (d = 0; d <= n; d++)
+    {
+        s.L.size[d] = N >> d;
+        s.U.size[d] = (d == 0) ? N : 2*(N >> d);
+    }
+    scs_pool_init(&s.L, n, P, &mem);
+    scs_pool_init(&s.U, n, P, &mem);
+    s.L_id = scs_take(&mem, P*(n + 1));
+    s.U_id = scs_take(&mem, P*(n + 1));
+    s.PM = scs_take(&mem, P);
+    s.len = scs_take(&mem, P);
+    s.free_slots = scs_take(&mem, P);
+    s.stk = scs_take(&mem, D);
+    s.seq = scs_take(&mem, P);
+    for (p = 0; p < P; p++)
+    {
+        s.free_slots[p] = P - 1 - p;
+    }
+    s.num_free_slots = P;
+    for (i = 0; i < N; i++)
+    {
+        count[i] = 0;
+    }
+
+    /* Root path */
+    p = s.free_slots[--s.num_free_slots];
+    for (d = 0; d <= n; d++)
+    {
+        s.L_id[p*(n + 1) + d] = scs_alloc(&s, &s.L, d);
+        s.U_id[p*(n + 1) + d] = scs_alloc(&s, &s.U, d);
+    }
+    memcpy(scs_buf(&s.L, 0, s.L_id[p*(n + 1)]), LLR_Q, sizeof(int)*(size_t)N);
+    s.PM[p] = 0;
+    s.len[p] = 0;
+    scs_push(&s, p);
+
+    while (s.num_stk > 0 && found < 2)
+    {
+        p = scs_pop(&s);
+        for (;;)
+        {
+            i = s.len[p];
+            if (i == N)
+            {
+                scs_combine(&s, p, N, 0);
+                memcpy(u, scs_buf(&s.U, 0, s.U_id[p*(n + 1)]), sizeof(int)*(size_t)N);
+                encode(u, N);
+                for (k = 0; k < K; k++)
+                {
+                    msg[k] = u[data_pos[k]];
+                }
+                crc_check = 0;
+                if (crc_l > 0)
+                {
+                    crcDet(msg, K, 1, polynomial, crc_l, &crc_check);
+                }
+                if (crc_check == 0 || found == 0)
+                {
+                    memcpy(msg_cap, msg, sizeof(int)*(size_t)K);
+                    found = (crc_check == 0) ? 2 : 1;
+                }
+                scs_drop(&s, p);
+                break;
+            }
+
+            lambda = scs_leaf_llr(&s, p);
+            if (!info_nodes[i])
+            {
+                s.PM[p] += (lambda < 0) ? -lambda : 0;
+                scs_decide(&s, p, 0);
+                continue;
+            }
+            if (count[i] >= l)
+            {
+                scs_drop(&s, p);
+                break;
+            }
+            count[i]++;
+
+            /* p takes 0 and q 1; 0 goes on top on a tie, as SC decides */
+            q = scs_fork(&s, p);
+            s.PM[p] += (lambda < 0) ? -lambda : 0;
+            s.PM[q] += (lambda > 0) ? lambda : 0;
+            scs_decide(&s, p, 0);
+            scs_decide(&s, q, 1);
+            scs_push(&s, q);
+            scs_push(&s, p);
+            break;
+        }
+    }
+
+    if (found == 0)
+    {
+        memset(msg_cap, 0, sizeof(int)*(size_t)K);
+    }
+    return s.ops;
 }
@@ -1,21 +1,64 @@
-int uni ();
-
-float randn (float mu, float sigma);
-
-void encode(int *u, int N);
-
-void swap_int(int* a, int* b);
-
-int partition_int (int arr[], int *ind_ord, int low, int high);
-
-void quickSort_int(int arr[], int *ind_ord, int low, int high);
-
-void insertionSort(int arr[], int ind_ord[], int n);
-
-void min_pos(int l, int N, int* arr, int ind_min[]);
-
-void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
-
-void crcGen(int* msg, int K, int* polynomial, int m);
-
-void crcDet(int* msg_cap, int K, int l, int* polynomial, int m, int* crc_check);
\ No newline at end of file
+#include <stdint.h>
+
+int uni ();
+
+float randn (float mu, float sigma);
+
+void encode(int *u, int N);
+
+void encode_sys(int *u, int N, int *info_nodes);
+
+void swap_int(int* a, int* b);
+
+int partition_int (int arr[], int *ind_ord, int low, int high);
+
+void quickSort_int(int arr[], int *ind_ord, int low, int high);
+
+void insertionSort(int arr[], int ind_ord[], int n);
+
+void min_pos(int l, int N, int* arr, int ind_min[]);
+
+void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
+
+void decode_unrolled_sys(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
+
+void dec2bin(int i, int *str, int n);
+
+void decode_multibit(int N, int K, int l, int M, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
+
+void decode_interleaved(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
+
+void decode_interleaved_sys(int N, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *msg_cap);
+
+void decode_unrolled_i8(int N, int K, int l, int *info_nodes, int *data_pos, int8_t *LLR_Q, int *msg_cap);
+
+void crcGen(int* msg, int K, int* polynomial, int m);
+
+void crcDet(int* msg_cap, int K, int l, int* polynomial, int m, int* crc_check);
+
+#define PC_FROZEN 0
+#define PC_INFO 1
+#define PC_PARITY 2
+
+/* One step of the PC cyclic register y0..y4 (bit 0 is y0) */
+#define pc_shift(reg) ((((reg) >> 1) | (((reg) & 1) << 4)))
+
+void pc_construct(int N, int K, int n_pc, int n_pc_wm, int *Q_I, int *bit_type);
+
+void pc_encode(int N, int *bit_type, int *msg, int *u);
+
+void decode_pcscl(int N, int K, int l, int *bit_type, int *LLR_Q, int *msg_cap);
+
+/* Slot pool of decode_scs() for codes of length N and a stack of D paths */
+typedef struct ScsWork
+{
+    int N;
+    int D;
+    int *mem;
+} ScsWork;
+
+int scs_work_init(ScsWork *w, int N, int D);
+
+void scs_work_free(ScsWork *w);
+
+int decode_scs(ScsWork *w, int K, int l, int *info_nodes, int *data_pos, int *LLR_Q, int *polynomial, int crc_l, int *msg_cap);
\ No newline at end of file
@@ -8,9 +8,18 @@
 #define maxi_macro(x, y) ((x < y) ? y : x)
 
 #include "functions_SSCD.h"
+#include "latency.h"
+#include "llr_trace.h"
+#include "pipeline_SSCD.h"
+#include "pmu.h"
+#include "prof.h"
+#include "reliability.h"
 
 int main() {
     // srand(time(NULL));
+    /* rand() seed, POLAR_SEED overrides it; goes into the LLR trace */
+    const unsigned seed = llr_trace_seed(1);
+    srand(seed);
 
     clock_t start, end;
     clock_t enc_start, enc_end;
@@ -129,6 +138,9 @@ int main() {
     /* Number of information bits */
     unsigned int K = (unsigned int)((float)N * rate);
 
+    /* Reliability sequence from the file POLAR_Q names (reliability.h) */
+    if (rel_order_env((int)N, Q) != 0) return EXIT_FAILURE;
+
     /* Boolean array with information nodes pos = 1 */
     int info_nodes[N];
 
@@ -214,95 +226,168 @@ int main() {
 
     /* Simulations */
 
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
+    /* Decoder threads of the pipelined simulation if POLAR_PIPELINE is set,
+     * else the serial loop */
+    const char *pipeline_env = getenv("POLAR_PIPELINE");
+    const int num_decoders = pipeline_env ? atoi(pipeline_env) : 0;
+
+    /* Systematic code (encode_sys, decode_sys) if POLAR_SYSTEMATIC is set */
+    const int systematic = getenv("POLAR_SYSTEMATIC") != NULL;
+
+    /* Frames to a binary LLR trace if POLAR_TRACE names a file */
+    LlrTraceWriter trace;
+    llr_trace_create(&trace,
+                     getenv("POLAR_TRACE"),
+                     LLR_TRACE_INT8,
+                     (int)N,
+                     (int)K,
+                     0,
+                     (int)maxqr,
+                     rmax,
+                     seed,
+                     data_pos);
+
     /* Simulations corresponding to each sig */
     for (unsigned int i_sig = 0; i_sig < num_EbN0dB; i_sig++) {
         printf("Count %d of %d\n", i_sig + 1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
 
         BER[i_sig] = 0;
 
         /* No. of errors corresponding to each sig over num_sim simulations */
 
-        /*Each Simulations*/
-        for (unsigned int i_num_sim = 0; i_num_sim < num_sim; i_num_sim++) {
-            /* Generating a uniformly distributed binary random vector for
-             * message */
-            int msg[K];
-            for (unsigned int i_msg = 0; i_msg < K; i_msg++) {
-                msg[i_msg] = uni();
+        /* Pipelined: stages on their own threads, see pipeline_SSCD.h */
+        if (num_decoders > 0) {
+            const SscdPoint pt = {N,
+                                  n,
+                                  K,
+                                  info_nodes,
+                                  data_pos,
+                                  node_type,
+                                  sig,
+                                  rmax,
+                                  maxqr,
+                                  EbN0dB[i_sig],
+                                  num_sim,
+                                  num_decoders,
+                                  &trace,
+                                  systematic};
+            SscdPointResult res;
+            if (sscd_pipeline_run(&pt, &lat, &res) != 0) {
+                fprintf(stderr, "cannot start the pipeline\n");
+                return EXIT_FAILURE;
             }
+            err_count = (int)res.bit_errors;
+            enc_cpu_time_used += (float)res.enc_ns * 1e-9f * CLOCKS_PER_SEC;
+            dec_cpu_time_used += (float)res.dec_ns * 1e-9f * CLOCKS_PER_SEC;
+        } else {
+            /*Each Simulations*/
+            for (unsigned int i_num_sim = 0; i_num_sim < num_sim; i_num_sim++) {
+                /* Generating a uniformly distributed binary random vector for
+                 * message */
+                int msg[K];
+                for (unsigned int i_msg = 0; i_msg < K; i_msg++) {
+                    msg[i_msg] = uni();
+                }
 
-            /* Encoding the Transmit vector */
-            enc_start = clock();
+                /* Encoding the Transmit vector */
+                enc_start = clock();
 
-            int u[N];
-            for (unsigned int i_uN = 0; i_uN < N; i_uN++) {
-                u[i_uN] = 0;
-            }
+                int u[N];
+                for (unsigned int i_uN = 0; i_uN < N; i_uN++) {
+                    u[i_uN] = 0;
+                }
 
-            /*Assigning data to data indices*/
-            for (unsigned int i_ud = 0; i_ud < K; i_ud++) {
-                u[data_pos[i_ud]] = msg[i_ud];
-            }
+                /*Assigning data to data indices*/
+                for (unsigned int i_ud = 0; i_ud < K; i_ud++) {
+                    u[data_pos[i_ud]] = msg[i_ud];
+                }
 
-            encode(u, (int)N);
+                if (systematic) {
+                    encode_sys(u, (int)N, info_nodes);
+                } else {
+                    encode(u, (int)N);
+                }
 
-            enc_end = clock();
+                enc_end = clock();
 
-            enc_cpu_time_used += (float)(enc_end - enc_start);
+                enc_cpu_time_used += (float)(enc_end - enc_start);
 
-            /* BPSK modulation and Adding Gaussian noise of zero mean and
-             * variance sigma^2 */
-            /* Energy per bit */
-            const float Eb = 1.0f;
-            float x[N];
-            float y[N];
+                /* BPSK modulation and Adding Gaussian noise of zero mean and
+                 * variance sigma^2 */
+                /* Energy per bit */
+                const float Eb = 1.0f;
+                float x[N];
+                float y[N];
 
-            for (unsigned int i_bpsk = 0; i_bpsk < N; i_bpsk++) {
-                x[i_bpsk] = sqrtf(Eb) * (float)(1 - 2 * u[i_bpsk]);
-                y[i_bpsk] = x[i_bpsk] + sig * randn(0, 1);
-            }
+                for (unsigned int i_bpsk = 0; i_bpsk < N; i_bpsk++) {
+                    x[i_bpsk] = sqrtf(Eb) * (float)(1 - 2 * u[i_bpsk]);
+                    y[i_bpsk] = x[i_bpsk] + sig * randn(0, 1);
+                }
 
-            /* Channel LLR calculation and Quantization of LLR values */
-            float LLR[N];
-            int LLR_Q[N];
-            for (unsigned int i_ch = 0; i_ch < N; i_ch++) {
-                // LLR[i_ch] = 2*y[i_ch]/(pow(sig,2));
-                LLR[i_ch] = y[i_ch];
-                LLR_Q[i_ch] = (int)floorf((LLR[i_ch]) / rmax * maxqr);
-                if (LLR_Q[i_ch] > maxqr) {
-                    LLR_Q[i_ch] = (int)maxqr;
-                } else if (LLR_Q[i_ch] < -(maxqr + 1)) {
-                    LLR_Q[i_ch] = -((int)maxqr + 1);
+                /* Channel LLR calculation and Quantization of LLR values */
+                float LLR[N];
+                int LLR_Q[N];
+                for (unsigned int i_ch = 0; i_ch < N; i_ch++) {
+                    // LLR[i_ch] = 2*y[i_ch]/(pow(sig,2));
+                    LLR[i_ch] = y[i_ch];
+                    LLR_Q[i_ch] = (int)floorf((LLR[i_ch]) / rmax * maxqr);
+                    if (LLR_Q[i_ch] > maxqr) {
+                        LLR_Q[i_ch] = (int)maxqr;
+                    } else if (LLR_Q[i_ch] < -(maxqr + 1)) {
+                        LLR_Q[i_ch] = -((int)maxqr + 1);
+                    }
                 }
-            }
 
-            /* Decoded message vector */
-            int msg_cap[K];
+                /* Decoded message vector */
+                int msg_cap[K];
+
+                llr_trace_write_int(&trace, EbN0dB[i_sig], LLR_Q, msg);
 
-            /* Successive Cancellation Decoding */
-            dec_start = clock();
+                /* Successive Cancellation Decoding */
+                dec_start = clock();
+                const uint64_t lat_start = lat_now_ns();
+                PMU_START();
 
-            decode(msg_cap, N, n, K, LLR_Q, info_nodes, data_pos, node_type);
+                (systematic ? decode_sys : decode)(msg_cap,
+                                                   N,
+                                                   n,
+                                                   K,
+                                                   LLR_Q,
+                                                   info_nodes,
+                                                   data_pos,
+                                                   node_type);
 
-            dec_end = clock();
+                PMU_STOP(K);
+                lat_record(&lat, lat_now_ns() - lat_start);
+                dec_end = clock();
 
-            dec_cpu_time_used += (float)(dec_end - dec_start);
+                dec_cpu_time_used += (float)(dec_end - dec_start);
 
-            /*Number of errors and BER*/
-            for (unsigned int i_err = 0; i_err < K; i_err++) {
-                if (msg_cap[i_err] != msg[i_err]) {
-                    err_count++;
+                /*Number of errors and BER*/
+                for (unsigned int i_err = 0; i_err < K; i_err++) {
+                    if (msg_cap[i_err] != msg[i_err]) {
+                        err_count++;
+                    }
                 }
-            }
 
-        }  // end of no. of simulations loop
+            }  // end of no. of simulations loop
+        }
 
         printf("EbN0dB %0.2f\t", EbN0dB[i_sig]);
         BER[i_sig] = (float)err_count / (float)(K * num_sim);
         printf("BER %lf\n", BER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     }  // end of noise var loop
 
@@ -330,5 +415,10 @@ int main() {
            ((float)(num_sim * num_EbN0dB * N / 1024)
             / (enc_cpu_time_used * 1000)));
 
+    PROF_REPORT("SSCD");
+
+    llr_trace_finish(&trace);
+    lat_print(stdout, "all points", &lat_all);
+
     return 0;
 }
\ No newline at end of file
@@ -4,17 +4,11 @@
 #include <time.h>
 
 #include "functions_SSCD.h"
+#include "kernels_SSCD.h"
+#include "sc_schedule.h"
 
-#define f_macro(L1, L2) \
-    sign_macro(L1) * sign_macro(L2) * mini_macro(absl_macro(L1), absl_macro(L2))
-#define maxqr 31
-#define g_macro(u, L1, L2) \
-    mini_macro(maxi_macro((((1 - 2 * u) * L1) + L2), -(maxqr + 1)), maxqr)
-// #define g_macro(u, L1, L2) (((1 - 2*u) * L1) + L2)
-#define absl_macro(x)    (((x > 0) - (x < 0)) * x)
-#define mini_macro(x, y) ((x < y) ? x : y)
-#define maxi_macro(x, y) ((x < y) ? y : x)
-#define sign_macro(x)    ((x > 0) - (x < 0))
+#define PROF_IMPLEMENTATION
+#include "prof.h"
 
 /*is_vec_mem function*/
 int is_vec_mem(int in, int Nt, int N, int *data_indices_sorted) {
@@ -174,202 +168,154 @@ void encode(int *u, int N) {
     }
 }
 
+/* Systematic encoder: u holds the message at the information positions and
+ * zeros elsewhere, and gets the codeword x with x[data_pos] = message. Two
+ * passes of encode() with the frozen positions zeroed in between, exact for
+ * information sets whose positions dominate each other as the reliability
+ * sequence of the simulations does */
+void encode_sys(int *u, int N, int *info_nodes) {
+    encode(u, N);
+    for (int i = 0; i < N; i++) {
+        u[i] = u[i] & (info_nodes[i] != 0);
+    }
+    encode(u, N);
+}
+
 #include <string.h>
 #define POW2(x) (1u << (x))
-/* SSC Decoder */
-void decode(int *msg_cap, unsigned int N, unsigned int n, unsigned int K, int *LLR_Q,
-            int *info_nodes, int *data_pos, int *node_type) {
+/* SSC Decoder, a straight loop over the leaves of the pruned tree (see
+ * sc_schedule.h): bits, and Rate-0, Rep, Rate-1 and SPC nodes. Systematic
+ * decoding (encode_sys() codes) combines the decisions up to the root and
+ * reads the codeword there, so no node re-encodes its bits for the leaves */
+static inline void ssc_decode(int *msg_cap, unsigned int N, unsigned int n, unsigned int K,
+                              int *LLR_Q, int *info_nodes, int *data_pos, int *node_type,
+                              const int systematic) {
     /* Beliefs */
     int L[n + 1][N];
 
     /* Decisions */
     int ucap[n + 1][N];
 
-    /* Node state vector */
-    int ns[2 * N - 1];
-    memset(ns, 0, (2 * N - 1) * sizeof(int));
-
     /* Belief initialisation */
     memcpy(L[0], LLR_Q, N * sizeof(int));
 
-    /* Propogation parameters */
-    unsigned int node = 0;
+    /* First bit and depth of the current leaf, depth of the previous one */
+    unsigned int node_type_ind = 0;
     unsigned int depth = 0;
-    int done = 0;
-    unsigned i_min;
+    unsigned int prev_depth = n;
 
-    /* Traverse till all bits are decoded */
-    while (done == 0) {
-        /* Position of node in node state vector */
-        unsigned int npos = POW2(depth) - 1 + node;
+    PROF_FRAME();
 
-        /* Length of current sub-vector */
-        unsigned int temp = POW2(n - depth);
+    while (node_type_ind < N) {
+        depth = 0;
 
-        /* Index of current node in node_type vector */
-        unsigned int node_type_ind = node * temp;
+        if (node_type_ind > 0) {
+            depth = sc_turn_depth(node_type_ind, n);
 
-        /* Check for leaf node */
-        if (depth == n) {
-            /* Check for frozen node and take decision */
-            ucap[n][node] = 0;
+            /* Combine the completed nodes that end at node_type_ind */
+            for (unsigned int d = prev_depth; d-- > depth;) {
+                PROF_START(t_c);
+                unsigned int half = POW2(n - d - 1);
+                unsigned int start = node_type_ind - 2 * half;
+                combine_vec(&ucap[d][start], &ucap[d + 1][start], half);
+                PROF_STOP(t_c, PROF_COMBINE, d);
+            }
 
-            if (info_nodes[node] != 0 && L[n][0] < 0) ucap[n][node] = 1;
+            /* g_minsum into the right child */
+            PROF_START(t_g);
+            unsigned int half = POW2(n - depth);
+            g_vec(L[depth], L[depth - 1], &ucap[depth][node_type_ind - half], half);
+            PROF_STOP(t_g, PROF_G, depth);
+        }
 
-            if (node == N - 1) {
-                done = 1;
-            } else {
-                node >>= 1;
-                depth -= 1;
-            }
+        /* f_minsum down to the next leaf: a bit or a special node */
+        while (depth < n) {
+            int type = node_type[node_type_ind + N * (n - depth)];
+            if (type == 10 || type == 20 || type == 30 || type == 40) break;
 
+            PROF_START(t_f);
+            f_vec(L[depth + 1], L[depth], POW2(n - depth - 1));
+            depth++;
+            PROF_STOP(t_f, PROF_F, depth);
+        }
+
+        /* Length of the leaf */
+        unsigned int temp = POW2(n - depth);
+        PROF_START(t_node);
+
+        /* Bit: check for frozen node and take decision */
+        if (depth == n) {
+            ucap[n][node_type_ind] = 0;
+
+            if (info_nodes[node_type_ind] != 0 && L[n][0] < 0) ucap[n][node_type_ind] = 1;
+
+            PROF_STOP(t_node, PROF_LEAF, depth);
         }
         /* Rate-0 nodes */
         else if (node_type[node_type_ind + N * (n - depth)] == 10) {
-            // printf("r0\n");
-            memset(&ucap[n][node * temp], 0, temp * sizeof(int));
-            memset(&ucap[depth][node * temp], 0, temp * sizeof(int));
-            node >>= 1;
-            depth -= 1;
+            if (!systematic) memset(&ucap[n][node_type_ind], 0, temp * sizeof(int));
+            memset(&ucap[depth][node_type_ind], 0, temp * sizeof(int));
+
+            PROF_STOP(t_node, PROF_RATE0, depth);
         }
 
         /* Rep nodes */
         else if (node_type[node_type_ind + N * (n - depth)] == 40) {
-            int L_sum = 0;
-            // printf("rep\n");
-            for (unsigned int i_L = node_type_ind; i_L < node_type_ind + temp; i_L++) {
-                L_sum += L[depth][i_L - node_type_ind];
-            }
-
-            int res = 0;
-            if (L_sum < 0) res = 1;
-
-            for (unsigned int i_n = 0; i_n < temp; i_n++) {
-                ucap[depth][i_n + node * temp] = res;
-                ucap[n][i_n + node * temp] = res;
-            }
+            rep_node(&ucap[depth][node_type_ind],
+                     systematic ? NULL : &ucap[n][node_type_ind],
+                     L[depth],
+                     temp);
 
-            if (res == 1) ucap[n][node_type_ind + temp] = 1;
-
-            if (temp + node_type_ind == N) done = 1;
-
-            node >>= 1;
-            depth -= 1;
+            PROF_STOP(t_node, PROF_REP, depth);
         }
 
         /* Rate-1 nodes */
         else if (node_type[node_type_ind + N * (n - depth)] == 20) {
-            for (unsigned int i_n = node_type_ind; i_n < node_type_ind + temp; i_n++) {
-                ucap[depth][i_n] = 0;
-                if (L[depth][i_n - node_type_ind] < 0) ucap[depth][i_n] = 1;
-
-                ucap[n][i_n] = ucap[depth][i_n];
-            }
-
-            encode(&ucap[n][node_type_ind], (int)temp);
-
-            if (temp + node_type_ind == N) done = 1;
+            rate1_node(&ucap[depth][node_type_ind],
+                       systematic ? NULL : &ucap[n][node_type_ind],
+                       L[depth],
+                       temp);
 
-            node >>= 1;
-            depth -= 1;
+            PROF_STOP(t_node, PROF_RATE1, depth);
         }
 
         /* SPC nodes */
-        else if (node_type[node_type_ind + N * (n - depth)] == 30) {
-            int LLR_Q_min = absl_macro(L[depth][0]);
-            int par_bit = 0;
-            i_min = 0;
-
-            for (unsigned int i_n = node_type_ind; i_n < node_type_ind + temp; i_n++) {
-                if (absl_macro(L[depth][i_n - node_type_ind]) < LLR_Q_min) {
-                    i_min = i_n - node_type_ind;
-                    LLR_Q_min = absl_macro(L[depth][i_n - node_type_ind]);
-                }
-
-                ucap[depth][i_n] = 0;
-                if (L[depth][i_n - node_type_ind] < 0) ucap[depth][i_n] = 1;
-
-                par_bit = par_bit ^ ucap[depth][i_n];
-                ucap[n][i_n] = ucap[depth][i_n];
-            }
-
-            ucap[depth][i_min + node_type_ind]
-                = ucap[depth][i_min + node_type_ind] ^ par_bit;
-            ucap[n][i_min + node_type_ind] = ucap[depth][i_min + node_type_ind];
+        else {
+            spc_node(&ucap[depth][node_type_ind],
+                     systematic ? NULL : &ucap[n][node_type_ind],
+                     L[depth],
+                     temp);
 
-            encode(&ucap[n][node_type_ind], (int)temp);
+            PROF_STOP(t_node, PROF_SPC, depth);
+        }
 
-            if (temp + node_type_ind == N) {
-                done = 1;
-            }
+        prev_depth = depth;
+        node_type_ind += temp;
+    }
 
-            node >>= 1;
-            depth -= 1;
+    if (systematic) {
+        /* The nodes that end at N, up to the root */
+        for (unsigned int d = prev_depth; d-- > 0;) {
+            unsigned int half = POW2(n - d - 1);
+            combine_vec(&ucap[d][N - 2 * half], &ucap[d + 1][N - 2 * half], half);
         }
-        /* Non-leaf nodes */
-        else {
-            /* Propogate to left child */
-            if (ns[npos] == 0) {
-                /* f_minsum and storage */
-                for (unsigned int i_L = 0; i_L < temp / 2; i_L++) {
-                    L[depth + 1][i_L]
-                        = f_macro(L[depth][i_L], L[depth][i_L + temp / 2]);
-                }
-
-                /* Next node: Left child */
-                node <<= 1;
-                depth += 1;
-
-                /* Incoming belief length for left child */
-                temp >>= 1;
-
-                ns[npos] = 1;
-            } else {
-                /* Propogate to right child */
-                if (ns[npos] == 1) {
-                    /* g_minsum and storage */
-                    for (unsigned int i_L = 0; i_L < temp / 2; i_L++) {
-                        L[depth + 1][i_L]
-                            = g_macro(ucap[depth + 1][i_L + node_type_ind],
-                                      L[depth][i_L],
-                                      L[depth][i_L + temp / 2]);
-                    }
-
-                    /* Next node: right child */
-                    node = (node << 1) + 1;
-                    depth += 1;
-
-                    /* Incoming belief length for right child */
-                    temp >>= 1;
-
-                    ns[npos] = 2;
-                }
-
-                /* Propogate to parent node */
-                else {
-                    /* Combine */
-                    unsigned count = 0;
-                    for (unsigned int i_L = 0; i_L < temp; i_L++) {
-                        if (count < temp / 2) {
-                            ucap[depth][i_L + node_type_ind]
-                                = ucap[depth + 1][i_L + node_type_ind]
-                                ^ ucap[depth + 1]
-                                      [i_L + node_type_ind + temp / 2];
-                        } else {
-                            ucap[depth][i_L + node_type_ind]
-                                = ucap[depth + 1][i_L + node_type_ind];
-                        }
-                        count++;
-                    }
-
-                    node >>= 1;
-                    depth -= 1;
-                }
-            }
-        }  // end of non-leaf node else
-    }  // end of while loop
+        for (unsigned i_m = 0; i_m < K; i_m++) {
+            msg_cap[i_m] = ucap[0][data_pos[i_m]];
+        }
+        return;
+    }
 
     for (unsigned i_m = 0; i_m < K; i_m++) {
         msg_cap[i_m] = ucap[n][data_pos[i_m]];
     }
+}
+
+void decode(int *msg_cap, unsigned int N, unsigned int n, unsigned int K, int *LLR_Q,
+            int *info_nodes, int *data_pos, int *node_type) {
+    ssc_decode(msg_cap, N, n, K, LLR_Q, info_nodes, data_pos, node_type, 0);
+}
+
+void decode_sys(int *msg_cap, unsigned int N, unsigned int n, unsigned int K, int *LLR_Q,
+                int *info_nodes, int *data_pos, int *node_type) {
+    ssc_decode(msg_cap, N, n, K, LLR_Q, info_nodes, data_pos, node_type, 1);
 }
\ No newline at end of file
@@ -14,4 +14,8 @@ void find_node_type(int *node_type, int N, int Nt, int in, int *data_pos_sorted,
 
 void encode(int *u, int N);
 
+void encode_sys(int *u, int N, int *info_nodes);
+
 void decode(int *msg_cap, unsigned int n, unsigned int N, unsigned int K, int *LLR_Q, int *info_nodes, int *data_pos, int *node_type);
+
+void decode_sys(int *msg_cap, unsigned int n, unsigned int N, unsigned int K, int *LLR_Q, int *info_nodes, int *data_pos, int *node_type);
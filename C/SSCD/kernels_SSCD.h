@@ -0,0 +1,110 @@
+#ifndef KERNELS_SSCD_H
+#define KERNELS_SSCD_H
+
+/**
+ * @file kernels_SSCD.h
+ * @brief The per-node kernels of the SSC decoder
+ *
+ * Belief updates (f, g), the partial-sum combine and the Rep, Rate-1 and SPC
+ * node decisions, inlined into decode() and timed one by one by
+ * regression/bench_kernels.c. u_node are the decisions of the node at its
+ * own depth, u_leaf the same bits re-encoded at the leaf level; systematic
+ * decoding needs no leaf bits and passes u_leaf NULL.
+ */
+
+#define f_macro(L1, L2) \
+    sign_macro(L1) * sign_macro(L2) * mini_macro(absl_macro(L1), absl_macro(L2))
+#define maxqr 31
+#define g_macro(u, L1, L2) \
+    mini_macro(maxi_macro((((1 - 2 * u) * L1) + L2), -(maxqr + 1)), maxqr)
+// #define g_macro(u, L1, L2) (((1 - 2*u) * L1) + L2)
+#define absl_macro(x)    (((x > 0) - (x < 0)) * x)
+#define mini_macro(x, y) ((x < y) ? x : y)
+#define maxi_macro(x, y) ((x < y) ? y : x)
+#define sign_macro(x)    ((x > 0) - (x < 0))
+
+void encode(int *u, int N);
+
+/* f_minsum into the left child: out[i] = f(L[i], L[i + half]) */
+static inline void f_vec(int *out, const int *L, const unsigned half) {
+    for (unsigned i = 0; i < half; i++) {
+        out[i] = f_macro(L[i], L[i + half]);
+    }
+}
+
+/* g_minsum into the right child, u are the left child's partial sums */
+static inline void g_vec(int *out, const int *L, const int *u,
+                         const unsigned half) {
+    for (unsigned i = 0; i < half; i++) {
+        out[i] = g_macro(u[i], L[i], L[i + half]);
+    }
+}
+
+/* Partial sums of a node from those of its two children */
+static inline void combine_vec(int *parent, const int *child,
+                               const unsigned half) {
+    for (unsigned i = 0; i < half; i++) {
+        parent[i] = child[i] ^ child[i + half];
+        parent[i + half] = child[i + half];
+    }
+}
+
+/* Rep node: every bit takes the sign of the sum of the beliefs */
+static inline void rep_node(int *u_node, int *u_leaf, const int *L,
+                            const unsigned len) {
+    int L_sum = 0;
+    for (unsigned i = 0; i < len; i++) {
+        L_sum += L[i];
+    }
+    const int res = L_sum < 0;
+    for (unsigned i = 0; i < len; i++) {
+        u_node[i] = res;
+    }
+    if (u_leaf) {
+        for (unsigned i = 0; i < len; i++) {
+            u_leaf[i] = res;
+        }
+    }
+}
+
+/* Rate-1 node: hard decisions, re-encoded for the leaves */
+static inline void rate1_node(int *u_node, int *u_leaf, const int *L,
+                              const unsigned len) {
+    for (unsigned i = 0; i < len; i++) {
+        u_node[i] = L[i] < 0;
+    }
+    if (u_leaf) {
+        for (unsigned i = 0; i < len; i++) {
+            u_leaf[i] = u_node[i];
+        }
+        encode(u_leaf, (int)len);
+    }
+}
+
+/* SPC node: hard decisions, the least reliable bit flipped on odd parity */
+static inline void spc_node(int *u_node, int *u_leaf, const int *L,
+                            const unsigned len) {
+    int LLR_Q_min = absl_macro(L[0]);
+    int par_bit = 0;
+    unsigned i_min = 0;
+
+    for (unsigned i = 0; i < len; i++) {
+        if (absl_macro(L[i]) < LLR_Q_min) {
+            i_min = i;
+            LLR_Q_min = absl_macro(L[i]);
+        }
+        u_node[i] = L[i] < 0;
+        par_bit = par_bit ^ u_node[i];
+    }
+
+    u_node[i_min] = u_node[i_min] ^ par_bit;
+
+    if (u_leaf) {
+        for (unsigned i = 0; i < len; i++) {
+            u_leaf[i] = u_node[i];
+        }
+        encode(u_leaf, (int)len);
+    }
+}
+
+#endif  // KERNELS_SSCD_H
@@ -0,0 +1,300 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "functions_SSCD.h"
+#include "pipeline_SSCD.h"
+#include "prof.h"
+#include "ring.h"
+
+/* Frame slots of the pool: enough to keep every stage busy while the
+ * decoders take frames out of order */
+#define SLOTS_PER_DECODER (8)
+#define SLOTS_MIN         (32)
+
+typedef struct Pipeline Pipeline;
+
+typedef struct DecoderThread {
+    pthread_t thread;
+    Pipeline *pl;
+    StageStats stats;
+    LatHist lat;
+    uint64_t bit_errors;
+} DecoderThread;
+
+struct Pipeline {
+    const SscdPoint *pt;
+
+    /* Slot s holds msg[s * K ...], u, noise and LLR_Q[s * N ...] */
+    int *msg;
+    int *u;
+    float *noise;
+    int *LLR_Q;
+
+    MpmcRing free_slots;
+    SpscRing to_encoder;
+    SpscRing to_channel;
+    MpmcRing to_decoder;
+
+    StageStats source, encoder, channel;
+    DecoderThread *decoders;
+};
+
+static uint32_t round_pow2(const uint32_t x) {
+    uint32_t p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+/* Message bits and noise samples, in the order of the serial loop */
+static void *source_stage(void *arg) {
+    Pipeline *pl = arg;
+    const SscdPoint *pt = pl->pt;
+    StageStats *st = &pl->source;
+
+    for (unsigned int i_f = 0; i_f < pt->num_sim; i_f++) {
+        uint32_t s;
+        mpmc_pop(&pl->free_slots, &s, &st->starved_ns);
+        const uint64_t t0 = lat_now_ns();
+
+        int *msg = pl->msg + (size_t)s * pt->K;
+        for (unsigned int i_msg = 0; i_msg < pt->K; i_msg++) {
+            msg[i_msg] = uni();
+        }
+        float *noise = pl->noise + (size_t)s * pt->N;
+        for (unsigned int i_n = 0; i_n < pt->N; i_n++) {
+            noise[i_n] = randn(0, 1);
+        }
+
+        st->busy_ns += lat_now_ns() - t0;
+        st->items++;
+        spsc_push(&pl->to_encoder, s, &st->blocked_ns);
+    }
+    spsc_push(&pl->to_encoder, RING_EOS, &st->blocked_ns);
+    return NULL;
+}
+
+static void *encoder_stage(void *arg) {
+    Pipeline *pl = arg;
+    const SscdPoint *pt = pl->pt;
+    StageStats *st = &pl->encoder;
+
+    for (;;) {
+        uint32_t s;
+        spsc_pop(&pl->to_encoder, &s, &st->starved_ns);
+        if (s == RING_EOS) break;
+        const uint64_t t0 = lat_now_ns();
+
+        const int *msg = pl->msg + (size_t)s * pt->K;
+        int *u = pl->u + (size_t)s * pt->N;
+        memset(u, 0, sizeof(int) * pt->N);
+        for (unsigned int i_ud = 0; i_ud < pt->K; i_ud++) {
+            u[pt->data_pos[i_ud]] = msg[i_ud];
+        }
+        if (pt->systematic) {
+            encode_sys(u, (int)pt->N, pt->info_nodes);
+        } else {
+            encode(u, (int)pt->N);
+        }
+
+        st->busy_ns += lat_now_ns() - t0;
+        st->items++;
+        spsc_push(&pl->to_channel, s, &st->blocked_ns);
+    }
+    spsc_push(&pl->to_channel, RING_EOS, &st->blocked_ns);
+    return NULL;
+}
+
+/* BPSK, noise and quantization as in SSCD_simulate.c; the trace in order */
+static void *channel_stage(void *arg) {
+    Pipeline *pl = arg;
+    const SscdPoint *pt = pl->pt;
+    StageStats *st = &pl->channel;
+    const float Eb = 1.0f;
+    const float maxqr = pt->maxqr;
+
+    for (;;) {
+        uint32_t s;
+        spsc_pop(&pl->to_channel, &s, &st->starved_ns);
+        if (s == RING_EOS) break;
+        const uint64_t t0 = lat_now_ns();
+
+        const int *u = pl->u + (size_t)s * pt->N;
+        const float *noise = pl->noise + (size_t)s * pt->N;
+        int *LLR_Q = pl->LLR_Q + (size_t)s * pt->N;
+        for (unsigned int i_ch = 0; i_ch < pt->N; i_ch++) {
+            const float x = sqrtf(Eb) * (float)(1 - 2 * u[i_ch]);
+            const float y = x + pt->sig * noise[i_ch];
+            LLR_Q[i_ch] = (int)floorf(y / pt->rmax * maxqr);
+            if (LLR_Q[i_ch] > maxqr) {
+                LLR_Q[i_ch] = (int)maxqr;
+            } else if (LLR_Q[i_ch] < -(maxqr + 1)) {
+                LLR_Q[i_ch] = -((int)maxqr + 1);
+            }
+        }
+        llr_trace_write_int(
+            pt->trace, pt->EbN0dB, LLR_Q, pl->msg + (size_t)s * pt->K);
+
+        st->busy_ns += lat_now_ns() - t0;
+        st->items++;
+        mpmc_push(&pl->to_decoder, s, &st->blocked_ns);
+    }
+    for (int i_d = 0; i_d < pt->num_decoders; i_d++) {
+        mpmc_push(&pl->to_decoder, RING_EOS, &st->blocked_ns);
+    }
+    return NULL;
+}
+
+static void *decoder_stage(void *arg) {
+    DecoderThread *dt = arg;
+    Pipeline *pl = dt->pl;
+    const SscdPoint *pt = pl->pt;
+    StageStats *st = &dt->stats;
+    int msg_cap[pt->K];
+
+    for (;;) {
+        uint32_t s;
+        mpmc_pop(&pl->to_decoder, &s, &st->starved_ns);
+        if (s == RING_EOS) break;
+        const uint64_t t0 = lat_now_ns();
+
+        (pt->systematic ? decode_sys : decode)(msg_cap,
+                                               pt->N,
+                                               pt->n,
+                                               pt->K,
+                                               pl->LLR_Q + (size_t)s * pt->N,
+                                               pt->info_nodes,
+                                               pt->data_pos,
+                                               pt->node_type);
+
+        const uint64_t t1 = lat_now_ns();
+        lat_record(&dt->lat, t1 - t0);
+
+        const int *msg = pl->msg + (size_t)s * pt->K;
+        for (unsigned int i_err = 0; i_err < pt->K; i_err++) {
+            dt->bit_errors += msg_cap[i_err] != msg[i_err];
+        }
+
+        st->busy_ns += lat_now_ns() - t0;
+        st->items++;
+        mpmc_push(&pl->free_slots, s, &st->blocked_ns);
+    }
+    PROF_THREAD_END();
+    return NULL;
+}
+
+static void pipeline_free(Pipeline *pl) {
+    free(pl->msg);
+    free(pl->u);
+    free(pl->noise);
+    free(pl->LLR_Q);
+    free(pl->decoders);
+    mpmc_free(&pl->free_slots);
+    spsc_free(&pl->to_encoder);
+    spsc_free(&pl->to_channel);
+    mpmc_free(&pl->to_decoder);
+}
+
+int sscd_pipeline_run(const SscdPoint *pt, LatHist *lat,
+                      SscdPointResult *res) {
+    const int D = pt->num_decoders;
+    const uint32_t slots = round_pow2(
+        (uint32_t)(SLOTS_PER_DECODER * D > SLOTS_MIN ? SLOTS_PER_DECODER * D
+                                                     : SLOTS_MIN));
+
+    static Pipeline pl;
+    memset(&pl, 0, sizeof(pl));
+    pl.pt = pt;
+    pl.msg = malloc(sizeof(int) * slots * pt->K);
+    pl.u = malloc(sizeof(int) * slots * pt->N);
+    pl.noise = malloc(sizeof(float) * slots * pt->N);
+    pl.LLR_Q = malloc(sizeof(int) * slots * pt->N);
+    pl.decoders = calloc((size_t)D, sizeof(DecoderThread));
+    if (!pl.msg || !pl.u || !pl.noise || !pl.LLR_Q || !pl.decoders
+        || mpmc_init(&pl.free_slots, slots) != 0
+        || spsc_init(&pl.to_encoder, slots) != 0
+        || spsc_init(&pl.to_channel, slots) != 0
+        || mpmc_init(&pl.to_decoder, slots) != 0) {
+        pipeline_free(&pl);
+        return -1;
+    }
+    for (uint32_t s = 0; s < slots; s++) {
+        mpmc_try_push(&pl.free_slots, s);
+    }
+
+    /* Downstream stages first: if one cannot be started, the stages already
+     * running get the RING_EOS it would have sent them and drain */
+    const uint64_t start = lat_now_ns();
+    int num_started = 0;
+    for (int i_d = 0; i_d < D; i_d++) {
+        pl.decoders[i_d].pl = &pl;
+        lat_reset(&pl.decoders[i_d].lat);
+        if (pthread_create(&pl.decoders[i_d].thread,
+                           NULL,
+                           decoder_stage,
+                           &pl.decoders[i_d])
+            != 0) {
+            break;
+        }
+        num_started++;
+    }
+    pthread_t source, encoder, channel;
+    const int has_channel
+        = num_started == D
+          && pthread_create(&channel, NULL, channel_stage, &pl) == 0;
+    const int has_encoder
+        = has_channel
+          && pthread_create(&encoder, NULL, encoder_stage, &pl) == 0;
+    const int has_source
+        = has_encoder && pthread_create(&source, NULL, source_stage, &pl) == 0;
+    if (!has_source) {
+        uint64_t wait_ns = 0;
+        if (has_encoder) {
+            spsc_push(&pl.to_encoder, RING_EOS, &wait_ns);
+            pthread_join(encoder, NULL);
+        } else if (has_channel) {
+            spsc_push(&pl.to_channel, RING_EOS, &wait_ns);
+        } else {
+            for (int i_d = 0; i_d < num_started; i_d++) {
+                mpmc_push(&pl.to_decoder, RING_EOS, &wait_ns);
+            }
+        }
+        if (has_channel) pthread_join(channel, NULL);
+        for (int i_d = 0; i_d < num_started; i_d++) {
+            pthread_join(pl.decoders[i_d].thread, NULL);
+        }
+        pipeline_free(&pl);
+        return -1;
+    }
+
+    pthread_join(source, NULL);
+    pthread_join(encoder, NULL);
+    pthread_join(channel, NULL);
+    StageStats decoder = {0, 0, 0, 0};
+    res->bit_errors = 0;
+    for (int i_d = 0; i_d < D; i_d++) {
+        DecoderThread *dt = &pl.decoders[i_d];
+        pthread_join(dt->thread, NULL);
+        decoder.items += dt->stats.items;
+        decoder.busy_ns += dt->stats.busy_ns;
+        decoder.starved_ns += dt->stats.starved_ns;
+        decoder.blocked_ns += dt->stats.blocked_ns;
+        lat_merge(lat, &dt->lat);
+        res->bit_errors += dt->bit_errors;
+    }
+    const uint64_t wall_ns = lat_now_ns() - start;
+    res->enc_ns = pl.encoder.busy_ns;
+    res->dec_ns = decoder.busy_ns;
+
+    stage_print(stdout, "source", 1, &pl.source, wall_ns);
+    stage_print(stdout, "encoder", 1, &pl.encoder, wall_ns);
+    stage_print(stdout, "channel", 1, &pl.channel, wall_ns);
+    stage_print(stdout, "decoder", D, &decoder, wall_ns);
+
+    pipeline_free(&pl);
+    return 0;
+}
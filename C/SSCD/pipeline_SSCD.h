@@ -0,0 +1,49 @@
+#ifndef PIPELINE_SSCD_H
+#define PIPELINE_SSCD_H
+
+/**
+ * @file pipeline_SSCD.h
+ * @brief The SSC simulation of one noise level as a pipeline of threads
+ *
+ * source -> encoder -> channel -> decoder x num_decoders, linked by the
+ * lock-free rings of ring.h over a pool of frame slots. The source draws
+ * the message and the noise of each frame: rand() is one stream, and
+ * drawing in the serial order keeps the frames, and so the BER, those of
+ * the serial loop for the same seed. The channel adds the noise, quantizes
+ * and writes the LLR trace, in frame order; the decoders take frames as
+ * they come.
+ */
+
+#include <stdint.h>
+
+#include "latency.h"
+#include "llr_trace.h"
+
+typedef struct SscdPoint {
+    unsigned int N;
+    unsigned int n;
+    unsigned int K;
+    int *info_nodes;
+    int *data_pos;
+    int *node_type;
+    float sig;
+    float rmax;
+    float maxqr;
+    float EbN0dB;
+    unsigned int num_sim;
+    int num_decoders;
+    LlrTraceWriter *trace;
+    int systematic; /* encode_sys() and decode_sys() */
+} SscdPoint;
+
+typedef struct SscdPointResult {
+    uint64_t bit_errors;
+    uint64_t enc_ns; /* encoder stage busy */
+    uint64_t dec_ns; /* decoder stages busy, summed */
+} SscdPointResult;
+
+/* Runs pt->num_sim frames, prints the stage utilization and records the
+ * decode latency of each frame in lat; -1 if the pipeline cannot start */
+int sscd_pipeline_run(const SscdPoint *pt, LatHist *lat, SscdPointResult *res);
+
+#endif  // PIPELINE_SSCD_H
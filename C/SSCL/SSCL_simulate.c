@@ -5,10 +5,18 @@
 #include <string.h>
 
 #include "functions_SSCL.h"
+#include "../common/latency.h"
+#include "../common/llr_trace.h"
+#include "../common/pmu.h"
+#include "../common/prof.h"
+#include "../common/reliability.h"
 
 int main(){
 
     // srand(time(NULL));
+    /* rand() seed, POLAR_SEED overrides it; goes into the LLR trace */
+    const unsigned seed = llr_trace_seed(1);
+    srand(seed);
 
 	clock_t start, end;
     clock_t enc_start, enc_end;
@@ -85,6 +93,9 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 	/* Number of information bits */
 	int K = (int)N*rate;
 
+    /* Reliability sequence from the file POLAR_Q names (reliability.h) */
+    if (rel_order_env(N, Q) != 0) return EXIT_FAILURE;
+
     /* Boolean array with information nodes pos = 1 */
     int info_nodes[N];
 
@@ -180,11 +191,20 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     /*Simulations corresponding to each sig*/
     int i_sig = 0;
     int count[1];
+    /* Decode latency per noise level and over all of them */
+    static LatHist lat, lat_all;
+    lat_reset(&lat_all);
+
+    /* Frames to a binary LLR trace if POLAR_TRACE names a file */
+    LlrTraceWriter trace;
+    llr_trace_create(&trace, getenv("POLAR_TRACE"), LLR_TRACE_INT8, N, K, crc_l, maxqr, (float)rmax, seed, data_pos);
+
     for (i_sig = 0; i_sig < num_EbN0dB; i_sig++)
     {
         printf("Count %d of %d\n", i_sig+1, num_EbN0dB);
 
         int err_count = 0;
+        lat_reset(&lat);
         sig = sigma[i_sig];
         
         BER[i_sig] = 0;
@@ -272,7 +292,11 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
 
             int crc_check[l];
 
+            llr_trace_write_int(&trace, EbN0dB[i_sig], LLR_Q, msg);
+
             dec_start = clock();
+            const uint64_t lat_start = lat_now_ns();
+            PMU_START();
 
             decode_unrolled(N, K, l, info_nodes, data_pos, node_type, LLR_Q, msg_cap);
 
@@ -294,6 +318,8 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
                 crc_ind = 0;
             }
 
+            PMU_STOP(K - crc_l);
+            lat_record(&lat, lat_now_ns() - lat_start);
             dec_end = clock();
 
             dec_cpu_time_used = dec_cpu_time_used + ( dec_end - dec_start );
@@ -311,6 +337,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
         printf("EbN0dB %0.2f\t", EbN0dB[i_sig]);
         BER[i_sig] = (double) err_count/(N*num_sim);
         printf("BER %lf\n", BER[i_sig]);
+        lat_print(stdout, "decode", &lat);
+        PMU_REPORT("decode");
+        PMU_RESET();
+        lat_merge(&lat_all, &lat);
 
     } // end of noise var loop
 
@@ -325,5 +355,10 @@ int Q[1024] = {0 ,1 ,2 ,4 ,8 ,16 ,32 ,3 ,5 ,64 ,9 ,6 ,17 ,10 ,18 ,128 ,12 ,33 ,6
     printf("Decoder throughput is %0.2f Mbps for list size %d\n", ((float)(num_sim*num_EbN0dB)/(dec_cpu_time_used*1000)),l);
     printf("Encoder throughput is %0.2f Mbps\n", ((float)(num_sim*num_EbN0dB)/(enc_cpu_time_used*1000)));
 
+    PROF_REPORT("SSCL");
+
+    llr_trace_finish(&trace);
+    lat_print(stdout, "all points", &lat_all);
+
 return 0;
 }
\ No newline at end of file
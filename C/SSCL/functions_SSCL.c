@@ -6,6 +6,9 @@
 
 #include "functions_SSCL.h"
 
+#define PROF_IMPLEMENTATION
+#include "../common/prof.h"
+
 #define maxqr 31
 #define sign_macro(x) ((x > 0) - (x < 0))
 #define f_macro(L1, L2) sign_macro(L1)*sign_macro(L2)*mini_macro(absl_macro(L1),absl_macro(L2))
@@ -183,6 +186,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
     /* Variable to count no. of decoded data bits */
     int counter = 0;
 
+    PROF_FRAME();
+
     while (!(done == 1 && depth == -1)) //traverse till all bits are decoded and root node is reached again
     {
         /* Position of node in node state vector */
@@ -197,6 +202,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
         /* Check for leaf node */
         if (depth == n && done == 0)
         {
+            PROF_START(t_node);
+
             if ( info_nodes[node_type_ind] == 0 )
             {
                 /* Assigning 0 to decoded bits and updating path metrics */
@@ -213,7 +220,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 }
 
                 /* Sorting the Path Metrics  */
+                PROF_START(t_sort);
                 insertionSort(PM, ind_ord_l, l);
+                PROF_STOP(t_sort, PROF_SORT, depth);
 
                 /* New ordering */
                 for (i_list = 0; i_list < l; i_list++)
@@ -263,7 +272,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     }
 
                     /* Sorting the Path Metrics  */
+                    PROF_START(t_sort);
                     insertionSort(PM_temp, ind_ord, 2*l);
+                    PROF_STOP(t_sort, PROF_SORT, depth);
 
                     for (i_list = 0; i_list < l; i_list++)
                     {
@@ -333,7 +344,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     }
 
                     /* Sorting the Path Metrics  */
+                    PROF_START(t_sort);
                     insertionSort(PM, ind_ord_l, l);
+                    PROF_STOP(t_sort, PROF_SORT, depth);
 
                     /* New ordering */
                     for (i_list = 0; i_list < l; i_list++)
@@ -356,12 +369,15 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
 
             } // end of else 
 
+            PROF_STOP(t_node, PROF_LEAF, depth);
+
             (node == N-1) ? (done = 1, node >>= 1 , depth -= 1) :  (node >>= 1 , depth -= 1 );
         } // end of leaf node
 
         /* Rate-0 nodes */
         else if(node_type[node_type_ind + N*(n-depth)] == 10 && done == 0 && ns[npos] != 2)
         {
+            PROF_START(t_node);
 
             for (i_list = 0; i_list < l; i_list++)
             {
@@ -379,7 +395,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
             }
 
             /* Sorting the Path Metrics  */
+            PROF_START(t_sort);
             insertionSort(PM, ind_ord_l, l);
+            PROF_STOP(t_sort, PROF_SORT, depth);
 
             /* New ordering */
             for (i_list = 0; i_list < l; i_list++)
@@ -388,6 +406,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 ind_ord_mat[depth][l*node + i_list] = ind_ord_l[i_list];
             }
 
+            PROF_STOP(t_node, PROF_RATE0, depth);
+
             if (temp + node_type_ind == N)
             {
                 done = 1;
@@ -398,6 +418,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
         /* Rate-1 nodes */
         else if(node_type[node_type_ind + N*(n-depth)] == 20 && counter > ln -1 && done == 0 && ns[npos] != 2)
         {
+            PROF_START(t_node);
+
             /* Incoming LLR Values and decisions*/
             int L_in[l*temp];
 
@@ -457,7 +479,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 }
 
                 /* Sorting the Path Metrics  */
+                PROF_START(t_sort);
                 insertionSort(PM_temp, ind_ord_temp, 2*l);
+                PROF_STOP(t_sort, PROF_SORT, depth);
 
                 for (i_list = 0; i_list < l; i_list++)
                 {
@@ -471,10 +495,12 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     ind_ord_old[i_list] = ind_ord[i_list];
                     ind_ord_old[i_list + l] = ind_ord[i_list + l];
 
+                    PROF_START(t_copy);
                     for (i_N = 0; i_N < i_NN; i_N++)
                     {
                         beta_copy[i_N + i_list*temp] = beta[depth][i_N + node_type_ind + i_list*N];
                     }
+                    PROF_STOP(t_copy, PROF_PATH_COPY, depth);
                 }
 
                 for (i_list = 0; i_list < l; i_list++)
@@ -483,10 +509,12 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     {
                         i_temp = (ind_ord_temp[ i_list]%l)*temp;
 
+                        PROF_START(t_copy);
                         for (i_N = 0; i_N < i_NN; i_N++)
                         {
                             beta[depth][i_N + node_type_ind + i_list*N] = beta_copy[i_N + i_temp];
                         }
+                        PROF_STOP(t_copy, PROF_PATH_COPY, depth);
                     }                       
 
                     beta[depth][i_NN + node_type_ind + i_list*N] = codeword_temp[ind_ord_temp[i_list]];
@@ -505,6 +533,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 ind_ord_mat[depth][l*node + i_list] = ind_ord[i_list]%l;
             }
 
+            PROF_STOP(t_node, PROF_RATE1, depth);
+
             if (temp + node_type_ind == N)
             {
                 done = 1;
@@ -516,6 +546,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
         /* SPC nodes */
         else if(node_type[node_type_ind + N*(n-depth)] == 301 && counter > ln -1 && done == 0 && ns[npos] != 2)
         {
+            PROF_START(t_node);
+
             /* Incoming LLR Values and decisions*/
             int L_in[l*temp];
             int min_LLR_pos[l];
@@ -596,7 +628,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 }
 
                 /* Sorting the Path Metrics  */
+                PROF_START(t_sort);
                 insertionSort(PM_temp, ind_ord_temp, 2*l);
+                PROF_STOP(t_sort, PROF_SORT, depth);
 
                 for (i_list = 0; i_list < l; i_list++)
                 {
@@ -612,10 +646,12 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     ind_ord_old[i_list] = ind_ord[i_list];
                     ind_ord_old[i_list + l] = ind_ord[i_list + l];
 
+                    PROF_START(t_copy);
                     for (i_N = 0; i_N < i_NN; i_N++)
                     {
                         beta_copy[i_N + i_list*temp] = beta[depth][i_N + node_type_ind + i_list*N];
                     }
+                    PROF_STOP(t_copy, PROF_PATH_COPY, depth);
                 }
 
                 for (i_list = 0; i_list < l; i_list++)
@@ -624,10 +660,12 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     {
                         i_temp = (ind_ord_temp[ i_list]%l)*temp;
 
+                        PROF_START(t_copy);
                         for (i_N = 0; i_N < i_NN; i_N++)
                         {
                             beta[depth][i_N + node_type_ind + i_list*N] = beta_copy[i_N + i_temp];
                         }
+                        PROF_STOP(t_copy, PROF_PATH_COPY, depth);
                     }                       
 
                     beta[depth][i_NN + node_type_ind + i_list*N] = codeword_temp[ind_ord_temp[i_list]];
@@ -686,6 +724,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
             //     }
             // }
 
+            PROF_STOP(t_node, PROF_SPC, depth);
+
             if (temp + node_type_ind == N)
             {
                 done = 1;
@@ -696,6 +736,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
 
         else if ( node_type[node_type_ind + N*(n-depth)] == 40 && done == 0 &&  ns[npos] != 2)
         {
+            PROF_START(t_node);
+
             if ( counter > ln - 1)
             {
                 for (i_list = 0; i_list < l; i_list++)
@@ -736,7 +778,9 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 }
 
                 /* Sorting the Path Metrics  */
+                PROF_START(t_sort);
                 insertionSort(PM_temp, ind_ord_temp, 2*l);
+                PROF_STOP(t_sort, PROF_SORT, depth);
 
                 int i_temp_l;
 
@@ -762,6 +806,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     ind_ord_mat[depth][node*l + i_list] = ind_ord_temp[i_list]%l;
                 }
 
+                PROF_STOP(t_node, PROF_REP, depth);
+
                 if (temp + node_type_ind == N)
                 {
                     done = 1;
@@ -827,6 +873,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 }
 
                 /* Sorting the Path Metrices  */
+                PROF_START(t_sort);
                 for (i_list = 1; i_list < l; i_list++) 
                 {
 
@@ -843,6 +890,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     PM[cur_index+1] = key_arr;
                     ind_ord_l[cur_index+1] = key_ind;
                 }
+                PROF_STOP(t_sort, PROF_SORT, depth);
 
                 /* New ordering */
                 for (i_list = 0; i_list < l; i_list++)
@@ -866,6 +914,8 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
 
                 counter++;
 
+                PROF_STOP(t_node, PROF_REP, depth);
+
                 if (temp + node_type_ind == N)
                 {
                     done = 1;
@@ -883,6 +933,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 int i_temp;
 
                 /* f_minsum and storage */
+                PROF_START(t_f);
                 for (i_list = 0; i_list < l; i_list++)
                 {
                     i_temp = i_list*N;
@@ -892,6 +943,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                         L[depth + 1][i_L + i_temp] = f_macro(L[depth][i_L + i_temp], L[depth][i_L + temp/2 + i_temp]);
                     }
                 }
+                PROF_STOP(t_f, PROF_F, depth + 1);
 
                 /* Next node: Left child */
                 node <<= 1 ; depth += 1 ;
@@ -911,6 +963,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                     int i_temp_ord;
 
                     /* g_minsum and storage */
+                    PROF_START(t_g);
                     for (i_list = 0; i_list < l; i_list++)
                     {
                         i_temp = i_list*N;
@@ -922,6 +975,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                             L[depth + 1][i_L + i_temp] = g_macro(beta[depth + 1][i_L + node_type_ind + i_temp], L[depth][i_L + i_temp_ord], L[depth][i_L + temp/2 + i_temp_ord]);
                         }
                     }
+                    PROF_STOP(t_g, PROF_G, depth + 1);
 
                     /* Next node: right child */
                     node = (node << 1) + 1; depth += 1;
@@ -936,6 +990,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                 else
                 {
                     /* Updating beta */
+                    PROF_START(t_c);
                     int i_up;
                     int i_temp_ord;
                     int i_temp;
@@ -978,6 +1033,7 @@ void decode_unrolled(int N, int K, int l, int *info_nodes, int *data_pos, int *n
                             beta[depth][i_up + temp/2 + i_temp] =  beta[depth+1][i_temp + temp/2 + i_up];
                         }
                     }
+                    PROF_STOP(t_c, PROF_COMBINE, depth);
 
                     node >>= 1; depth -= 1;
                 } // end of parent node propagation
@@ -0,0 +1,126 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/**
+ * @file latency.h
+ * @brief Per-frame decode latency: monotonic ns timer and HDR-style histogram
+ *
+ * clock() is process CPU time with a coarse tick and only gives the average.
+ * The simulations time each decode with lat_now_ns() (CLOCK_MONOTONIC) and
+ * record it in a LatHist, which keeps the tail: p50/p99/p99.9 and the max.
+ *
+ * The histogram is log-linear like HdrHistogram: values below 2^LAT_SUB_BITS
+ * ns are exact, above that every power of two is split into 2^(LAT_SUB_BITS-1)
+ * equal buckets, so a quantile is within 1/2^(LAT_SUB_BITS-1) (1.6%) of the
+ * recorded value. Quantiles report the upper end of their bucket. Values from
+ * 2^LAT_MAX_MSB ns (about 18 minutes) on share the last bucket.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define LAT_SUB_BITS    (7)
+#define LAT_MAX_MSB     (40)
+#define LAT_NUM_BUCKETS \
+    (((LAT_MAX_MSB - LAT_SUB_BITS + 2) << (LAT_SUB_BITS - 1)) + 1)
+
+typedef struct LatHist {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t bucket[LAT_NUM_BUCKETS];
+} LatHist;
+
+/* CLOCK_MONOTONIC is POSIX; a strict ISO C build only has the wall clock */
+static inline uint64_t lat_now_ns(void) {
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline void lat_reset(LatHist *h) {
+    memset(h, 0, sizeof(*h));
+    h->min_ns = UINT64_MAX;
+}
+
+static inline unsigned lat_msb(uint64_t v) {
+    unsigned msb = 0;
+    while (v >>= 1) msb++;
+    return msb;
+}
+
+/* Bucket of v: exact below 2^S, then 2^(S-1) buckets per power of two */
+static inline unsigned lat_bucket(uint64_t v) {
+    if (v >> LAT_MAX_MSB) return LAT_NUM_BUCKETS - 1;
+    const unsigned msb = lat_msb(v);
+    if (msb < LAT_SUB_BITS) return (unsigned)v;
+    const unsigned shift = msb - LAT_SUB_BITS + 1;
+    return (shift << (LAT_SUB_BITS - 1)) + (unsigned)(v >> shift);
+}
+
+/* Largest value that falls into bucket b */
+static inline uint64_t lat_bucket_top(const unsigned b) {
+    if (b < (1u << LAT_SUB_BITS)) return b;
+    const unsigned shift = (b >> (LAT_SUB_BITS - 1)) - 1;
+    const uint64_t sub = b - (shift << (LAT_SUB_BITS - 1));
+    return ((sub + 1) << shift) - 1;
+}
+
+static inline void lat_record(LatHist *h, const uint64_t ns) {
+    h->bucket[lat_bucket(ns)]++;
+    h->count++;
+    h->sum_ns += ns;
+    if (ns < h->min_ns) h->min_ns = ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+}
+
+static inline void lat_merge(LatHist *dst, const LatHist *src) {
+    for (unsigned b = 0; b < LAT_NUM_BUCKETS; b++) {
+        dst->bucket[b] += src->bucket[b];
+    }
+    dst->count += src->count;
+    dst->sum_ns += src->sum_ns;
+    if (src->min_ns < dst->min_ns) dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+}
+
+/* Smallest recorded latency with at least a fraction q of the frames at or
+ * below it, 0 <= q <= 1, to bucket precision and capped at the max */
+static inline uint64_t lat_quantile(const LatHist *h, const double q) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)h->count + 0.999999);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < LAT_NUM_BUCKETS; b++) {
+        seen += h->bucket[b];
+        if (seen >= rank) {
+            const uint64_t top = lat_bucket_top(b);
+            return top < h->max_ns ? top : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+/* One line: label, frames, mean, p50, p99, p99.9 and max in us */
+static inline void lat_print(FILE *fp, const char *label, const LatHist *h) {
+    if (h->count == 0) return;
+    fprintf(fp,
+            "  latency %-24s frames %-8llu mean %9.2f  p50 %9.2f  p99 %9.2f  "
+            "p99.9 %9.2f  max %9.2f us\n",
+            label,
+            (unsigned long long)h->count,
+            (double)h->sum_ns / (double)h->count * 1e-3,
+            (double)lat_quantile(h, 0.5) * 1e-3,
+            (double)lat_quantile(h, 0.99) * 1e-3,
+            (double)lat_quantile(h, 0.999) * 1e-3,
+            (double)h->max_ns * 1e-3);
+}
+
+#endif  // LATENCY_H
@@ -0,0 +1,322 @@
+#ifndef LLR_TRACE_H
+#define LLR_TRACE_H
+
+/**
+ * @file llr_trace.h
+ * @brief Binary trace of channel LLR frames: writer and memory-mapped reader
+ *
+ * A trace holds the frames a simulation decoded, so that a benchmark can
+ * replay them at full decoder speed and compare decoders on the same input,
+ * independent of rand() and the C library. Layout, in host byte order:
+ *
+ *   LlrTraceHeader       64 bytes: code, quantization, seed, frame count
+ *   uint32_t data_pos[K] information positions as in the simulation
+ *   padding              up to data_offset, a multiple of 64
+ *   frames               num_frames x frame_bytes, each:
+ *     LLRs               N x int8_t (quantized) or N x float
+ *     bits               K x uint8_t transmitted message (CRC included)
+ *     EbN0dB             float, 4-byte aligned
+ *     padding            up to frame_bytes, a multiple of 64
+ *
+ * Frames start on 64-byte boundaries so the reader can hand out pointers into
+ * the mapping that SIMD loads can use directly; nothing is copied. Decoders
+ * taking int LLRs widen one frame with llr_trace_llr_int().
+ *
+ * The simulations write a trace when POLAR_TRACE names a file and seed rand()
+ * from POLAR_SEED when it is set (llr_trace_seed()).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* mmap() needs POSIX; strict ISO C builds read the file instead */
+#if defined(__unix__) && (defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE) \
+                          || defined(_POSIX_C_SOURCE))
+#define LLR_TRACE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define LLR_TRACE_MMAP 0
+#endif
+
+#define LLR_TRACE_MAGIC   "POLARLLR"
+#define LLR_TRACE_VERSION (1)
+#define LLR_TRACE_ALIGN   (64)
+
+typedef enum LlrTraceType {
+    LLR_TRACE_INT8 = 0,
+    LLR_TRACE_FLOAT = 1
+} LlrTraceType;
+
+typedef struct LlrTraceHeader {
+    char magic[8];         /* LLR_TRACE_MAGIC, not terminated */
+    uint32_t version;      /* LLR_TRACE_VERSION, also catches byte order */
+    uint32_t llr_type;     /* LlrTraceType */
+    uint32_t N;
+    uint32_t K;            /* information bits, CRC included */
+    uint32_t crc_l;
+    int32_t maxqr;         /* int8: LLRs in -(maxqr + 1) ... maxqr */
+    float rmax;            /* int8: received value quantized to maxqr */
+    uint32_t frame_bytes;
+    uint64_t seed;         /* of the generator that made the frames */
+    uint64_t num_frames;
+    uint64_t data_offset;  /* of the first frame */
+} LlrTraceHeader;
+
+typedef struct LlrTraceWriter {
+    FILE *fp;              /* NULL: not writing, the calls do nothing */
+    LlrTraceHeader h;
+    uint8_t *frame;
+} LlrTraceWriter;
+
+typedef struct LlrTrace {
+    const LlrTraceHeader *h;
+    const uint32_t *data_pos;
+    const uint8_t *base;
+    size_t size;
+    int mapped;            /* base is an mmap() of the file, else malloc() */
+} LlrTrace;
+
+static inline size_t llr_trace_round(const size_t x, const size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static inline size_t llr_trace_llr_bytes(const LlrTraceHeader *h) {
+    const size_t elem = h->llr_type == LLR_TRACE_FLOAT ? sizeof(float) : 1;
+    return elem * h->N;
+}
+
+static inline size_t llr_trace_ebn0_offset(const LlrTraceHeader *h) {
+    return llr_trace_round(llr_trace_llr_bytes(h) + h->K, sizeof(float));
+}
+
+/* rand() seed: POLAR_SEED if set, else def */
+static inline unsigned llr_trace_seed(const unsigned def) {
+    const char *s = getenv("POLAR_SEED");
+    return s ? (unsigned)strtoul(s, NULL, 0) : def;
+}
+
+/* Starts a trace at path; a NULL path leaves w inactive and is not an error */
+static inline int llr_trace_create(LlrTraceWriter *w, const char *path,
+                                   const LlrTraceType type, const int N,
+                                   const int K, const int crc_l,
+                                   const int maxqr, const float rmax,
+                                   const uint64_t seed, const int *data_pos) {
+    memset(w, 0, sizeof(*w));
+    if (!path) return 0;
+
+    LlrTraceHeader *h = &w->h;
+    memcpy(h->magic, LLR_TRACE_MAGIC, sizeof(h->magic));
+    h->version = LLR_TRACE_VERSION;
+    h->llr_type = (uint32_t)type;
+    h->N = (uint32_t)N;
+    h->K = (uint32_t)K;
+    h->crc_l = (uint32_t)crc_l;
+    h->maxqr = maxqr;
+    h->rmax = rmax;
+    h->frame_bytes = (uint32_t)llr_trace_round(
+        llr_trace_ebn0_offset(h) + sizeof(float), LLR_TRACE_ALIGN);
+    h->seed = seed;
+    h->data_offset = llr_trace_round(
+        sizeof(*h) + sizeof(uint32_t) * (size_t)K, LLR_TRACE_ALIGN);
+
+    w->frame = calloc(h->frame_bytes, 1);
+    w->fp = fopen(path, "wb");
+    if (!w->frame || !w->fp) {
+        fprintf(stderr, "cannot write trace %s\n", path);
+        if (w->fp) fclose(w->fp);
+        free(w->frame);
+        memset(w, 0, sizeof(*w));
+        return -1;
+    }
+
+    uint8_t head[h->data_offset];
+    memset(head, 0, sizeof(head));
+    memcpy(head, h, sizeof(*h));
+    for (int i = 0; i < K; i++) {
+        const uint32_t pos = (uint32_t)data_pos[i];
+        memcpy(&head[sizeof(*h) + sizeof(pos) * (size_t)i], &pos, sizeof(pos));
+    }
+    fwrite(head, 1, sizeof(head), w->fp);
+    return 0;
+}
+
+static inline void llr_trace_put(LlrTraceWriter *w, const float EbN0dB,
+                                 const int *bits) {
+    uint8_t *b = w->frame + llr_trace_llr_bytes(&w->h);
+    for (uint32_t i = 0; i < w->h.K; i++) {
+        b[i] = (uint8_t)(bits[i] != 0);
+    }
+    memcpy(w->frame + llr_trace_ebn0_offset(&w->h), &EbN0dB, sizeof(float));
+    fwrite(w->frame, 1, w->h.frame_bytes, w->fp);
+    w->h.num_frames++;
+}
+
+/* One frame of quantized LLRs (int8 trace) and its K message bits */
+static inline void llr_trace_write_int(LlrTraceWriter *w, const float EbN0dB,
+                                       const int *LLR_Q, const int *bits) {
+    if (!w->fp) return;
+    int8_t *llr = (int8_t *)w->frame;
+    for (uint32_t i = 0; i < w->h.N; i++) {
+        const int q = LLR_Q[i];
+        llr[i] = (int8_t)(q > 127 ? 127 : q < -128 ? -128 : q);
+    }
+    llr_trace_put(w, EbN0dB, bits);
+}
+
+/* One frame of float LLRs (float trace) and its K message bits */
+static inline void llr_trace_write_float(LlrTraceWriter *w,
+                                         const float EbN0dB, const float *LLR,
+                                         const int *bits) {
+    if (!w->fp) return;
+    memcpy(w->frame, LLR, sizeof(float) * w->h.N);
+    llr_trace_put(w, EbN0dB, bits);
+}
+
+/* Writes the frame count into the header and closes the file */
+static inline int llr_trace_finish(LlrTraceWriter *w) {
+    if (!w->fp) return 0;
+    int ret = fseek(w->fp, 0, SEEK_SET) == 0
+                      && fwrite(&w->h, sizeof(w->h), 1, w->fp) == 1
+                  ? 0
+                  : -1;
+    if (fclose(w->fp) != 0) ret = -1;
+    free(w->frame);
+    memset(w, 0, sizeof(*w));
+    return ret;
+}
+
+static inline void llr_trace_close(LlrTrace *t) {
+#if LLR_TRACE_MMAP
+    if (t->mapped) {
+        munmap((void *)t->base, t->size);
+    } else {
+        free((void *)t->base);
+    }
+#else
+    free((void *)t->base);
+#endif
+    memset(t, 0, sizeof(*t));
+}
+
+/* Maps the trace at path read-only and checks its header */
+static inline int llr_trace_open(LlrTrace *t, const char *path) {
+    memset(t, 0, sizeof(*t));
+
+#if LLR_TRACE_MMAP
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "cannot open %s\n", path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    t->size = (size_t)st.st_size;
+    if (t->size >= sizeof(LlrTraceHeader)) {
+        void *p = mmap(NULL, t->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            posix_madvise(p, t->size, POSIX_MADV_SEQUENTIAL);
+            t->base = p;
+            t->mapped = 1;
+        }
+    }
+    close(fd);
+#else
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    const long end = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    t->size = end > 0 ? (size_t)end : 0;
+    if (t->size >= sizeof(LlrTraceHeader)) {
+        void *p = aligned_alloc(LLR_TRACE_ALIGN,
+                                llr_trace_round(t->size, LLR_TRACE_ALIGN));
+        if (p && fread(p, 1, t->size, fp) == t->size) {
+            t->base = p;
+        } else {
+            free(p);
+        }
+    }
+    fclose(fp);
+#endif
+
+    if (!t->base) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        memset(t, 0, sizeof(*t));
+        return -1;
+    }
+
+    const LlrTraceHeader *h = (const LlrTraceHeader *)t->base;
+    if (memcmp(h->magic, LLR_TRACE_MAGIC, sizeof(h->magic)) != 0
+        || h->version != LLR_TRACE_VERSION
+        || h->llr_type > LLR_TRACE_FLOAT || h->K == 0 || h->K > h->N
+        || h->data_offset < sizeof(*h) + sizeof(uint32_t) * h->K
+        || h->frame_bytes < llr_trace_ebn0_offset(h) + sizeof(float)
+        || h->data_offset + h->num_frames * h->frame_bytes > t->size) {
+        fprintf(stderr, "%s: not a trace, or truncated\n", path);
+        llr_trace_close(t);
+        return -1;
+    }
+    t->h = h;
+    t->data_pos = (const uint32_t *)(t->base + sizeof(*h));
+    return 0;
+}
+
+static inline const uint8_t *llr_trace_frame(const LlrTrace *t,
+                                             const uint64_t i) {
+    return t->base + t->h->data_offset + i * t->h->frame_bytes;
+}
+
+/* Frame i in place: int8 or float LLRs, message bits and Eb/N0 */
+static inline const int8_t *llr_trace_llr_i8(const LlrTrace *t,
+                                             const uint64_t i) {
+    return (const int8_t *)llr_trace_frame(t, i);
+}
+
+static inline const float *llr_trace_llr_f32(const LlrTrace *t,
+                                             const uint64_t i) {
+    return (const float *)(const void *)llr_trace_frame(t, i);
+}
+
+static inline const uint8_t *llr_trace_bits(const LlrTrace *t,
+                                            const uint64_t i) {
+    return llr_trace_frame(t, i) + llr_trace_llr_bytes(t->h);
+}
+
+static inline float llr_trace_ebn0(const LlrTrace *t, const uint64_t i) {
+    float EbN0dB;
+    memcpy(&EbN0dB, llr_trace_frame(t, i) + llr_trace_ebn0_offset(t->h),
+           sizeof(EbN0dB));
+    return EbN0dB;
+}
+
+/* Frame i as int LLRs for the decoders that take them; float traces are
+ * quantized like the simulations, floor(LLR / rmax * maxqr) saturated, with
+ * rmax and maxqr given by the caller */
+static inline void llr_trace_llr_int(const LlrTrace *t, const uint64_t i,
+                                     int *LLR_Q, const float rmax,
+                                     const int maxqr) {
+    if (t->h->llr_type == LLR_TRACE_INT8) {
+        const int8_t *llr = llr_trace_llr_i8(t, i);
+        for (uint32_t j = 0; j < t->h->N; j++) {
+            LLR_Q[j] = llr[j];
+        }
+        return;
+    }
+    const float *llr = llr_trace_llr_f32(t, i);
+    for (uint32_t j = 0; j < t->h->N; j++) {
+        const float x = llr[j] / rmax * (float)maxqr;
+        int q = (int)x - (x < (float)(int)x);
+        q = q > maxqr ? maxqr : q < -(maxqr + 1) ? -(maxqr + 1) : q;
+        LLR_Q[j] = q;
+    }
+}
+
+#endif  // LLR_TRACE_H
@@ -0,0 +1,162 @@
+#ifndef MIN_SUM_H
+#define MIN_SUM_H
+
+/**
+ * @file min_sum.h
+ * @brief Fixed-point min-sum check node kernels (int8 / int16)
+ *
+ * Shared by the LDPC decoders (C/LDPC) and the polar factor graph BP decoder.
+ * Messages are laid out as deg x lanes: row e holds the lanes of edge e, so
+ * every loop over lanes is a contiguous, auto-vectorizable vector op.
+ */
+
+#include <stdint.h>
+
+#define MINSUM_I8_MAX    (127)
+#define MINSUM_I16_MAX   (32767)
+/* Normalized min-sum scales magnitudes by param / 2^MINSUM_NORM_SHIFT */
+#define MINSUM_NORM_SHIFT (3)
+/* Largest number of lanes handled by one check_node_* call */
+#define MINSUM_MAX_LANES (384)
+
+typedef enum {
+    MINSUM_OFFSET = 0,    /* |m| = max(min - param, 0) */
+    MINSUM_NORMALIZED = 1 /* |m| = round(min * param / 2^MINSUM_NORM_SHIFT) */
+} MinSumVariant;
+
+static inline int8_t sat_i8(const int x) {
+    return (int8_t)(x > MINSUM_I8_MAX ? MINSUM_I8_MAX
+                    : x < -MINSUM_I8_MAX ? -MINSUM_I8_MAX
+                                         : x);
+}
+
+static inline int16_t sat_i16(const int x) {
+    return (int16_t)(x > MINSUM_I16_MAX ? MINSUM_I16_MAX
+                     : x < -MINSUM_I16_MAX ? -MINSUM_I16_MAX
+                                           : x);
+}
+
+static inline int minsum_correct(const int mag, const MinSumVariant variant,
+                                 const int param) {
+    if (variant == MINSUM_NORMALIZED) {
+        const int round = 1 << (MINSUM_NORM_SHIFT - 1);
+        return (mag * param + round) >> MINSUM_NORM_SHIFT;
+    }
+    return mag > param ? mag - param : 0;
+}
+
+/* Quantize float LLRs: q = round(LLR * scale) saturated to +-qmax */
+static inline void quantize_i8(const float *LLR, int8_t *q, const int n,
+                               const float scale, const int qmax) {
+    for (int i = 0; i < n; i++) {
+        const float v = LLR[i] * scale;
+        const int r = (int)(v < 0 ? v - 0.5f : v + 0.5f);
+        q[i] = (int8_t)(r > qmax ? qmax : r < -qmax ? -qmax : r);
+    }
+}
+
+static inline void quantize_i16(const float *LLR, int16_t *q, const int n,
+                                const float scale, const int qmax) {
+    for (int i = 0; i < n; i++) {
+        const float v = LLR[i] * scale;
+        const int r = (int)(v < 0 ? v - 0.5f : v + 0.5f);
+        q[i] = (int16_t)(r > qmax ? qmax : r < -qmax ? -qmax : r);
+    }
+}
+
+/* Check node update of degree deg over lanes parallel checks, in place:
+ * msg holds the variable to check messages on entry and the check to variable
+ * messages on return. min1/min2/index/sign-product per lane. Inputs lie in
+ * +-MINSUM_I*_MAX; a normalized scale above 1 saturates there. */
+static inline void check_node_i8(int8_t *msg, const int deg, const int lanes,
+                                 const MinSumVariant variant,
+                                 const int param) {
+    int8_t min1[MINSUM_MAX_LANES], min2[MINSUM_MAX_LANES];
+    uint8_t idx1[MINSUM_MAX_LANES], sign[MINSUM_MAX_LANES];
+
+    for (int z = 0; z < lanes; z++) {
+        min1[z] = MINSUM_I8_MAX;
+        min2[z] = MINSUM_I8_MAX;
+        idx1[z] = 0;
+        sign[z] = 0;
+    }
+
+    for (int e = 0; e < deg; e++) {
+        const int8_t *m = &msg[e * lanes];
+        for (int z = 0; z < lanes; z++) {
+            const int8_t mag = (int8_t)(m[z] < 0 ? -m[z] : m[z]);
+            sign[z] ^= (uint8_t)(m[z] < 0);
+            min2[z] = mag < min1[z] ? min1[z] : mag < min2[z] ? mag : min2[z];
+            idx1[z] = mag < min1[z] ? (uint8_t)e : idx1[z];
+            min1[z] = mag < min1[z] ? mag : min1[z];
+        }
+    }
+
+    for (int z = 0; z < lanes; z++) {
+        min1[z] = sat_i8(minsum_correct(min1[z], variant, param));
+        min2[z] = sat_i8(minsum_correct(min2[z], variant, param));
+    }
+
+    for (int e = 0; e < deg; e++) {
+        int8_t *m = &msg[e * lanes];
+        for (int z = 0; z < lanes; z++) {
+            const int8_t mag = idx1[z] == e ? min2[z] : min1[z];
+            m[z] = (int8_t)((sign[z] ^ (m[z] < 0)) ? -mag : mag);
+        }
+    }
+}
+
+static inline void check_node_i16(int16_t *msg, const int deg,
+                                  const int lanes,
+                                  const MinSumVariant variant,
+                                  const int param) {
+    int16_t min1[MINSUM_MAX_LANES], min2[MINSUM_MAX_LANES];
+    uint8_t idx1[MINSUM_MAX_LANES], sign[MINSUM_MAX_LANES];
+
+    for (int z = 0; z < lanes; z++) {
+        min1[z] = MINSUM_I16_MAX;
+        min2[z] = MINSUM_I16_MAX;
+        idx1[z] = 0;
+        sign[z] = 0;
+    }
+
+    for (int e = 0; e < deg; e++) {
+        const int16_t *m = &msg[e * lanes];
+        for (int z = 0; z < lanes; z++) {
+            const int16_t mag = (int16_t)(m[z] < 0 ? -m[z] : m[z]);
+            sign[z] ^= (uint8_t)(m[z] < 0);
+            min2[z] = mag < min1[z] ? min1[z] : mag < min2[z] ? mag : min2[z];
+            idx1[z] = mag < min1[z] ? (uint8_t)e : idx1[z];
+            min1[z] = mag < min1[z] ? mag : min1[z];
+        }
+    }
+
+    for (int z = 0; z < lanes; z++) {
+        min1[z] = sat_i16(minsum_correct(min1[z], variant, param));
+        min2[z] = sat_i16(minsum_correct(min2[z], variant, param));
+    }
+
+    for (int e = 0; e < deg; e++) {
+        int16_t *m = &msg[e * lanes];
+        for (int z = 0; z < lanes; z++) {
+            const int16_t mag = idx1[z] == e ? min2[z] : min1[z];
+            m[z] = (int16_t)((sign[z] ^ (m[z] < 0)) ? -mag : mag);
+        }
+    }
+}
+
+/* Degree-3 check node (two inputs), the processing element of polar BP:
+ * out[i] = sign(a[i]) * sign(b[i]) * corrected min(|a[i]|, |b[i]|) */
+static inline void boxplus_i16(int16_t *out, const int16_t *a,
+                               const int16_t *b, const int n,
+                               const MinSumVariant variant, const int param) {
+    for (int i = 0; i < n; i++) {
+        const int mag_a = a[i] < 0 ? -a[i] : a[i];
+        const int mag_b = b[i] < 0 ? -b[i] : b[i];
+        const int16_t mag = sat_i16(
+            minsum_correct(mag_a < mag_b ? mag_a : mag_b, variant, param));
+        out[i] = (int16_t)(((a[i] < 0) ^ (b[i] < 0)) ? -mag : mag);
+    }
+}
+
+#endif  // MIN_SUM_H
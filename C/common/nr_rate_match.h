@@ -0,0 +1,262 @@
+#ifndef NR_RATE_MATCH_H
+#define NR_RATE_MATCH_H
+
+/**
+ * @file nr_rate_match.h
+ * @brief 5G NR polar rate matching and de-rate-matching (TS 38.212 5.3.1,
+ *        5.4.1)
+ *
+ * The mother code has N = 2^n >= 32 bits (nr_mother_n()); the channel gets E.
+ * Rate matching is the sub-block interleaver (32 sub-blocks), bit selection
+ * (repetition for E >= N, else puncturing for K/E <= 7/16, else shortening)
+ * and, on the uplink (ibil), the triangular channel interleaver. Together
+ * they send code bit map[k] as the k-th of the E bits; nr_rm_init() builds
+ * map once per (N, K, E, ibil) and nr_info_set() picks the K information
+ * positions the way 5.3.1.2 does, with the bits that rate matching removes
+ * (and, when puncturing, the ones that lose their reliability) frozen.
+ *
+ * Per frame, rate matching gathers e[k] = d[map[k]] and de-rate-matching
+ * scatters the E received LLRs back into the N of the decoder: punctured bits
+ * get LLR 0 (unknown), shortened bits the largest LLR for 0 (they are known
+ * zeros) and repeated bits the sum of their copies, saturated for int LLRs.
+ * Neither does any index arithmetic beyond the table lookups.
+ *
+ * Positive LLRs favour 0, as with the BPSK mapping 1 - 2u of the simulations.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NR_SUBBLOCKS (32)
+
+typedef enum NrRmMode {
+    NR_RM_REPETITION = 0,
+    NR_RM_PUNCTURING = 1,
+    NR_RM_SHORTENING = 2
+} NrRmMode;
+
+typedef struct NrRateMatch {
+    int N;
+    int K;        /* information bits, CRC included */
+    int E;
+    int ibil;     /* channel interleaver on (uplink) */
+    NrRmMode mode;
+    int *map;     /* E: code bit sent as rate-matched bit k */
+    int *unsent;  /* num_unsent: code bits punctured or shortened */
+    int num_unsent;
+} NrRateMatch;
+
+/* Sub-block interleaver pattern P(i), Table 5.4.1.1-1 */
+static const int nr_subblock_pattern[NR_SUBBLOCKS] = {
+    0,  1,  2,  4,  3,  5,  6,  7,  8,  16, 9,  17, 10, 18, 11, 19,
+    12, 20, 13, 21, 14, 22, 15, 23, 24, 25, 26, 28, 27, 29, 30, 31};
+
+/* J(i): the code bit at position i after sub-block interleaving */
+static inline int nr_subblock_index(const int N, const int i) {
+    const int B = N / NR_SUBBLOCKS;
+    return nr_subblock_pattern[i / B] * B + i % B;
+}
+
+/* log2 of the mother code length, 5.3.1: n_max is 9 on the downlink (PBCH,
+ * PDCCH) and 10 on the uplink (PUCCH, PUSCH) */
+static inline int nr_mother_n(const int K, const int E, const int n_max) {
+    int log_E = 0;
+    while ((1 << log_E) < E) log_E++;
+    int n1 = log_E;
+    if (log_E > 0 && 8 * E <= 9 * (1 << (log_E - 1)) && 16 * K < 9 * E) {
+        n1 = log_E - 1;
+    }
+    int n2 = 0;
+    while ((1 << n2) < 8 * K) n2++; /* R_min = 1/8 */
+    int n = n1 < n2 ? n1 : n2;
+    n = n < n_max ? n : n_max;
+    return n > 5 ? n : 5;
+}
+
+static inline void nr_rm_free(NrRateMatch *rm) {
+    free(rm->map);
+    free(rm->unsent);
+    memset(rm, 0, sizeof(*rm));
+}
+
+/* Tables for N = 2^n >= 32, 0 < K < N and E > 0; 0 or -1 */
+static inline int nr_rm_init(NrRateMatch *rm, const int N, const int K,
+                             const int E, const int ibil) {
+    memset(rm, 0, sizeof(*rm));
+    if (N < NR_SUBBLOCKS || (N & (N - 1)) != 0 || K <= 0 || K >= N
+        || E <= 0) {
+        return -1;
+    }
+    rm->N = N;
+    rm->K = K;
+    rm->E = E;
+    rm->ibil = ibil;
+    if (E >= N) {
+        rm->mode = NR_RM_REPETITION;
+    } else if (16 * K <= 7 * E) {
+        rm->mode = NR_RM_PUNCTURING;
+    } else {
+        rm->mode = NR_RM_SHORTENING;
+    }
+
+    rm->map = malloc(sizeof(int) * (size_t)E);
+    rm->num_unsent = E < N ? N - E : 0;
+    rm->unsent = malloc(sizeof(int) * (size_t)(rm->num_unsent + 1));
+    int *sel = malloc(sizeof(int) * (size_t)E);
+    if (!rm->map || !rm->unsent || !sel) {
+        free(sel);
+        nr_rm_free(rm);
+        return -1;
+    }
+
+    /* Bit selection, 5.4.1.2: e_k = y_sel[k], y_i = d_J(i) */
+    const int first = rm->mode == NR_RM_PUNCTURING ? N - E : 0;
+    for (int k = 0; k < E; k++) {
+        sel[k] = nr_subblock_index(N, (first + k) % N);
+    }
+    for (int i = 0; i < rm->num_unsent; i++) {
+        rm->unsent[i] = nr_subblock_index(
+            N, rm->mode == NR_RM_PUNCTURING ? i : E + i);
+    }
+
+    if (!ibil) {
+        memcpy(rm->map, sel, sizeof(int) * (size_t)E);
+        free(sel);
+        return 0;
+    }
+
+    /* Channel interleaver, 5.4.1.3: e written row by row into the upper
+     * triangle of a T x T matrix, read column by column */
+    int T = 0;
+    while (T * (T + 1) / 2 < E) T++;
+    int *v = malloc(sizeof(int) * (size_t)T * (size_t)T);
+    if (!v) {
+        free(sel);
+        nr_rm_free(rm);
+        return -1;
+    }
+    int k = 0;
+    for (int i = 0; i < T; i++) {
+        for (int j = 0; j < T - i; j++) {
+            v[i * T + j] = k < E ? k : -1;
+            k++;
+        }
+    }
+    k = 0;
+    for (int j = 0; j < T; j++) {
+        for (int i = 0; i < T - j; i++) {
+            if (v[i * T + j] >= 0) rm->map[k++] = sel[v[i * T + j]];
+        }
+    }
+    free(v);
+    free(sel);
+    return 0;
+}
+
+/* Information set, 5.3.1.2: the K most reliable positions outside the ones
+ * rate matching removes. Q is the reliability sequence of N (ascending, the
+ * Q of the simulations without the entries >= N). data_pos gets them least
+ * reliable first as in the simulations, info_nodes the N flags. 0 or -1 */
+static inline int nr_info_set(const NrRateMatch *rm, const int *Q,
+                              int *data_pos, int *info_nodes) {
+    const int N = rm->N, E = rm->E;
+    /* info_nodes first marks the pre-frozen positions with -1 */
+    for (int i = 0; i < N; i++) {
+        info_nodes[i] = 0;
+    }
+    for (int i = 0; i < rm->num_unsent; i++) {
+        info_nodes[rm->unsent[i]] = -1;
+    }
+    if (rm->mode == NR_RM_PUNCTURING) {
+        /* ceil(3N/4 - E/2) or ceil(9N/16 - E/4) natural positions */
+        const int low = E >= 3 * N / 4 ? (3 * N - 2 * E + 3) / 4
+                                       : (9 * N - 4 * E + 15) / 16;
+        for (int i = 0; i < low && i < N; i++) {
+            info_nodes[i] = -1;
+        }
+    }
+
+    int found = 0;
+    for (int i_Q = N - 1; i_Q >= 0 && found < rm->K; i_Q--) {
+        if (info_nodes[Q[i_Q]] == 0) {
+            data_pos[rm->K - 1 - found] = Q[i_Q];
+            info_nodes[Q[i_Q]] = 1;
+            found++;
+        }
+    }
+    for (int i = 0; i < N; i++) {
+        info_nodes[i] = info_nodes[i] == 1;
+    }
+    return found == rm->K ? 0 : -1;
+}
+
+/* E rate-matched bits of the N code bits d */
+static inline void nr_rate_match(const NrRateMatch *rm, const int *d,
+                                 int *e) {
+    for (int k = 0; k < rm->E; k++) {
+        e[k] = d[rm->map[k]];
+    }
+}
+
+/* N decoder LLRs from E received ones; repeated LLRs saturate at
+ * -(llr_max + 1) ... llr_max, shortened bits get llr_max */
+static inline void nr_derate_match_int(const NrRateMatch *rm, const int *llr,
+                                       int *LLR_Q, const int llr_max) {
+    const int *map = rm->map;
+    switch (rm->mode) {
+    case NR_RM_REPETITION:
+        memset(LLR_Q, 0, sizeof(int) * (size_t)rm->N);
+        for (int k = 0; k < rm->E; k++) {
+            const int s = LLR_Q[map[k]] + llr[k];
+            LLR_Q[map[k]] = s > llr_max ? llr_max
+                            : s < -(llr_max + 1) ? -(llr_max + 1)
+                                                 : s;
+        }
+        break;
+    case NR_RM_PUNCTURING:
+        for (int i = 0; i < rm->num_unsent; i++) {
+            LLR_Q[rm->unsent[i]] = 0;
+        }
+        for (int k = 0; k < rm->E; k++) {
+            LLR_Q[map[k]] = llr[k];
+        }
+        break;
+    default:
+        for (int i = 0; i < rm->num_unsent; i++) {
+            LLR_Q[rm->unsent[i]] = llr_max;
+        }
+        for (int k = 0; k < rm->E; k++) {
+            LLR_Q[map[k]] = llr[k];
+        }
+        break;
+    }
+}
+
+/* The same for float LLRs; shortened bits get shortened_llr */
+static inline void nr_derate_match_float(const NrRateMatch *rm,
+                                         const float *llr, float *LLR,
+                                         const float shortened_llr) {
+    const int *map = rm->map;
+    switch (rm->mode) {
+    case NR_RM_REPETITION:
+        for (int i = 0; i < rm->N; i++) {
+            LLR[i] = 0;
+        }
+        for (int k = 0; k < rm->E; k++) {
+            LLR[map[k]] += llr[k];
+        }
+        break;
+    default:
+        for (int i = 0; i < rm->num_unsent; i++) {
+            LLR[rm->unsent[i]] =
+                rm->mode == NR_RM_PUNCTURING ? 0.0f : shortened_llr;
+        }
+        for (int k = 0; k < rm->E; k++) {
+            LLR[map[k]] = llr[k];
+        }
+        break;
+    }
+}
+
+#endif  // NR_RATE_MATCH_H
@@ -0,0 +1,249 @@
+#ifndef PMU_H
+#define PMU_H
+
+/**
+ * @file pmu.h
+ * @brief Hardware performance counters around the decode call
+ *
+ * Counts cycles, instructions, L1D read misses, last level cache misses,
+ * branch mispredictions and the task clock with perf_event_open (Linux) and
+ * reports them per decoded info bit, the unit to compare layouts with.
+ * Each event is its own leader so that the kernel can multiplex them on a
+ * PMU with few counters; counts are scaled by time enabled / time running.
+ * There is no generic L2 event, the last level cache stands in for it.
+ *
+ * Containers and VMs often have no PMU or forbid perf_event_open: events that
+ * do not open are reported as n/a and, if none opens, one line says why.
+ * Decoding is not affected. Other systems (and strict ISO C builds, which
+ * lack syscall()) get the same "unavailable" line.
+ *
+ * pmu_open / pmu_start / pmu_stop / pmu_print / pmu_reset / pmu_close can be
+ * used directly (bench_scl). The simulations use the PMU_* macros, which are
+ * compiled out unless POLAR_PERF is defined, like PROF_* in prof.h.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* syscall() needs the glibc default (or GNU) feature set, not strict ISO C */
+#if defined(__linux__) && (defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE))
+#define PMU_PERF_EVENT 1
+#else
+#define PMU_PERF_EVENT 0
+#endif
+
+#if PMU_PERF_EVENT
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef enum PmuEvent {
+    PMU_CYCLES,
+    PMU_INSTRUCTIONS,
+    PMU_L1D_MISSES,
+    PMU_LLC_MISSES,
+    PMU_BRANCH_MISSES,
+    PMU_TASK_CLOCK, /* ns, a software event: often there without a PMU */
+    PMU_NUM_EVENTS
+} PmuEvent;
+
+typedef struct PmuCounters {
+    int fd[PMU_NUM_EVENTS]; /* -1 if the event did not open */
+    int num_open;
+    int err;                /* errno of the first event that did not open */
+    int opened;             /* pmu_open() was called */
+    uint64_t frames;
+    uint64_t bits;          /* info bits decoded between start and stop */
+} PmuCounters;
+
+#if PMU_PERF_EVENT
+
+static inline int pmu_event_open(const uint32_t type, const uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; /* allowed at perf_event_paranoid 2 */
+    attr.exclude_hv = 1;
+    attr.read_format
+        = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Opens what it can, returns the number of events that opened */
+static inline int pmu_open(PmuCounters *pc) {
+    static const uint32_t type[PMU_NUM_EVENTS] = {PERF_TYPE_HARDWARE,
+                                                  PERF_TYPE_HARDWARE,
+                                                  PERF_TYPE_HW_CACHE,
+                                                  PERF_TYPE_HARDWARE,
+                                                  PERF_TYPE_HARDWARE,
+                                                  PERF_TYPE_SOFTWARE};
+    static const uint64_t config[PMU_NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_SW_TASK_CLOCK};
+
+    memset(pc, 0, sizeof(*pc));
+    pc->opened = 1;
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        pc->fd[e] = pmu_event_open(type[e], config[e]);
+        if (pc->fd[e] >= 0) {
+            pc->num_open++;
+        } else if (pc->err == 0) {
+            pc->err = errno;
+        }
+    }
+    return pc->num_open;
+}
+
+/* One prctl enables or disables all the counters this process opened */
+static inline void pmu_start(const PmuCounters *pc) {
+    if (pc->num_open > 0) prctl(PR_TASK_PERF_EVENTS_ENABLE);
+}
+
+static inline void pmu_stop(PmuCounters *pc, const uint64_t bits) {
+    if (pc->num_open > 0) prctl(PR_TASK_PERF_EVENTS_DISABLE);
+    pc->frames++;
+    pc->bits += bits;
+}
+
+/* Count of event e scaled for multiplexing, -1 if not available */
+static inline double pmu_value(const PmuCounters *pc, const PmuEvent e) {
+    uint64_t buf[3]; /* value, time enabled, time running */
+    if (pc->fd[e] < 0 || read(pc->fd[e], buf, sizeof(buf)) != sizeof(buf)) {
+        return -1.0;
+    }
+    if (buf[2] == 0) return buf[1] == 0 ? 0.0 : -1.0;
+    return (double)buf[0] * ((double)buf[1] / (double)buf[2]);
+}
+
+static inline void pmu_reset(PmuCounters *pc) {
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) ioctl(pc->fd[e], PERF_EVENT_IOC_RESET, 0);
+    }
+    pc->frames = 0;
+    pc->bits = 0;
+}
+
+static inline void pmu_close(PmuCounters *pc) {
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        if (pc->fd[e] >= 0) close(pc->fd[e]);
+        pc->fd[e] = -1;
+    }
+    pc->num_open = 0;
+}
+
+#else
+
+static inline int pmu_open(PmuCounters *pc) {
+    memset(pc, 0, sizeof(*pc));
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) pc->fd[e] = -1;
+    pc->opened = 1;
+    pc->err = -1;
+    return 0;
+}
+static inline void pmu_start(const PmuCounters *pc) { (void)pc; }
+static inline void pmu_stop(PmuCounters *pc, const uint64_t bits) {
+    pc->frames++;
+    pc->bits += bits;
+}
+static inline double pmu_value(const PmuCounters *pc, const PmuEvent e) {
+    (void)pc;
+    (void)e;
+    return -1.0;
+}
+static inline void pmu_reset(PmuCounters *pc) {
+    pc->frames = 0;
+    pc->bits = 0;
+}
+static inline void pmu_close(PmuCounters *pc) { (void)pc; }
+
+#endif  // PMU_PERF_EVENT
+
+/* "%8.3f" of v / bits, or n/a */
+static inline const char *pmu_per_bit(char *buf, const size_t size,
+                                      const double v, const uint64_t bits) {
+    if (v < 0 || bits == 0) {
+        snprintf(buf, size, "%8s", "n/a");
+    } else {
+        snprintf(buf, size, "%8.3f", v / (double)bits);
+    }
+    return buf;
+}
+
+/* One line of counters per info bit and the IPC, or why there are none */
+static inline void pmu_print(FILE *fp, const char *label,
+                             const PmuCounters *pc) {
+    if (pc->frames == 0) return;
+    if (pc->num_open == 0) {
+        fprintf(fp,
+                "  pmu     %-24s counters unavailable (%s)\n",
+                label,
+                pc->err > 0 ? strerror(pc->err) : "no perf_event_open");
+        return;
+    }
+
+    double v[PMU_NUM_EVENTS];
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        v[e] = pmu_value(pc, (PmuEvent)e);
+    }
+    char ipc[16], b[PMU_NUM_EVENTS][16];
+    if (v[PMU_CYCLES] > 0 && v[PMU_INSTRUCTIONS] >= 0) {
+        snprintf(ipc, sizeof(ipc), "%5.2f",
+                 v[PMU_INSTRUCTIONS] / v[PMU_CYCLES]);
+    } else {
+        snprintf(ipc, sizeof(ipc), "%5s", "n/a");
+    }
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        pmu_per_bit(b[e], sizeof(b[e]), v[e], pc->bits);
+    }
+    fprintf(fp,
+            "  pmu     %-24s per info bit: insn %s  cycles %s  IPC %s  "
+            "L1D miss %s  LLC miss %s  br miss %s  task ns %s%s%s\n",
+            label,
+            b[PMU_INSTRUCTIONS],
+            b[PMU_CYCLES],
+            ipc,
+            b[PMU_L1D_MISSES],
+            b[PMU_LLC_MISSES],
+            b[PMU_BRANCH_MISSES],
+            b[PMU_TASK_CLOCK],
+            pc->num_open < PMU_NUM_EVENTS ? "  n/a: " : "",
+            pc->num_open < PMU_NUM_EVENTS ? strerror(pc->err) : "");
+}
+
+#ifdef POLAR_PERF
+
+static PmuCounters pmu_counters;
+
+/* Opens the counters on first use */
+#define PMU_START()                                                  \
+    do {                                                             \
+        if (!pmu_counters.opened) pmu_open(&pmu_counters);           \
+        pmu_start(&pmu_counters);                                    \
+    } while (0)
+#define PMU_STOP(bits)     pmu_stop(&pmu_counters, (uint64_t)(bits))
+#define PMU_REPORT(label)  pmu_print(stdout, (label), &pmu_counters)
+#define PMU_RESET()        pmu_reset(&pmu_counters)
+
+#else
+
+#define PMU_START()       ((void)0)
+#define PMU_STOP(bits)    ((void)0)
+#define PMU_REPORT(label) ((void)0)
+#define PMU_RESET()       ((void)0)
+
+#endif  // POLAR_PERF
+
+#endif  // PMU_H
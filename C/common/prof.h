@@ -0,0 +1,235 @@
+#ifndef PROF_H
+#define PROF_H
+
+/**
+ * @file prof.h
+ * @brief Optional cycle counters per operation class and tree depth
+ *
+ * Compiled out unless POLAR_PROF is defined. With it, the decoders bracket
+ * their operations with PROF_START / PROF_STOP, which add the elapsed ticks
+ * (rdtsc on x86, cntvct_el0 on AArch64, CLOCK_MONOTONIC ns elsewhere) and a
+ * call to prof_table[op][depth], where depth is that of the node written
+ * (the child for f and g, the parent for combine). The simulation calls
+ * PROF_REPORT(name) at the end to print the table and write it to
+ * <name>_prof.csv.
+ *
+ * Sort and path copy are timed inside the node that does them, so they are
+ * a breakdown of the node classes, not additional time. The cost of one
+ * start/stop pair is measured when reporting and subtracted per call.
+ *
+ * Exactly one translation unit, the decoder, defines PROF_IMPLEMENTATION
+ * before including this header to hold the table and prof_report().
+ *
+ * prof_table is thread-local, so decoders running on several threads (the
+ * pipelined SSCD simulation, the decode service) count without sharing a
+ * line. A thread that decoded adds its table to the process total with
+ * PROF_THREAD_END() before it exits; prof_report() adds that of the calling
+ * thread and reports the total.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum ProfOp {
+    PROF_F,
+    PROF_G,
+    PROF_COMBINE,
+    PROF_RATE0,
+    PROF_RATE1,
+    PROF_REP,
+    PROF_SPC,
+    PROF_LEAF,
+    PROF_SORT,      /* inside the node classes */
+    PROF_PATH_COPY, /* inside the node classes */
+    PROF_NUM_OPS
+} ProfOp;
+
+#define PROF_MAX_DEPTH (32)
+
+#ifdef POLAR_PROF
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t prof_ticks(void) { return (uint64_t)__rdtsc(); }
+#elif defined(__aarch64__)
+static inline uint64_t prof_ticks(void) {
+    uint64_t t;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+}
+#else
+#include <time.h>
+static inline uint64_t prof_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+typedef struct ProfTable {
+    uint64_t ticks[PROF_NUM_OPS][PROF_MAX_DEPTH];
+    uint64_t calls[PROF_NUM_OPS][PROF_MAX_DEPTH];
+    uint64_t frames;
+} ProfTable;
+
+extern _Thread_local ProfTable prof_table;
+
+void prof_flush(void);
+void prof_report(FILE *fp, const char *csv_path);
+
+static inline void prof_add(const ProfOp op, const unsigned depth,
+                            const uint64_t ticks) {
+    prof_table.ticks[op][depth] += ticks;
+    prof_table.calls[op][depth]++;
+}
+
+#define PROF_START(t)           const uint64_t t = prof_ticks()
+#define PROF_STOP(t, op, depth) prof_add((op), (unsigned)(depth), \
+                                         prof_ticks() - (t))
+#define PROF_FRAME()            (prof_table.frames++)
+#define PROF_THREAD_END()       prof_flush()
+#define PROF_REPORT(name)       prof_report(stdout, name "_prof.csv")
+
+#ifdef PROF_IMPLEMENTATION
+
+#include <stdatomic.h>
+#include <string.h>
+
+_Thread_local ProfTable prof_table;
+
+/* Sum of the flushed thread tables, under prof_lock */
+static ProfTable prof_total;
+static atomic_flag prof_lock = ATOMIC_FLAG_INIT;
+
+/* The calling thread's table into the total, and cleared */
+void prof_flush(void) {
+    while (atomic_flag_test_and_set_explicit(&prof_lock,
+                                             memory_order_acquire)) {
+    }
+    for (int op = 0; op < PROF_NUM_OPS; op++) {
+        for (unsigned d = 0; d < PROF_MAX_DEPTH; d++) {
+            prof_total.ticks[op][d] += prof_table.ticks[op][d];
+            prof_total.calls[op][d] += prof_table.calls[op][d];
+        }
+    }
+    prof_total.frames += prof_table.frames;
+    atomic_flag_clear_explicit(&prof_lock, memory_order_release);
+    memset(&prof_table, 0, sizeof(prof_table));
+}
+
+static const char *const prof_op_name[PROF_NUM_OPS] = {
+    "f", "g", "combine", "rate0", "rate1", "rep", "spc", "leaf", "sort",
+    "path_copy"};
+
+/* Ticks of an empty start/stop pair, the least of a few tries */
+static uint64_t prof_overhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        const uint64_t t0 = prof_ticks();
+        const uint64_t t1 = prof_ticks();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+static uint64_t prof_net(const ProfOp op, const unsigned d,
+                         const uint64_t overhead) {
+    const uint64_t cost = prof_total.calls[op][d] * overhead;
+    return prof_total.ticks[op][d] > cost ? prof_total.ticks[op][d] - cost : 0;
+}
+
+/* Table per operation class and depth to fp, the same rows as CSV to
+ * csv_path (if not NULL); the threads that decoded have flushed */
+void prof_report(FILE *fp, const char *csv_path) {
+    prof_flush();
+    const uint64_t overhead = prof_overhead();
+    const double frames = prof_total.frames > 0 ? (double)prof_total.frames
+                                                : 1.0;
+
+    uint64_t total = 0;
+    for (int op = 0; op < PROF_SORT; op++) {
+        for (unsigned d = 0; d < PROF_MAX_DEPTH; d++) {
+            total += prof_net((ProfOp)op, d, overhead);
+        }
+    }
+
+    FILE *csv = csv_path ? fopen(csv_path, "w") : NULL;
+    if (csv) {
+        fprintf(csv, "op,depth,calls,ticks,ticks_per_call,ticks_per_frame\n");
+    }
+
+    fprintf(fp,
+            "\nProfile: %.0f frames, %.0f ticks per frame, %llu ticks per "
+            "timer subtracted\n",
+            frames,
+            (double)total / frames,
+            (unsigned long long)overhead);
+    fprintf(fp,
+            "%-10s %5s %12s %14s %10s %12s %6s\n",
+            "op",
+            "depth",
+            "calls",
+            "ticks",
+            "per call",
+            "per frame",
+            "%");
+
+    for (int op = 0; op < PROF_NUM_OPS; op++) {
+        uint64_t op_calls = 0, op_ticks = 0;
+        for (unsigned d = 0; d < PROF_MAX_DEPTH; d++) {
+            const uint64_t calls = prof_total.calls[op][d];
+            if (calls == 0) continue;
+            const uint64_t ticks = prof_net((ProfOp)op, d, overhead);
+            op_calls += calls;
+            op_ticks += ticks;
+
+            fprintf(fp,
+                    "%-10s %5u %12llu %14llu %10.1f %12.1f %6.2f\n",
+                    prof_op_name[op],
+                    d,
+                    (unsigned long long)calls,
+                    (unsigned long long)ticks,
+                    (double)ticks / (double)calls,
+                    (double)ticks / frames,
+                    total ? 100.0 * (double)ticks / (double)total : 0.0);
+            if (csv) {
+                fprintf(csv,
+                        "%s,%u,%llu,%llu,%.1f,%.1f\n",
+                        prof_op_name[op],
+                        d,
+                        (unsigned long long)calls,
+                        (unsigned long long)ticks,
+                        (double)ticks / (double)calls,
+                        (double)ticks / frames);
+            }
+        }
+        if (op_calls > 0) {
+            fprintf(fp,
+                    "%-10s %5s %12llu %14llu %10.1f %12.1f %6.2f%s\n",
+                    prof_op_name[op],
+                    "all",
+                    (unsigned long long)op_calls,
+                    (unsigned long long)op_ticks,
+                    (double)op_ticks / (double)op_calls,
+                    (double)op_ticks / frames,
+                    total ? 100.0 * (double)op_ticks / (double)total : 0.0,
+                    op >= PROF_SORT ? "  (part of the nodes above)" : "");
+        }
+    }
+
+    if (csv) fclose(csv);
+}
+
+#endif  // PROF_IMPLEMENTATION
+
+#else
+
+#define PROF_START(t)           ((void)0)
+#define PROF_STOP(t, op, depth) ((void)0)
+#define PROF_FRAME()            ((void)0)
+#define PROF_THREAD_END()       ((void)0)
+#define PROF_REPORT(name)       ((void)0)
+
+#endif  // POLAR_PROF
+
+#endif  // PROF_H
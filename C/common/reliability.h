@@ -0,0 +1,64 @@
+#ifndef RELIABILITY_H
+#define RELIABILITY_H
+
+/**
+ * @file reliability.h
+ * @brief Reliability sequences (the Q tables of the simulations) as text
+ *
+ * A sequence lists the N bit indices in increasing reliability, whitespace
+ * separated: the frozen set is its first N - K entries, data_pos the rest.
+ * C/regression/genie_construct estimates one for a given N and Eb/N0, and
+ * the simulations take it in place of their hard-coded Q when POLAR_Q names
+ * a file (rel_order_env()).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The N indices of path into Q; -1 unless they are a permutation of 0..N-1 */
+static inline int rel_order_read(const char *path, const int N, int *Q) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    char *seen = calloc((size_t)N, 1);
+    int count = 0, extra = 0, v;
+    while (seen && fscanf(fp, "%d", &v) == 1) {
+        if (count == N || v < 0 || v >= N || seen[v]) {
+            extra = 1;
+            break;
+        }
+        seen[v] = 1;
+        Q[count++] = v;
+    }
+    fclose(fp);
+    free(seen);
+    if (count != N || extra) {
+        fprintf(stderr, "%s: not a permutation of 0..%d\n", path, N - 1);
+        return -1;
+    }
+    return 0;
+}
+
+/* Q space separated on one line */
+static inline int rel_order_write(FILE *fp, const int N, const int *Q) {
+    for (int i = 0; i < N; i++) {
+        if (fprintf(fp, i + 1 < N ? "%d " : "%d\n", Q[i]) < 0) return -1;
+    }
+    return 0;
+}
+
+/* Q from the file POLAR_Q names, unchanged when it is not set; 0 or -1 */
+static inline int rel_order_env(const int N, int *Q) {
+    const char *path = getenv("POLAR_Q");
+    if (!path) return 0;
+    int *tmp = malloc(sizeof(int) * (size_t)N);
+    const int ret = tmp ? rel_order_read(path, N, tmp) : -1;
+    if (ret == 0) memcpy(Q, tmp, sizeof(int) * (size_t)N);
+    free(tmp);
+    return ret;
+}
+
+#endif  // RELIABILITY_H
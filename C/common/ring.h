@@ -0,0 +1,236 @@
+#ifndef RING_H
+#define RING_H
+
+/**
+ * @file ring.h
+ * @brief Lock-free rings of frame slot indices for pipelined simulations
+ *
+ * A pipelined simulation preallocates a pool of frame slots and passes their
+ * indices from stage to stage; a slot index goes back to the free ring after
+ * the last stage, so the pool size bounds the frames in flight and a stage
+ * that runs ahead blocks on its output (back-pressure) instead of allocating.
+ *
+ * SpscRing links two single-threaded stages: head and tail on their own cache
+ * lines, each side caching the other's index so that most operations touch
+ * no shared line. MpmcRing is Vyukov's bounded queue, one sequence number per
+ * cell, for stages run by several threads and for the free ring.
+ *
+ * The blocking push / pop spin briefly, then yield the CPU (the pipeline may
+ * have more threads than cores), and add the time waited to a StageStats:
+ * starved on an empty input, blocked on a full output. RING_EOS travels like
+ * a slot index and tells a stage that its input has ended.
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "latency.h"
+
+/* sched_yield() needs POSIX, strict ISO C builds only spin */
+#if defined(__unix__) && (defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE) \
+                          || defined(_POSIX_C_SOURCE))
+#include <sched.h>
+#define ring_yield() sched_yield()
+#else
+#define ring_yield() ((void)0)
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ring_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define ring_relax() __asm__ volatile("yield")
+#else
+#define ring_relax() ((void)0)
+#endif
+
+#define RING_CACHE_LINE (64)
+#define RING_SPINS      (128) /* before yielding */
+#define RING_EOS        (UINT32_MAX)
+
+/* Wall time of one stage, summed over its threads */
+typedef struct StageStats {
+    uint64_t items;
+    uint64_t busy_ns;    /* working on items */
+    uint64_t starved_ns; /* waiting for input */
+    uint64_t blocked_ns; /* waiting for room downstream */
+} StageStats;
+
+typedef struct SpscRing {
+    _Alignas(RING_CACHE_LINE) _Atomic uint32_t head; /* consumer */
+    uint32_t tail_cache;
+    _Alignas(RING_CACHE_LINE) _Atomic uint32_t tail; /* producer */
+    uint32_t head_cache;
+    _Alignas(RING_CACHE_LINE) uint32_t mask;
+    uint32_t *slot;
+} SpscRing;
+
+typedef struct MpmcCell {
+    _Atomic uint32_t seq;
+    uint32_t value;
+} MpmcCell;
+
+typedef struct MpmcRing {
+    _Alignas(RING_CACHE_LINE) _Atomic uint32_t enq;
+    _Alignas(RING_CACHE_LINE) _Atomic uint32_t deq;
+    _Alignas(RING_CACHE_LINE) uint32_t mask;
+    MpmcCell *cell;
+} MpmcRing;
+
+/* Capacity a power of 2; 0 or -1 */
+static inline int spsc_init(SpscRing *r, const uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return -1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->tail_cache = 0;
+    r->head_cache = 0;
+    r->mask = capacity - 1;
+    r->slot = malloc(sizeof(uint32_t) * capacity);
+    return r->slot ? 0 : -1;
+}
+
+static inline void spsc_free(SpscRing *r) {
+    free(r->slot);
+    r->slot = NULL;
+}
+
+static inline int spsc_try_push(SpscRing *r, const uint32_t v) {
+    const uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail - r->head_cache > r->mask) {
+        r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (tail - r->head_cache > r->mask) return -1;
+    }
+    r->slot[tail & r->mask] = v;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+static inline int spsc_try_pop(SpscRing *r, uint32_t *v) {
+    const uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (head == r->tail_cache) {
+        r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (head == r->tail_cache) return -1;
+    }
+    *v = r->slot[head & r->mask];
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return 0;
+}
+
+static inline int mpmc_init(MpmcRing *r, const uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return -1;
+    atomic_init(&r->enq, 0);
+    atomic_init(&r->deq, 0);
+    r->mask = capacity - 1;
+    r->cell = malloc(sizeof(MpmcCell) * capacity);
+    if (!r->cell) return -1;
+    for (uint32_t i = 0; i < capacity; i++) {
+        atomic_init(&r->cell[i].seq, i);
+    }
+    return 0;
+}
+
+static inline void mpmc_free(MpmcRing *r) {
+    free(r->cell);
+    r->cell = NULL;
+}
+
+static inline int mpmc_try_push(MpmcRing *r, const uint32_t v) {
+    uint32_t pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+    MpmcCell *c;
+    for (;;) {
+        c = &r->cell[pos & r->mask];
+        const uint32_t seq =
+            atomic_load_explicit(&c->seq, memory_order_acquire);
+        const int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->enq,
+                                                      &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1; /* full */
+        } else {
+            pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+        }
+    }
+    c->value = v;
+    atomic_store_explicit(&c->seq, pos + 1, memory_order_release);
+    return 0;
+}
+
+static inline int mpmc_try_pop(MpmcRing *r, uint32_t *v) {
+    uint32_t pos = atomic_load_explicit(&r->deq, memory_order_relaxed);
+    MpmcCell *c;
+    for (;;) {
+        c = &r->cell[pos & r->mask];
+        const uint32_t seq =
+            atomic_load_explicit(&c->seq, memory_order_acquire);
+        const int32_t diff = (int32_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->deq,
+                                                      &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1; /* empty */
+        } else {
+            pos = atomic_load_explicit(&r->deq, memory_order_relaxed);
+        }
+    }
+    *v = c->value;
+    atomic_store_explicit(&c->seq, pos + r->mask + 1, memory_order_release);
+    return 0;
+}
+
+static inline void ring_backoff(unsigned *spins) {
+    if (++*spins < RING_SPINS) {
+        ring_relax();
+    } else {
+        ring_yield();
+    }
+}
+
+/* Blocking versions; the wait goes to *wait_ns */
+#define RING_BLOCKING(name, ring_t, op, arg_t)                              \
+    static inline void name(ring_t *r, arg_t v, uint64_t *wait_ns) {        \
+        if (op(r, v) == 0) return;                                          \
+        const uint64_t t0 = lat_now_ns();                                   \
+        unsigned spins = 0;                                                 \
+        while (op(r, v) != 0) {                                             \
+            ring_backoff(&spins);                                           \
+        }                                                                   \
+        *wait_ns += lat_now_ns() - t0;                                      \
+    }
+
+RING_BLOCKING(spsc_push, SpscRing, spsc_try_push, const uint32_t)
+RING_BLOCKING(spsc_pop, SpscRing, spsc_try_pop, uint32_t *)
+RING_BLOCKING(mpmc_push, MpmcRing, mpmc_try_push, const uint32_t)
+RING_BLOCKING(mpmc_pop, MpmcRing, mpmc_try_pop, uint32_t *)
+
+#undef RING_BLOCKING
+
+/* One line per stage: share of its threads' wall time busy, starved and
+ * blocked, and the items per second it sustained */
+static inline void stage_print(FILE *fp, const char *name, const int threads,
+                               const StageStats *s, const uint64_t wall_ns) {
+    const double wall = (double)wall_ns * (double)threads;
+    fprintf(fp,
+            "  stage %-10s threads %-2d frames %-8llu busy %5.1f%%  "
+            "starved %5.1f%%  blocked %5.1f%%  %10.0f frames/s\n",
+            name,
+            threads,
+            (unsigned long long)s->items,
+            wall > 0 ? 100.0 * (double)s->busy_ns / wall : 0.0,
+            wall > 0 ? 100.0 * (double)s->starved_ns / wall : 0.0,
+            wall > 0 ? 100.0 * (double)s->blocked_ns / wall : 0.0,
+            wall_ns > 0 ? (double)s->items * 1e9 / (double)wall_ns : 0.0);
+}
+
+#endif  // RING_H
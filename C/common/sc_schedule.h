@@ -0,0 +1,47 @@
+#ifndef SC_SCHEDULE_H
+#define SC_SCHEDULE_H
+
+/**
+ * @file sc_schedule.h
+ * @brief Stateless SC tree traversal, scheduled from the leaf bit index
+ *
+ * Successive cancellation visits the leaves of the n-stage code tree from
+ * left to right. Between the leaf that ends at bit i and the leaf that starts
+ * at bit i (0 < i < 2^n), the traversal climbs to their lowest common
+ * ancestor and descends again. The right child of that ancestor is at the
+ * turn depth b = n - ctz(i), so the decoder runs
+ *   - the partial sum combines at depths d_prev - 1 ... b, where d_prev is
+ *     the depth of the previous leaf (n for plain SC: ctz(i) combines),
+ *   - one g from depth b - 1 into the right child at depth b,
+ *   - f stages from depth b down to the next leaf (ctz(i) for plain SC),
+ * and leaf 0 runs its f stages from the root. The node of depth d that ends
+ * at bit i starts at i - 2^(n-d). The same holds for a pruned tree whose
+ * leaves are 2^s-bit nodes aligned to 2^s, and i = 2^n (turn depth 0) gives
+ * the combines that complete the root after the last leaf.
+ *
+ * This replaces the node state vector and the per-step state machine of the
+ * tree walk with a straight loop over the leaves.
+ */
+
+#if defined(__GNUC__)
+static inline unsigned sc_ctz(const unsigned x) {
+    return (unsigned)__builtin_ctz(x);
+}
+#else
+static inline unsigned sc_ctz(unsigned x) {
+    unsigned k = 0;
+    while ((x & 1U) == 0) {
+        x >>= 1;
+        k++;
+    }
+    return k;
+}
+#endif
+
+/* Depth of the right child where the traversal turns between the leaf that
+ * ends at bit i and the leaf that starts at i, 0 < i <= 2^n */
+static inline unsigned sc_turn_depth(const unsigned i, const unsigned n) {
+    return n - sc_ctz(i);
+}
+
+#endif  // SC_SCHEDULE_H
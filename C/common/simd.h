@@ -0,0 +1,347 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * @file simd.h
+ * @brief Thin SIMD layer over 8/16-bit lanes: NEON, AVX2, SSE4.1 or scalar
+ *
+ * The ARM decoders (C/ARM) are written against this header instead of
+ * arm_neon.h, so one source builds with NEON on ARM and with AVX2 or SSE4.1
+ * on x86. The scalar backend builds anywhere and is the reference the
+ * vector backends are checked against; define SIMD_SCALAR to force it.
+ *
+ * A vector holds SIMD_U8_LANES 8-bit or SIMD_S16_LANES 16-bit lanes (16 and
+ * 8 for NEON, SSE4.1 and scalar, 32 and 16 for AVX2). Loads and stores are
+ * unaligned. Comparisons return a lane mask, all ones or zero, as simd_u8
+ * for 8-bit lanes and simd_s16 for 16-bit lanes; select takes a where the
+ * mask is set and b elsewhere.
+ */
+
+#include <stdint.h>
+
+#if defined(SIMD_SCALAR)
+#define SIMD_BACKEND_SCALAR
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_BACKEND_NEON
+#elif defined(__AVX2__)
+#define SIMD_BACKEND_AVX2
+#elif defined(__SSE4_1__)
+#define SIMD_BACKEND_SSE41
+#else
+#define SIMD_BACKEND_SCALAR
+#endif
+
+/* ---------------------------------------------------------------- NEON */
+#if defined(SIMD_BACKEND_NEON)
+
+#include <arm_neon.h>
+
+#define SIMD_BACKEND_NAME "neon"
+#define SIMD_U8_LANES     (16)
+#define SIMD_S16_LANES    (8)
+
+typedef uint8x16_t simd_u8;
+typedef int8x16_t simd_s8;
+typedef int16x8_t simd_s16;
+
+static inline simd_u8 simd_load_u8(const uint8_t *p) { return vld1q_u8(p); }
+static inline void simd_store_u8(uint8_t *p, const simd_u8 a) {
+    vst1q_u8(p, a);
+}
+static inline simd_u8 simd_dup_u8(const uint8_t x) { return vdupq_n_u8(x); }
+static inline simd_u8 simd_xor_u8(const simd_u8 a, const simd_u8 b) {
+    return veorq_u8(a, b);
+}
+static inline simd_u8 simd_and_u8(const simd_u8 a, const simd_u8 b) {
+    return vandq_u8(a, b);
+}
+
+static inline simd_s8 simd_load_s8(const int8_t *p) { return vld1q_s8(p); }
+static inline void simd_store_s8(int8_t *p, const simd_s8 a) {
+    vst1q_s8(p, a);
+}
+static inline simd_s8 simd_dup_s8(const int8_t x) { return vdupq_n_s8(x); }
+static inline simd_s8 simd_add_s8(const simd_s8 a, const simd_s8 b) {
+    return vaddq_s8(a, b);
+}
+static inline simd_s8 simd_sub_s8(const simd_s8 a, const simd_s8 b) {
+    return vsubq_s8(a, b);
+}
+static inline simd_s8 simd_min_s8(const simd_s8 a, const simd_s8 b) {
+    return vminq_s8(a, b);
+}
+static inline simd_s8 simd_max_s8(const simd_s8 a, const simd_s8 b) {
+    return vmaxq_s8(a, b);
+}
+static inline simd_s8 simd_abs_s8(const simd_s8 a) { return vabsq_s8(a); }
+static inline simd_u8 simd_cge_s8(const simd_s8 a, const simd_s8 b) {
+    return vcgeq_s8(a, b);
+}
+static inline simd_u8 simd_cgt_s8(const simd_s8 a, const simd_s8 b) {
+    return vcgtq_s8(a, b);
+}
+static inline simd_s8 simd_select_s8(const simd_u8 mask, const simd_s8 a,
+                                     const simd_s8 b) {
+    return vbslq_s8(mask, a, b);
+}
+
+static inline simd_s16 simd_load_s16(const int16_t *p) { return vld1q_s16(p); }
+static inline void simd_store_s16(int16_t *p, const simd_s16 a) {
+    vst1q_s16(p, a);
+}
+static inline simd_s16 simd_dup_s16(const int16_t x) { return vdupq_n_s16(x); }
+static inline simd_s16 simd_add_s16(const simd_s16 a, const simd_s16 b) {
+    return vaddq_s16(a, b);
+}
+static inline simd_s16 simd_sub_s16(const simd_s16 a, const simd_s16 b) {
+    return vsubq_s16(a, b);
+}
+static inline simd_s16 simd_min_s16(const simd_s16 a, const simd_s16 b) {
+    return vminq_s16(a, b);
+}
+static inline simd_s16 simd_max_s16(const simd_s16 a, const simd_s16 b) {
+    return vmaxq_s16(a, b);
+}
+static inline simd_s16 simd_abs_s16(const simd_s16 a) { return vabsq_s16(a); }
+static inline simd_s16 simd_cgt_s16(const simd_s16 a, const simd_s16 b) {
+    return vreinterpretq_s16_u16(vcgtq_s16(a, b));
+}
+static inline simd_s16 simd_select_s16(const simd_s16 mask, const simd_s16 a,
+                                       const simd_s16 b) {
+    return vbslq_s16(vreinterpretq_u16_s16(mask), a, b);
+}
+
+/* ----------------------------------------------------- AVX2 and SSE4.1 */
+#elif defined(SIMD_BACKEND_AVX2) || defined(SIMD_BACKEND_SSE41)
+
+#include <immintrin.h>
+
+#if defined(SIMD_BACKEND_AVX2)
+#define SIMD_BACKEND_NAME "avx2"
+#define SIMD_U8_LANES     (32)
+#define SIMD_S16_LANES    (16)
+typedef __m256i simd_vec;
+#define SIMD_OP(op) _mm256_##op
+#define SIMD_LOAD(p)     _mm256_loadu_si256((const __m256i *)(p))
+#define SIMD_STORE(p, a) _mm256_storeu_si256((__m256i *)(p), (a))
+#define SIMD_XOR(a, b)   _mm256_xor_si256((a), (b))
+#define SIMD_AND(a, b)   _mm256_and_si256((a), (b))
+#else
+#define SIMD_BACKEND_NAME "sse4.1"
+#define SIMD_U8_LANES     (16)
+#define SIMD_S16_LANES    (8)
+typedef __m128i simd_vec;
+#define SIMD_OP(op) _mm_##op
+#define SIMD_LOAD(p)     _mm_loadu_si128((const __m128i *)(p))
+#define SIMD_STORE(p, a) _mm_storeu_si128((__m128i *)(p), (a))
+#define SIMD_XOR(a, b)   _mm_xor_si128((a), (b))
+#define SIMD_AND(a, b)   _mm_and_si128((a), (b))
+#endif
+
+typedef simd_vec simd_u8;
+typedef simd_vec simd_s8;
+typedef simd_vec simd_s16;
+
+static inline simd_u8 simd_load_u8(const uint8_t *p) { return SIMD_LOAD(p); }
+static inline void simd_store_u8(uint8_t *p, const simd_u8 a) {
+    SIMD_STORE(p, a);
+}
+static inline simd_u8 simd_dup_u8(const uint8_t x) {
+    return SIMD_OP(set1_epi8)((char)x);
+}
+static inline simd_u8 simd_xor_u8(const simd_u8 a, const simd_u8 b) {
+    return SIMD_XOR(a, b);
+}
+static inline simd_u8 simd_and_u8(const simd_u8 a, const simd_u8 b) {
+    return SIMD_AND(a, b);
+}
+
+static inline simd_s8 simd_load_s8(const int8_t *p) { return SIMD_LOAD(p); }
+static inline void simd_store_s8(int8_t *p, const simd_s8 a) {
+    SIMD_STORE(p, a);
+}
+static inline simd_s8 simd_dup_s8(const int8_t x) {
+    return SIMD_OP(set1_epi8)(x);
+}
+static inline simd_s8 simd_add_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(add_epi8)(a, b);
+}
+static inline simd_s8 simd_sub_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(sub_epi8)(a, b);
+}
+static inline simd_s8 simd_min_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(min_epi8)(a, b);
+}
+static inline simd_s8 simd_max_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(max_epi8)(a, b);
+}
+static inline simd_s8 simd_abs_s8(const simd_s8 a) {
+    return SIMD_OP(abs_epi8)(a);
+}
+static inline simd_u8 simd_cge_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(cmpeq_epi8)(SIMD_OP(max_epi8)(a, b), a);
+}
+static inline simd_u8 simd_cgt_s8(const simd_s8 a, const simd_s8 b) {
+    return SIMD_OP(cmpgt_epi8)(a, b);
+}
+static inline simd_s8 simd_select_s8(const simd_u8 mask, const simd_s8 a,
+                                     const simd_s8 b) {
+    return SIMD_OP(blendv_epi8)(b, a, mask);
+}
+
+static inline simd_s16 simd_load_s16(const int16_t *p) { return SIMD_LOAD(p); }
+static inline void simd_store_s16(int16_t *p, const simd_s16 a) {
+    SIMD_STORE(p, a);
+}
+static inline simd_s16 simd_dup_s16(const int16_t x) {
+    return SIMD_OP(set1_epi16)(x);
+}
+static inline simd_s16 simd_add_s16(const simd_s16 a, const simd_s16 b) {
+    return SIMD_OP(add_epi16)(a, b);
+}
+static inline simd_s16 simd_sub_s16(const simd_s16 a, const simd_s16 b) {
+    return SIMD_OP(sub_epi16)(a, b);
+}
+static inline simd_s16 simd_min_s16(const simd_s16 a, const simd_s16 b) {
+    return SIMD_OP(min_epi16)(a, b);
+}
+static inline simd_s16 simd_max_s16(const simd_s16 a, const simd_s16 b) {
+    return SIMD_OP(max_epi16)(a, b);
+}
+static inline simd_s16 simd_abs_s16(const simd_s16 a) {
+    return SIMD_OP(abs_epi16)(a);
+}
+static inline simd_s16 simd_cgt_s16(const simd_s16 a, const simd_s16 b) {
+    return SIMD_OP(cmpgt_epi16)(a, b);
+}
+static inline simd_s16 simd_select_s16(const simd_s16 mask, const simd_s16 a,
+                                       const simd_s16 b) {
+    return SIMD_OP(blendv_epi8)(b, a, mask);
+}
+
+#undef SIMD_OP
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_XOR
+#undef SIMD_AND
+
+/* -------------------------------------------------------------- scalar */
+#else
+
+#define SIMD_BACKEND_NAME "scalar"
+#define SIMD_U8_LANES     (16)
+#define SIMD_S16_LANES    (8)
+
+typedef struct {
+    uint8_t v[SIMD_U8_LANES];
+} simd_u8;
+typedef struct {
+    int8_t v[SIMD_U8_LANES];
+} simd_s8;
+typedef struct {
+    int16_t v[SIMD_S16_LANES];
+} simd_s16;
+
+/* Lane-wise expression over the lanes of a result of type T */
+#define SIMD_MAP(T, LANES, expr)          \
+    T r;                                  \
+    for (int i = 0; i < (LANES); i++) {   \
+        r.v[i] = expr;                    \
+    }                                     \
+    return r
+
+static inline simd_u8 simd_load_u8(const uint8_t *p) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, p[i]);
+}
+static inline void simd_store_u8(uint8_t *p, const simd_u8 a) {
+    for (int i = 0; i < SIMD_U8_LANES; i++) p[i] = a.v[i];
+}
+static inline simd_u8 simd_dup_u8(const uint8_t x) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, x);
+}
+static inline simd_u8 simd_xor_u8(const simd_u8 a, const simd_u8 b) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, (uint8_t)(a.v[i] ^ b.v[i]));
+}
+static inline simd_u8 simd_and_u8(const simd_u8 a, const simd_u8 b) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, (uint8_t)(a.v[i] & b.v[i]));
+}
+
+static inline simd_s8 simd_load_s8(const int8_t *p) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES, p[i]);
+}
+static inline void simd_store_s8(int8_t *p, const simd_s8 a) {
+    for (int i = 0; i < SIMD_U8_LANES; i++) p[i] = a.v[i];
+}
+static inline simd_s8 simd_dup_s8(const int8_t x) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES, x);
+}
+/* Wrapping add/sub, as the vector instructions */
+static inline simd_s8 simd_add_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES,
+             (int8_t)(uint8_t)((uint8_t)a.v[i] + (uint8_t)b.v[i]));
+}
+static inline simd_s8 simd_sub_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES,
+             (int8_t)(uint8_t)((uint8_t)a.v[i] - (uint8_t)b.v[i]));
+}
+static inline simd_s8 simd_min_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES, a.v[i] < b.v[i] ? a.v[i] : b.v[i]);
+}
+static inline simd_s8 simd_max_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES, a.v[i] > b.v[i] ? a.v[i] : b.v[i]);
+}
+static inline simd_s8 simd_abs_s8(const simd_s8 a) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES,
+             (int8_t)(uint8_t)(a.v[i] < 0 ? -(uint8_t)a.v[i] : a.v[i]));
+}
+static inline simd_u8 simd_cge_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, a.v[i] >= b.v[i] ? 0xFF : 0);
+}
+static inline simd_u8 simd_cgt_s8(const simd_s8 a, const simd_s8 b) {
+    SIMD_MAP(simd_u8, SIMD_U8_LANES, a.v[i] > b.v[i] ? 0xFF : 0);
+}
+static inline simd_s8 simd_select_s8(const simd_u8 mask, const simd_s8 a,
+                                     const simd_s8 b) {
+    SIMD_MAP(simd_s8, SIMD_U8_LANES, mask.v[i] ? a.v[i] : b.v[i]);
+}
+
+static inline simd_s16 simd_load_s16(const int16_t *p) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, p[i]);
+}
+static inline void simd_store_s16(int16_t *p, const simd_s16 a) {
+    for (int i = 0; i < SIMD_S16_LANES; i++) p[i] = a.v[i];
+}
+static inline simd_s16 simd_dup_s16(const int16_t x) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, x);
+}
+static inline simd_s16 simd_add_s16(const simd_s16 a, const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES,
+             (int16_t)(uint16_t)((uint16_t)a.v[i] + (uint16_t)b.v[i]));
+}
+static inline simd_s16 simd_sub_s16(const simd_s16 a, const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES,
+             (int16_t)(uint16_t)((uint16_t)a.v[i] - (uint16_t)b.v[i]));
+}
+static inline simd_s16 simd_min_s16(const simd_s16 a, const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, a.v[i] < b.v[i] ? a.v[i] : b.v[i]);
+}
+static inline simd_s16 simd_max_s16(const simd_s16 a, const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, a.v[i] > b.v[i] ? a.v[i] : b.v[i]);
+}
+static inline simd_s16 simd_abs_s16(const simd_s16 a) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES,
+             (int16_t)(uint16_t)(a.v[i] < 0 ? -(uint16_t)a.v[i] : a.v[i]));
+}
+static inline simd_s16 simd_cgt_s16(const simd_s16 a, const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, a.v[i] > b.v[i] ? -1 : 0);
+}
+static inline simd_s16 simd_select_s16(const simd_s16 mask, const simd_s16 a,
+                                       const simd_s16 b) {
+    SIMD_MAP(simd_s16, SIMD_S16_LANES, mask.v[i] ? a.v[i] : b.v[i]);
+}
+
+#undef SIMD_MAP
+
+#endif
+
+#endif  // SIMD_H
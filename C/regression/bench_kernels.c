@@ -0,0 +1,236 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "functions_SCL.h"
+#include "kernels_SSCD.h"
+#include "latency.h"
+
+/* Micro-benchmark of the decoder primitives, one at a time, on fixed
+ * pseudo-random inputs: the f, g and combine loops and the Rep, Rate-1 and
+ * SPC node kernels of the SSC decoder (kernels_SSCD.h) over lengths 1 ...
+ * 1024, encode() and crcGen() over lengths, the insertion sort of the 2L
+ * path metrics over list sizes 1 ... 32, and crcDet() over both.
+ *
+ * Each case is warmed up, calibrated to batches of at least BATCH_NS, and
+ * timed over reps batches; the median and the min per call go to stdout as
+ * CSV, one row per kernel, length and list size. */
+
+#define MAX_LEN    (1024)
+#define MAX_LIST   (32)
+#define CRC_M      (9) /* taps of the CRC-8 polynomial of the simulations */
+#define BATCH_NS   (50000)
+#define WARMUP_NS  (2000000)
+
+/* Keeps the compiler from hoisting or dropping the repeated kernel calls */
+#if defined(__GNUC__)
+#define CLOBBER() __asm__ volatile("" ::: "memory")
+#else
+#define CLOBBER() ((void)0)
+#endif
+
+typedef enum BenchKernel {
+    K_F,
+    K_G,
+    K_COMBINE,
+    K_REP,
+    K_RATE1,
+    K_SPC,
+    K_ENCODE,
+    K_SORT,
+    K_CRC_GEN,
+    K_CRC_DET,
+    K_NUM
+} BenchKernel;
+
+static const char *const kernel_name[K_NUM] = {"f",
+                                                "g",
+                                                "combine",
+                                                "rep",
+                                                "rate1",
+                                                "spc",
+                                                "encode",
+                                                "sort",
+                                                "crc_gen",
+                                                "crc_det"};
+
+/* Inputs and outputs of all kernels, filled once */
+typedef struct BenchData {
+    int L[2 * MAX_LEN];
+    int u[2 * MAX_LEN];
+    int out[2 * MAX_LEN];
+    int leaf[MAX_LEN];
+    int PM_init[2 * MAX_LIST];
+    int PM[2 * MAX_LIST];
+    int ind_ord[2 * MAX_LIST];
+    int msg[MAX_LIST * MAX_LEN];
+    int crc_check[MAX_LIST];
+    int polynomial[CRC_M];
+} BenchData;
+
+static BenchData data;
+static volatile int sink;
+
+/* Deterministic, so that every run times the same data */
+static uint32_t bench_rand(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static void fill_inputs(void) {
+    for (int i = 0; i < 2 * MAX_LEN; i++) {
+        data.L[i] = (int)(bench_rand() % 64) - 32; /* 6-bit channel LLRs */
+        data.u[i] = (int)(bench_rand() & 1);
+    }
+    for (int i = 0; i < MAX_LIST * MAX_LEN; i++) {
+        data.msg[i] = (int)(bench_rand() & 1);
+    }
+    static const int poly[CRC_M] = {1, 1, 1, 0, 1, 0, 1, 0, 1};
+    memcpy(data.polynomial, poly, sizeof(poly));
+}
+
+/* Path metrics as the sort sees them: l sorted survivors, then the same l
+ * paths with the penalty of the other decision */
+static void fill_metrics(const int l) {
+    int pm = 0;
+    for (int i = 0; i < l; i++) {
+        pm += (int)(bench_rand() % 8);
+        data.PM_init[i] = pm;
+        data.PM_init[l + i] = pm + 1 + (int)(bench_rand() % 32);
+    }
+}
+
+/* One call of kernel k on length len and list size l */
+static void run_kernel(const BenchKernel k, const int len, const int l) {
+    const unsigned n = (unsigned)len;
+    switch (k) {
+    case K_F:
+        f_vec(data.out, data.L, n);
+        break;
+    case K_G:
+        g_vec(data.out, data.L, data.u, n);
+        break;
+    case K_COMBINE:
+        combine_vec(data.out, data.u, n);
+        break;
+    case K_REP:
+        rep_node(data.out, data.leaf, data.L, n);
+        break;
+    case K_RATE1:
+        rate1_node(data.out, data.leaf, data.L, n);
+        break;
+    case K_SPC:
+        spc_node(data.out, data.leaf, data.L, n);
+        break;
+    case K_ENCODE:
+        encode(data.u, len);
+        break;
+    case K_SORT:
+        /* includes restoring the 2l metrics, as small as the sort itself
+         * is at l = 1 */
+        for (int i = 0; i < 2 * l; i++) {
+            data.PM[i] = data.PM_init[i];
+            data.ind_ord[i] = i;
+        }
+        insertionSort(data.PM, data.ind_ord, 2 * l);
+        break;
+    case K_CRC_GEN:
+        crcGen(data.msg, len, data.polynomial, CRC_M);
+        break;
+    default:
+        crcDet(data.msg, len, l, data.polynomial, CRC_M, data.crc_check);
+        break;
+    }
+    CLOBBER();
+}
+
+static uint64_t run_batch(const BenchKernel k, const int len, const int l,
+                          const uint64_t batch) {
+    const uint64_t t0 = lat_now_ns();
+    for (uint64_t b = 0; b < batch; b++) {
+        run_kernel(k, len, l);
+    }
+    const uint64_t t1 = lat_now_ns();
+    sink = data.out[0] + data.leaf[0] + data.PM[0] + data.msg[len - 1]
+           + data.crc_check[0];
+    return t1 - t0;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Warm-up, batch calibration and reps timed batches, one CSV row */
+static void bench(const BenchKernel k, const int len, const int l,
+                  const int reps) {
+    if (k == K_SORT) fill_metrics(l);
+
+    uint64_t batch = 1;
+    while (run_batch(k, len, l, batch) < BATCH_NS && batch < (1u << 30)) {
+        batch *= 2;
+    }
+    const uint64_t warm_start = lat_now_ns();
+    while (lat_now_ns() - warm_start < WARMUP_NS) {
+        run_batch(k, len, l, batch);
+    }
+
+    double ns[reps];
+    for (int r = 0; r < reps; r++) {
+        ns[r] = (double)run_batch(k, len, l, batch) / (double)batch;
+    }
+    qsort(ns, (size_t)reps, sizeof(double), cmp_double);
+
+    printf("%s,%d,%d,%llu,%d,%.2f,%.2f\n",
+           kernel_name[k],
+           len,
+           l,
+           (unsigned long long)batch,
+           reps,
+           ns[reps / 2],
+           ns[0]);
+    fflush(stdout);
+}
+
+/* Usage: bench_kernels [reps] [kernel]
+ * All kernels, or only the one named, as CSV:
+ * kernel,len,list,batch,reps,median_ns,min_ns (ns per call) */
+int main(int argc, char **argv) {
+    const int reps = argc > 1 ? atoi(argv[1]) : 21;
+    if (reps < 1) {
+        fprintf(stderr, "usage: %s [reps] [kernel]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *only = argc > 2 ? argv[2] : NULL;
+
+    fill_inputs();
+    printf("kernel,len,list,batch,reps,median_ns,min_ns\n");
+
+    for (int k = 0; k < K_NUM; k++) {
+        if (only && strcmp(only, kernel_name[k]) != 0) continue;
+
+        if (k == K_SORT) {
+            for (int l = 1; l <= MAX_LIST; l <<= 1) {
+                bench((BenchKernel)k, 2 * l, l, reps);
+            }
+        } else if (k == K_CRC_DET) {
+            for (int len = 16; len <= MAX_LEN; len <<= 1) {
+                for (int l = 1; l <= MAX_LIST; l <<= 1) {
+                    bench((BenchKernel)k, len, l, reps);
+                }
+            }
+        } else {
+            /* the CRC needs at least its CRC_M taps */
+            const int first = k == K_CRC_GEN ? 16 : 1;
+            for (int len = first; len <= MAX_LEN; len <<= 1) {
+                bench((BenchKernel)k, len, 1, reps);
+            }
+        }
+    }
+    return 0;
+}
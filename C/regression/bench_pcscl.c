@@ -0,0 +1,369 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "functions_SCL.h"
+#include "nr_rate_match.h"
+
+/* Usage: bench_pcscl [frames] [EbN0dB]
+ * PC polar codes at the NR UCI payload sizes that use them (A = 12 ... 19
+ * bits, CRC6, n_pc = 3 parity bits, TS 38.212 5.3.1.2 and 6.3.1.2.1) on the
+ * uplink chain: PC encoding, rate matching with the channel interleaver,
+ * BPSK, AWGN, quantization and de-rate-matching. Per (A, E), decode time and
+ * BLER of CA-PC-SCL (decode_pcscl(), the parity bits checked per path) and
+ * of CA-SCL that decodes the parity positions as information bits, both
+ * with L = 8 and the first list entry that passes the CRC. E on both sides
+ * of E - K + 3 = 192 covers the codes with and without the minimum-weight
+ * parity bit. The parity positions of one code must match hand-derived
+ * ones and noiseless frames of every code must decode first, otherwise the
+ * benchmark fails. */
+
+/* Channel reliability in increasing order*/
+static const int Q[1024] = {
+    0,    1,    2,   4,    8,    16,   32,   3,    5,    64,   9,   6,    17,
+    10,   18,   128, 12,   33,   65,   20,   256,  34,   24,   36,  7,    129,
+    66,   512,  11,  40,   68,   130,  19,   13,   48,   14,   72,  257,  21,
+    132,  35,   258, 26,   513,  80,   37,   25,   22,   136,  260, 264,  38,
+    514,  96,   67,  41,   144,  28,   69,   42,   516,  49,   74,  272,  160,
+    520,  288,  528, 192,  544,  70,   44,   131,  81,   50,   73,  15,   320,
+    133,  52,   23,  134,  384,  76,   137,  82,   56,   27,   97,  39,   259,
+    84,   138,  145, 261,  29,   43,   98,   515,  88,   140,  30,  146,  71,
+    262,  265,  161, 576,  45,   100,  640,  51,   148,  46,   75,  266,  273,
+    517,  104,  162, 53,   193,  152,  77,   164,  768,  268,  274, 518,  54,
+    83,   57,   521, 112,  135,  78,   289,  194,  85,   276,  522, 58,   168,
+    139,  99,   86,  60,   280,  89,   290,  529,  524,  196,  141, 101,  147,
+    176,  142,  530, 321,  31,   200,  90,   545,  292,  322,  532, 263,  149,
+    102,  105,  304, 296,  163,  92,   47,   267,  385,  546,  324, 208,  386,
+    150,  153,  165, 106,  55,   328,  536,  577,  548,  113,  154, 79,   269,
+    108,  578,  224, 166,  519,  552,  195,  270,  641,  523,  275, 580,  291,
+    59,   169,  560, 114,  277,  156,  87,   197,  116,  170,  61,  531,  525,
+    642,  281,  278, 526,  177,  293,  388,  91,   584,  769,  198, 172,  120,
+    201,  336,  62,  282,  143,  103,  178,  294,  93,   644,  202, 592,  323,
+    392,  297,  770, 107,  180,  151,  209,  284,  648,  94,   204, 298,  400,
+    608,  352,  325, 533,  155,  210,  305,  547,  300,  109,  184, 534,  537,
+    115,  167,  225, 326,  306,  772,  157,  656,  329,  110,  117, 212,  171,
+    776,  330,  226, 549,  538,  387,  308,  216,  416,  271,  279, 158,  337,
+    550,  672,  118, 332,  579,  540,  389,  173,  121,  553,  199, 784,  179,
+    228,  338,  312, 704,  390,  174,  554,  581,  393,  283,  122, 448,  353,
+    561,  203,  63,  340,  394,  527,  582,  556,  181,  295,  285, 232,  124,
+    205,  182,  643, 562,  286,  585,  299,  354,  211,  401,  185, 396,  344,
+    586,  645,  593, 535,  240,  206,  95,   327,  564,  800,  402, 356,  307,
+    301,  417,  213, 568,  832,  588,  186,  646,  404,  227,  896, 594,  418,
+    302,  649,  771, 360,  539,  111,  331,  214,  309,  188,  449, 217,  408,
+    609,  596,  551, 650,  229,  159,  420,  310,  541,  773,  610, 657,  333,
+    119,  600,  339, 218,  368,  652,  230,  391,  313,  450,  542, 334,  233,
+    555,  774,  175, 123,  658,  612,  341,  777,  220,  314,  424, 395,  673,
+    583,  355,  287, 183,  234,  125,  557,  660,  616,  342,  316, 241,  778,
+    563,  345,  452, 397,  403,  207,  674,  558,  785,  432,  357, 187,  236,
+    664,  624,  587, 780,  705,  126,  242,  565,  398,  346,  456, 358,  405,
+    303,  569,  244, 595,  189,  566,  676,  361,  706,  589,  215, 786,  647,
+    348,  419,  406, 464,  680,  801,  362,  590,  409,  570,  788, 597,  572,
+    219,  311,  708, 598,  601,  651,  421,  792,  802,  611,  602, 410,  231,
+    688,  653,  248, 369,  190,  364,  654,  659,  335,  480,  315, 221,  370,
+    613,  422,  425, 451,  614,  543,  235,  412,  343,  372,  775, 317,  222,
+    426,  453,  237, 559,  833,  804,  712,  834,  661,  808,  779, 617,  604,
+    433,  720,  816, 836,  347,  897,  243,  662,  454,  318,  675, 618,  898,
+    781,  376,  428, 665,  736,  567,  840,  625,  238,  359,  457, 399,  787,
+    591,  678,  434, 677,  349,  245,  458,  666,  620,  363,  127, 191,  782,
+    407,  436,  626, 571,  465,  681,  246,  707,  350,  599,  668, 790,  460,
+    249,  682,  573, 411,  803,  789,  709,  365,  440,  628,  689, 374,  423,
+    466,  793,  250, 371,  481,  574,  413,  603,  366,  468,  655, 900,  805,
+    615,  684,  710, 429,  794,  252,  373,  605,  848,  690,  713, 632,  482,
+    806,  427,  904, 414,  223,  663,  692,  835,  619,  472,  455, 796,  809,
+    714,  721,  837, 716,  864,  810,  606,  912,  722,  696,  377, 435,  817,
+    319,  621,  812, 484,  430,  838,  667,  488,  239,  378,  459, 622,  627,
+    437,  380,  818, 461,  496,  669,  679,  724,  841,  629,  351, 467,  438,
+    737,  251,  462, 442,  441,  469,  247,  683,  842,  738,  899, 670,  783,
+    849,  820,  728, 928,  791,  367,  901,  630,  685,  844,  633, 711,  253,
+    691,  824,  902, 686,  740,  850,  375,  444,  470,  483,  415, 485,  905,
+    795,  473,  634, 744,  852,  960,  865,  693,  797,  906,  715, 807,  474,
+    636,  694,  254, 717,  575,  913,  798,  811,  379,  697,  431, 607,  489,
+    866,  723,  486, 908,  718,  813,  476,  856,  839,  725,  698, 914,  752,
+    868,  819,  814, 439,  929,  490,  623,  671,  739,  916,  463, 843,  381,
+    497,  930,  821, 726,  961,  872,  492,  631,  729,  700,  443, 741,  845,
+    920,  382,  822, 851,  730,  498,  880,  742,  445,  471,  635, 932,  687,
+    903,  825,  500, 846,  745,  826,  732,  446,  962,  936,  475, 853,  867,
+    637,  907,  487, 695,  746,  828,  753,  854,  857,  504,  799, 255,  964,
+    909,  719,  477, 915,  638,  748,  944,  869,  491,  699,  754, 858,  478,
+    968,  383,  910, 815,  976,  870,  917,  727,  493,  873,  701, 931,  756,
+    860,  499,  731, 823,  922,  874,  918,  502,  933,  743,  760, 881,  494,
+    702,  921,  501, 876,  847,  992,  447,  733,  827,  934,  882, 937,  963,
+    747,  505,  855, 924,  734,  829,  965,  938,  884,  506,  749, 945,  966,
+    755,  859,  940, 830,  911,  871,  639,  888,  479,  946,  750, 969,  508,
+    861,  757,  970, 919,  875,  862,  758,  948,  977,  923,  972, 761,  877,
+    952,  495,  703, 935,  978,  883,  762,  503,  925,  878,  735, 993,  885,
+    939,  994,  980, 926,  764,  941,  967,  886,  831,  947,  507, 889,  984,
+    751,  942,  996, 971,  890,  509,  949,  973,  1000, 892,  950, 863,  759,
+    1008, 510,  979, 953,  763,  974,  954,  879,  981,  982,  927, 995,  765,
+    956,  887,  985, 997,  986,  943,  891,  998,  766,  511,  988, 1001, 951,
+    1002, 893,  975, 894,  1009, 955,  1004, 1010, 957,  983,  958, 987,  1012,
+    999,  1016, 767, 989,  1003, 990,  1005, 959,  1011, 1013, 895, 1006, 1014,
+    1017, 1018, 991, 1020, 1007, 1015, 1019, 1021, 1022, 1023};
+
+#define LIST      (8)
+#define N_PC      (3)
+#define CRC6_L    (6)
+#define CRC6_POLY (0x21) /* g(D) = D^6 + D^5 + 1 without D^6 */
+#define N_MAX     (10)   /* uplink */
+#define RMAX      (3.0f)
+#define MAXQR     (31)
+#define RNG_SEED  (0x9E3779B97F4A7C15ULL)
+
+typedef struct UciCase {
+    int A;
+    int E;
+} UciCase;
+
+static const UciCase cases[] = {
+    {12, 96}, {16, 96}, {19, 96}, {12, 288}, {16, 288}, {19, 288}};
+
+static uint64_t rng_state = RNG_SEED;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static int rng_bit(void) { return (int)(rng_next() >> 63); }
+
+/* Uniform in (0, 1) */
+static double rng_uniform(void) {
+    return ((double)(rng_next() >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/* Box muller method */
+static double rng_normal(void) {
+    const double r = sqrt(-2.0 * log(rng_uniform()));
+    return r * cos(6.283185307179586 * rng_uniform());
+}
+
+/* Remainder of the bits by g(D), first bit the highest power */
+static int crc6(const int *bits, const int len) {
+    int reg = 0;
+    for (int i = 0; i < len; i++) {
+        const int fb = ((reg >> (CRC6_L - 1)) & 1) ^ bits[i];
+        reg = (reg << 1) & ((1 << CRC6_L) - 1);
+        if (fb) reg ^= CRC6_POLY;
+    }
+    return reg;
+}
+
+/* First of the l candidates whose CRC checks, else the best one */
+static const int *crc_select(const int *msg_cap, const int K, const int l) {
+    for (int i = 0; i < l; i++) {
+        if (crc6(&msg_cap[i * K], K) == 0) return &msg_cap[i * K];
+    }
+    return msg_cap;
+}
+
+/* One code: K = A + CRC6, the parity bits and their PC-less twin */
+typedef struct PcCode {
+    int A, K, E, N, n_pc_wm;
+    NrRateMatch rm;
+    int *bit_type;    /* PC_FROZEN, PC_INFO or PC_PARITY */
+    int *bit_type_ci; /* parity positions as information bits */
+} PcCode;
+
+static int pc_code_init(PcCode *c, const UciCase *uc) {
+    memset(c, 0, sizeof(*c));
+    c->A = uc->A;
+    c->K = uc->A + CRC6_L;
+    c->E = uc->E;
+    c->N = 1 << nr_mother_n(c->K, c->E, N_MAX);
+    c->n_pc_wm = c->E - c->K + N_PC > 192;
+    if (nr_rm_init(&c->rm, c->N, c->K, c->E, 1) != 0) return -1;
+
+    const int N = c->N;
+    int Qn[N], Q_I[c->K + N_PC], info_nodes[N];
+    int i_Qn = 0;
+    for (int i_Q = 0; i_Q < 1024; i_Q++) {
+        if (Q[i_Q] < N) Qn[i_Qn++] = Q[i_Q];
+    }
+    /* Q_I is the K + n_pc most reliable positions, the parity bits among
+     * them; rate matching still selects with K */
+    NrRateMatch rm_pc = c->rm;
+    rm_pc.K = c->K + N_PC;
+    c->bit_type = malloc(sizeof(int) * (size_t)N);
+    c->bit_type_ci = malloc(sizeof(int) * (size_t)N);
+    if (!c->bit_type || !c->bit_type_ci
+        || nr_info_set(&rm_pc, Qn, Q_I, info_nodes) != 0) {
+        return -1;
+    }
+    pc_construct(N, c->K, N_PC, c->n_pc_wm, Q_I, c->bit_type);
+    for (int i = 0; i < N; i++) {
+        c->bit_type_ci[i] =
+            c->bit_type[i] == PC_PARITY ? PC_INFO : c->bit_type[i];
+    }
+    return 0;
+}
+
+static void pc_code_free(PcCode *c) {
+    nr_rm_free(&c->rm);
+    free(c->bit_type);
+    free(c->bit_type_ci);
+}
+
+/* The K information bits of the K + n_pc a CA-SCL list entry decoded */
+static void drop_parity(const PcCode *c, const int *msg_ci, int *msg) {
+    int k = 0, k_ci = 0;
+    for (int i = 0; i < c->N; i++) {
+        if (c->bit_type[i] == PC_INFO) {
+            msg[k++] = msg_ci[k_ci];
+        }
+        k_ci += c->bit_type_ci[i] == PC_INFO;
+    }
+}
+
+/* Parity positions against ones worked out by hand from 5.3.1.2.
+ * A = 12, E = 288: K = 18, N = 256 (repetition), Q_I the 21 most reliable
+ * positions of Q below 256, 190, 221, 235, 222, 237, ..., 255. The two least
+ * reliable, 190 and 221, are parity bits. The K = 18 from Q_I[3] on have
+ * row weight 2^6 at least (222, 237, 243, 238, 245, 246, 249, 250, 252), the
+ * most reliable of those, 252, is the third. A synthetic Q_I then puts a
+ * lower weight at Q_I[n_pc - n_pc_wm], which the search must skip. 0 or -1 */
+static int check_parity_positions(void) {
+    const UciCase uc = {12, 288};
+    const int expect[N_PC] = {190, 221, 252};
+    PcCode c;
+    int ret = pc_code_init(&c, &uc) == 0 && c.N == 256 && c.n_pc_wm == 1
+                  ? 0
+                  : -1;
+    for (int i = 0; ret == 0 && i < N_PC; i++) {
+        if (c.bit_type[expect[i]] != PC_PARITY) ret = -1;
+    }
+    int parity = 0;
+    for (int i = 0; ret == 0 && i < c.N; i++) {
+        parity += c.bit_type[i] == PC_PARITY;
+    }
+    if (parity != N_PC) ret = -1;
+    pc_code_free(&c);
+
+    /* N = 16, K = 4: parity 3 and 5, then the weight-2^3 tie among 7, 11,
+     * 13, 14 goes to the most reliable, 14; 1 (weight 2) is not a candidate */
+    int Q_I[4 + N_PC] = {3, 5, 1, 7, 11, 13, 14};
+    int bit_type[16];
+    pc_construct(16, 4, N_PC, 1, Q_I, bit_type);
+    if (bit_type[3] != PC_PARITY || bit_type[5] != PC_PARITY
+        || bit_type[14] != PC_PARITY || bit_type[1] != PC_INFO) {
+        ret = -1;
+    }
+    if (ret != 0) fprintf(stderr, "PC parity positions differ\n");
+    return ret;
+}
+
+static double elapsed_us(const struct timespec *t0,
+                         const struct timespec *t1) {
+    return (double)(t1->tv_sec - t0->tv_sec) * 1e6
+           + (double)(t1->tv_nsec - t0->tv_nsec) * 1e-3;
+}
+
+typedef struct PcResult {
+    double us_pc, us_ci;
+    int err_pc, err_ci;
+} PcResult;
+
+/* Frames at EbN0dB, or noiseless ones for EbN0dB = INFINITY */
+static void run_code(const PcCode *c, const int frames, const double EbN0dB,
+                     PcResult *res) {
+    const int N = c->N, K = c->K, E = c->E, K_ci = c->K + N_PC;
+    const double rate = (double)c->A / (double)E;
+    const double sig =
+        isinf(EbN0dB) ? 0.0
+                      : sqrt(1.0 / (2.0 * rate) * pow(10.0, -EbN0dB / 10.0));
+    memset(res, 0, sizeof(*res));
+
+    for (int i_f = 0; i_f < frames; i_f++) {
+        int msg[K], u[N], e[E], llr[E], LLR_Q[N];
+        int msg_cap[LIST * K], msg_ci[LIST * K_ci], msg_dec[K];
+
+        for (int i = 0; i < c->A; i++) {
+            msg[i] = rng_bit();
+        }
+        const int crc = crc6(msg, c->A);
+        for (int i = 0; i < CRC6_L; i++) {
+            msg[c->A + i] = (crc >> (CRC6_L - 1 - i)) & 1;
+        }
+        pc_encode(N, c->bit_type, msg, u);
+        encode(u, N);
+        nr_rate_match(&c->rm, u, e);
+
+        for (int k = 0; k < E; k++) {
+            const double y = (double)(1 - 2 * e[k]) + sig * rng_normal();
+            int q = (int)floor(y / RMAX * MAXQR);
+            q = q > MAXQR ? MAXQR : q < -(MAXQR + 1) ? -(MAXQR + 1) : q;
+            llr[k] = q;
+        }
+        nr_derate_match_int(&c->rm, llr, LLR_Q, MAXQR);
+
+        struct timespec t0, t1, t2, t3;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        decode_pcscl(N, K, LIST, c->bit_type, LLR_Q, msg_cap);
+        const int *best = crc_select(msg_cap, K, LIST);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        res->err_pc += memcmp(msg, best, sizeof(msg)) != 0;
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+        decode_pcscl(N, K_ci, LIST, c->bit_type_ci, LLR_Q, msg_ci);
+        for (int i = 0; i < LIST; i++) {
+            drop_parity(c, &msg_ci[i * K_ci], &msg_cap[i * K]);
+        }
+        memcpy(msg_dec, crc_select(msg_cap, K, LIST), sizeof(msg_dec));
+        clock_gettime(CLOCK_MONOTONIC, &t3);
+
+        res->err_ci += memcmp(msg, msg_dec, sizeof(msg)) != 0;
+        res->us_pc += elapsed_us(&t0, &t1);
+        res->us_ci += elapsed_us(&t2, &t3);
+    }
+    res->us_pc /= frames;
+    res->us_ci /= frames;
+}
+
+int main(int argc, char **argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 2000;
+    const double EbN0dB = argc > 2 ? atof(argv[2]) : 2.0;
+    if (frames < 1) {
+        fprintf(stderr, "usage: %s [frames] [EbN0dB]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("L = %d, Eb/N0 %.2f dB, %d frames per code\n", LIST, EbN0dB,
+           frames);
+    printf("A\tE\tN\tn_pc_wm\tCA-PC-SCL us/frame\tBLER\t"
+           "CA-SCL us/frame\tBLER\n");
+    int failed = check_parity_positions() != 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        PcCode c;
+        PcResult res;
+        if (pc_code_init(&c, &cases[i]) != 0) {
+            fprintf(stderr, "A %d E %d: no code\n", cases[i].A, cases[i].E);
+            pc_code_free(&c);
+            failed = 1;
+            continue;
+        }
+
+        run_code(&c, 20, INFINITY, &res);
+        if (res.err_pc != 0 || res.err_ci != 0) {
+            fprintf(stderr, "A %d E %d: noiseless frames decoded wrong\n",
+                    c.A,
+                    c.E);
+            failed = 1;
+        }
+
+        run_code(&c, frames, EbN0dB, &res);
+        printf("%d\t%d\t%d\t%d\t%.1f\t\t\t%.4f\t%.1f\t\t%.4f\n",
+               c.A,
+               c.E,
+               c.N,
+               c.n_pc_wm,
+               res.us_pc,
+               (double)res.err_pc / frames,
+               res.us_ci,
+               (double)res.err_ci / frames);
+        pc_code_free(&c);
+    }
+    return failed ? EXIT_FAILURE : 0;
+}
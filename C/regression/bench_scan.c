@@ -0,0 +1,181 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "functions_BP.h"
+#include "functions_SCD.h"
+#include "regression.h"
+#include "scan_decode.h"
+
+/* Usage: bench_scan vectors
+ * Frame error rate per noise level and decode time of the soft-output SCAN
+ * decoder (1, 2, 4 and 8 iterations) against the SC decoder Decode() and
+ * normalized min-sum BP on the natural factor graph (pruned schedule, 40
+ * iterations at most, G-matrix stopping, as BP_simulate). Every decoder gets the recorded
+ * quantized LLRs: as they are for SC, as float for SCAN, as int16 for BP. */
+
+#define BP_MAX_ITER (40)
+#define BP_ALPHA_Q  (7)
+
+static const int scan_iters[] = {1, 2, 4, 8};
+#define NUM_SCAN ((int)(sizeof(scan_iters) / sizeof(scan_iters[0])))
+
+typedef struct BenchContext {
+    bool sc_info_nodes[REG_N];
+    ScanDecoder scan[NUM_SCAN];
+    BpParams bp;
+} BenchContext;
+
+static void decode_sc(void *ctx, const RegVectors *v, const int i_f,
+                      int *msg_cap) {
+    const BenchContext *c = ctx;
+    Decode(msg_cap,
+           (unsigned)v->K,
+           &v->LLR_Q[i_f * v->N],
+           c->sc_info_nodes,
+           v->data_pos);
+}
+
+static void decode_scan(ScanDecoder *s, const RegVectors *v, const int i_f,
+                        int *msg_cap) {
+    float LLR[v->N], LLR_out[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        LLR[i_N] = (float)v->LLR_Q[i_f * v->N + i_N];
+    }
+    scan_decode(s, LLR, LLR_out, msg_cap, v->K, v->data_pos);
+}
+
+#define SCAN_FN(I)                                                        \
+    static void decode_scan_##I(void *ctx, const RegVectors *v,          \
+                                const int i_f, int *msg_cap) {           \
+        decode_scan(&((BenchContext *)ctx)->scan[I], v, i_f, msg_cap);   \
+    }
+SCAN_FN(0)
+SCAN_FN(1)
+SCAN_FN(2)
+SCAN_FN(3)
+#undef SCAN_FN
+
+static void decode_bp(void *ctx, const RegVectors *v, const int i_f,
+                      int *msg_cap) {
+    const BenchContext *c = ctx;
+    int16_t LLR_Q[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        LLR_Q[i_N] = (int16_t)v->LLR_Q[i_f * v->N + i_N];
+    }
+    bp_decode(&c->bp, LLR_Q, msg_cap);
+}
+
+/* Index of EbN0dB in levels, num_levels if new */
+static int level_of(const float *levels, const int num_levels,
+                    const float EbN0dB) {
+    int lv = 0;
+    while (lv < num_levels && fabsf(levels[lv] - EbN0dB) > 1e-3f) lv++;
+    return lv;
+}
+
+/* One pass over the frames: frame errors per noise level, total time */
+static void run_decoder(const char *name, const RegDecodeFn decode, void *ctx,
+                        const RegVectors *v, const float *levels,
+                        const int num_levels) {
+    int fe[num_levels], frames[num_levels];
+    memset(fe, 0, sizeof(fe));
+    memset(frames, 0, sizeof(frames));
+    int msg_cap[v->K];
+    double us = 0;
+
+    for (int i_f = 0; i_f < v->num_frames; i_f++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        decode(ctx, v, i_f, msg_cap);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        us += (double)(t1.tv_sec - t0.tv_sec) * 1e6
+              + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3;
+
+        const int lv = level_of(levels, num_levels, v->EbN0dB[i_f]);
+        frames[lv]++;
+        fe[lv] += memcmp(msg_cap, &v->msg[i_f * v->K], sizeof(msg_cap)) != 0;
+    }
+
+    printf("%-10s", name);
+    for (int lv = 0; lv < num_levels; lv++) {
+        printf("\t%.4f", frames[lv] > 0 ? (double)fe[lv] / frames[lv] : 0.0);
+    }
+    us /= v->num_frames;
+    printf("\t%.1f\t\t%.2f\n", us, (double)v->K / us);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s vectors\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    /* Noise levels in the order of the frames */
+    float levels[v.num_frames];
+    int num_levels = 0;
+    for (int i_f = 0; i_f < v.num_frames; i_f++) {
+        if (level_of(levels, num_levels, v.EbN0dB[i_f]) == num_levels) {
+            levels[num_levels++] = v.EbN0dB[i_f];
+        }
+    }
+
+    static BenchContext c;
+    BpSchedule sched;
+    if (bp_build_schedule(&sched, v.info_nodes, v.N, REG_n, NULL) != 0) {
+        reg_free_vectors(&v);
+        return EXIT_FAILURE;
+    }
+    for (int i_N = 0; i_N < v.N; i_N++) {
+        c.sc_info_nodes[i_N] = v.info_nodes[i_N] != 0;
+    }
+    for (int i = 0; i < NUM_SCAN; i++) {
+        if (scan_init(&c.scan[i], v.N, v.info_nodes, scan_iters[i]) != 0) {
+            reg_free_vectors(&v);
+            return EXIT_FAILURE;
+        }
+    }
+    c.bp = (BpParams){.N = v.N,
+                      .n = REG_n,
+                      .K = v.K,
+                      .info_nodes = v.info_nodes,
+                      .data_pos = v.data_pos,
+                      .max_iter = BP_MAX_ITER,
+                      .stop = BP_STOP_G_MATRIX,
+                      .polynomial = NULL,
+                      .crc_l = 0,
+                      .variant = MINSUM_NORMALIZED,
+                      .param = BP_ALPHA_Q,
+                      .perm = NULL,
+                      .sched = &sched};
+
+    printf("FER per Eb/N0 (dB), %d frames\ndecoder   ", v.num_frames);
+    for (int lv = 0; lv < num_levels; lv++) {
+        printf("\t%.2f", levels[lv]);
+    }
+    printf("\tus/frame\tMbps\n");
+
+    run_decoder("SC", decode_sc, &c, &v, levels, num_levels);
+    const RegDecodeFn scan_fns[NUM_SCAN] = {
+        decode_scan_0, decode_scan_1, decode_scan_2, decode_scan_3};
+    for (int i = 0; i < NUM_SCAN; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "SCAN I=%d", scan_iters[i]);
+        run_decoder(name, scan_fns[i], &c, &v, levels, num_levels);
+    }
+    run_decoder("BP", decode_bp, &c, &v, levels, num_levels);
+
+    for (int i = 0; i < NUM_SCAN; i++) {
+        scan_free(&c.scan[i]);
+    }
+    bp_free_schedule(&sched);
+    reg_free_vectors(&v);
+    return 0;
+}
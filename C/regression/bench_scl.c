@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "functions_SCL.h"
+#include "pmu.h"
+#include "regression.h"
+
+/* Working set of the SCL decoders: beliefs, decisions and survivor orders.
+ * decode_unrolled() keeps (n+1) x l*N ints of each. decode_interleaved()
+ * keeps the current node per depth: 2^(n-d) rows of l int beliefs, the
+ * 2^(n-d+1) decision bits of both children per path, and 2*l uint8_t
+ * orders. */
+static size_t bytes_unrolled(const int N, const int n, const int l) {
+    return 3 * sizeof(int) * (size_t)(n + 1) * (size_t)l * (size_t)N;
+}
+
+static size_t bytes_interleaved(const int N, const int n, const int l) {
+    size_t bytes = 0;
+    for (int d = 0; d <= n; d++) {
+        const int bits = (d == 0) ? N : (2 << (n - d));
+        bytes += sizeof(int) * (size_t)(1 << (n - d)) * (size_t)l;
+        bytes += sizeof(uint64_t) * (size_t)((bits + 63) / 64) * (size_t)l;
+        bytes += sizeof(uint8_t) * 2 * (size_t)l;
+    }
+    return bytes;
+}
+
+typedef void (*SclDecodeFn)(int N, int K, int l, int *info_nodes,
+                            int *data_pos, int *LLR_Q, int *msg_cap);
+
+/* decode_multibit() with leaves of M bits */
+#define MULTIBIT_FN(M)                                                       \
+    static void decode_mb##M(int N, int K, int l, int *info_nodes,          \
+                             int *data_pos, int *LLR_Q, int *msg_cap) {     \
+        decode_multibit(N, K, l, M, info_nodes, data_pos, LLR_Q, msg_cap);  \
+    }
+MULTIBIT_FN(1)
+MULTIBIT_FN(2)
+MULTIBIT_FN(4)
+MULTIBIT_FN(8)
+#undef MULTIBIT_FN
+
+/* decode_unrolled_i8() on the same LLRs, narrowed in the call */
+static void decode_i8(int N, int K, int l, int *info_nodes, int *data_pos,
+                      int *LLR_Q, int *msg_cap) {
+    int8_t LLR[N];
+    for (int i_N = 0; i_N < N; i_N++) {
+        LLR[i_N] = (int8_t)LLR_Q[i_N];
+    }
+    decode_unrolled_i8(N, K, l, info_nodes, data_pos, LLR, msg_cap);
+}
+
+/* Best of reps passes over all frames, in us per frame */
+static double time_decoder(const SclDecodeFn decode, const RegVectors *v,
+                           const int l, const int reps) {
+    int msg_cap[l * v->K];
+    double best = 0;
+    for (int r = 0; r < reps; r++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i_f = 0; i_f < v->num_frames; i_f++) {
+            decode(v->N, v->K, l, v->info_nodes, v->data_pos,
+                   &v->LLR_Q[i_f * v->N], msg_cap);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        const double us = ((double)(t1.tv_sec - t0.tv_sec) * 1e6
+                           + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3)
+                          / v->num_frames;
+        if (r == 0 || us < best) best = us;
+    }
+    return best;
+}
+
+/* Hardware counters of one pass over all frames, per info bit */
+static void count_decoder(PmuCounters *pc, const char *label,
+                          const SclDecodeFn decode, const RegVectors *v,
+                          const int l) {
+    int msg_cap[l * v->K];
+    pmu_reset(pc);
+    pmu_start(pc);
+    for (int i_f = 0; i_f < v->num_frames; i_f++) {
+        decode(v->N, v->K, l, v->info_nodes, v->data_pos,
+               &v->LLR_Q[i_f * v->N], msg_cap);
+    }
+    pmu_stop(pc, (uint64_t)v->num_frames * (uint64_t)(v->K - v->crc_l));
+    pmu_print(stdout, label, pc);
+}
+
+/* Usage: bench_scl vectors [reps]
+ * Decode time and working set of the path-major (decode_unrolled) and
+ * list-major, bit-packed (decode_interleaved) SCL decoders per list size,
+ * the decode time of decode_multibit() per leaf size M (N/M sequential
+ * decisions) and of the int8/int16 decode_unrolled_i8(), then their hardware counters per info bit where the system
+ * has them */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s vectors [reps]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const int reps = argc > 2 ? atoi(argv[2]) : 5;
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    printf("L\tunrolled KB\tus/frame\tinterleaved KB\tus/frame\tspeedup\n");
+    for (int l = 1; l <= 32; l <<= 1) {
+        const double t_unr = time_decoder(decode_unrolled, &v, l, reps);
+        const double t_il = time_decoder(decode_interleaved, &v, l, reps);
+        printf("%d\t%.1f\t\t%.1f\t\t%.1f\t\t%.1f\t\t%.2f\n",
+               l,
+               (double)bytes_unrolled(v.N, REG_n, l) / 1024,
+               t_unr,
+               (double)bytes_interleaved(v.N, REG_n, l) / 1024,
+               t_il,
+               t_unr / t_il);
+    }
+
+    const SclDecodeFn multibit[] = {
+        decode_mb1, decode_mb2, decode_mb4, decode_mb8};
+    printf("\nL\tmulti-bit us/frame, M = 1\t2\t4\t8\tint8 us/frame\n");
+    for (int l = 1; l <= 32; l <<= 1) {
+        printf("%d\t", l);
+        for (int i_m = 0; i_m < 4; i_m++) {
+            printf("\t%.1f", time_decoder(multibit[i_m], &v, l, reps));
+        }
+        printf("\t%.1f\n", time_decoder(decode_i8, &v, l, reps));
+    }
+
+    PmuCounters pc;
+    pmu_open(&pc);
+    printf("\n");
+    for (int l = 1; l <= 32; l <<= 1) {
+        char label[32];
+        snprintf(label, sizeof(label), "unrolled L=%d", l);
+        count_decoder(&pc, label, decode_unrolled, &v, l);
+        snprintf(label, sizeof(label), "interleaved L=%d", l);
+        count_decoder(&pc, label, decode_interleaved, &v, l);
+    }
+    pmu_close(&pc);
+
+    reg_free_vectors(&v);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "functions_SCL.h"
+#include "regression.h"
+
+/* Usage: bench_scs vectors [reps]
+ * CA-SCL (decode_unrolled(), the first path that passes the CRC) against
+ * the SC-Stack decoder decode_scs() with the same L and a stack of
+ * SCS_DEPTH * L paths, per noise level of the recorded vectors: frame error
+ * rate, decode time (best of reps passes) and the f and g evaluations of
+ * SCS relative to one SC decoding, N*n. SCL does L times the work of SC
+ * whatever the noise. */
+
+#define SCS_DEPTH (32)
+
+static const int polynomial[REG_CRC_L + 1] = {1, 1, 1, 0, 1, 0, 1, 0, 1};
+
+/* Index of EbN0dB in levels, num_levels if new */
+static int level_of(const float *levels, const int num_levels,
+                    const float EbN0dB) {
+    int lv = 0;
+    while (lv < num_levels && fabsf(levels[lv] - EbN0dB) > 1e-3f) lv++;
+    return lv;
+}
+
+static double elapsed_us(const struct timespec *t0,
+                         const struct timespec *t1) {
+    return (double)(t1->tv_sec - t0->tv_sec) * 1e6
+           + (double)(t1->tv_nsec - t0->tv_nsec) * 1e-3;
+}
+
+static void decode_scl(const RegVectors *v, const int i_f, const int l,
+                       int *msg_cap) {
+    int msg_list[l * v->K];
+    int crc_check[l];
+    decode_unrolled(v->N, v->K, l, v->info_nodes, v->data_pos,
+                    &v->LLR_Q[i_f * v->N], msg_list);
+    crcDet(msg_list, v->K, l, (int *)polynomial, v->crc_l, crc_check);
+    int crc_ind = 0;
+    for (int i_l = 0; i_l < l; i_l++) {
+        if (crc_check[i_l] == 0) {
+            crc_ind = i_l;
+            break;
+        }
+    }
+    memcpy(msg_cap, &msg_list[crc_ind * v->K], sizeof(int) * (size_t)v->K);
+}
+
+static int decode_stack(const RegVectors *v, const int i_f, const int l,
+                        ScsWork *w, int *msg_cap) {
+    return decode_scs(w, v->K, l, v->info_nodes, v->data_pos,
+                      &v->LLR_Q[i_f * v->N], (int *)polynomial, v->crc_l,
+                      msg_cap);
+}
+
+/* Frame errors, best us per frame and, for SCS, mean f/g evaluations over
+ * the frames of level lv */
+typedef struct LevelResult {
+    int frames;
+    int fe_scl, fe_scs;
+    double us_scl, us_scs;
+    double ops_scs;
+} LevelResult;
+
+static void run_level(const RegVectors *v, const float *levels,
+                      const int num_levels, const int lv, const int l,
+                      ScsWork *w, const int reps, LevelResult *r) {
+    int msg_cap[v->K];
+    memset(r, 0, sizeof(*r));
+
+    for (int rep = 0; rep < reps; rep++) {
+        double us_scl = 0, us_scs = 0;
+        for (int i_f = 0; i_f < v->num_frames; i_f++) {
+            if (level_of(levels, num_levels, v->EbN0dB[i_f]) != lv) continue;
+            const int *msg = &v->msg[i_f * v->K];
+            const size_t bytes = sizeof(int) * (size_t)v->K;
+            struct timespec t0, t1, t2;
+
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            decode_scl(v, i_f, l, msg_cap);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            const int fe_scl = memcmp(msg_cap, msg, bytes) != 0;
+            const int ops = decode_stack(v, i_f, l, w, msg_cap);
+            clock_gettime(CLOCK_MONOTONIC, &t2);
+            const int fe_scs = memcmp(msg_cap, msg, bytes) != 0;
+
+            us_scl += elapsed_us(&t0, &t1);
+            us_scs += elapsed_us(&t1, &t2);
+            if (rep == 0) {
+                r->frames++;
+                r->fe_scl += fe_scl;
+                r->fe_scs += fe_scs;
+                r->ops_scs += ops;
+            }
+        }
+        if (rep == 0 || us_scl < r->us_scl) r->us_scl = us_scl;
+        if (rep == 0 || us_scs < r->us_scs) r->us_scs = us_scs;
+    }
+    if (r->frames > 0) {
+        r->us_scl /= r->frames;
+        r->us_scs /= r->frames;
+        r->ops_scs /= (double)r->frames * (double)v->N * REG_n;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s vectors [reps]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    /* Noise levels in the order of the frames */
+    float levels[v.num_frames];
+    int num_levels = 0;
+    for (int i_f = 0; i_f < v.num_frames; i_f++) {
+        if (level_of(levels, num_levels, v.EbN0dB[i_f]) == num_levels) {
+            levels[num_levels++] = v.EbN0dB[i_f];
+        }
+    }
+
+    printf("L\tEb/N0\tFER SCL\tFER SCS\tSCS x SC\tSCL us\tSCS us\t"
+           "speedup\n");
+    for (int l = 2; l <= 32; l <<= 2) {
+        ScsWork w;
+        if (scs_work_init(&w, v.N, SCS_DEPTH * l) != 0) {
+            reg_free_vectors(&v);
+            return EXIT_FAILURE;
+        }
+        for (int lv = 0; lv < num_levels; lv++) {
+            LevelResult r;
+            run_level(&v, levels, num_levels, lv, l, &w, reps, &r);
+            printf("%d\t%.2f\t%.4f\t%.4f\t%.2f\t\t%.1f\t%.1f\t%.2f\n",
+                   l,
+                   levels[lv],
+                   r.frames > 0 ? (double)r.fe_scl / r.frames : 0.0,
+                   r.frames > 0 ? (double)r.fe_scs / r.frames : 0.0,
+                   r.ops_scs,
+                   r.us_scl,
+                   r.us_scs,
+                   r.us_scs > 0 ? r.us_scl / r.us_scs : 0.0);
+        }
+        scs_work_free(&w);
+    }
+
+    reg_free_vectors(&v);
+    return 0;
+}
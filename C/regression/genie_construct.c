@@ -0,0 +1,319 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "latency.h"
+#include "reliability.h"
+
+/* Usage: genie_construct [-K K] [-f frames] [-t threads] [-s seed] [-q Q]
+ *                        [-o out] N EbN0dB
+ * Genie-aided SC construction: random u over all N bits, BPSK over AWGN at
+ * Eb/N0 for the rate K/N, then min-sum SC decoding that feeds the true u_i
+ * back instead of its decisions. Every bit channel then sees a correct past,
+ * so each decision error is a first error of that index and the counts
+ * estimate the synthetic channel error rates directly. The N indices go to
+ * out (default stdout) in increasing reliability, the layout POLAR_Q reads
+ * (reliability.h): most errors first, ties broken by the mean LLR of the
+ * true bit, which keeps ordering the channels that never erred.
+ *
+ * -K  information bits for the rate and the bound below, default N / 2
+ * -f  frames, default 100000
+ * -t  threads, default the online CPUs
+ * -s  seed, default 1
+ * -q  reliability sequence to compare: its SC BLER bound is printed too
+ *
+ * Frames go in blocks of GENIE_BLOCK, each with its own generator seeded
+ * from (seed, block); the LLR sums are kept in fixed point, so the output
+ * does not depend on the thread count. The summary on stderr gives the
+ * union bound on the SC BLER, the sum of the K lowest error rates. */
+
+#define GENIE_BLOCK     (256)
+#define GENIE_LLR_SCALE (16.0f) /* fixed-point LLR sums, 1/16 */
+
+typedef struct Genie {
+    int N;
+    long long frames;
+    float sig;
+    uint64_t seed;
+    atomic_llong next_block;
+} Genie;
+
+typedef struct GenieThread {
+    pthread_t thread;
+    Genie *g;
+    uint64_t *err;  /* N: decisions != u_i */
+    int64_t *llr;   /* N: LLR of the true bit, GENIE_LLR_SCALE */
+    int *u;         /* N */
+    int *x;         /* N: partial sums of the genie */
+    float *beliefs; /* 2N: node of n values at 2N - 2n */
+} GenieThread;
+
+typedef struct GenieIndex {
+    int i;
+    uint64_t err;
+    int64_t llr;
+} GenieIndex;
+
+static uint64_t splitmix64(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Uniform in (0, 1] */
+static double uniform(uint64_t *s) {
+    return (double)((splitmix64(s) >> 11) + 1) * 0x1.0p-53;
+}
+
+/* Polar transform in place, as encode() of the decoders */
+static void polar_encode(int *x, const int N) {
+    for (int del = 1; del < N; del <<= 1) {
+        for (int base = 0; base < N; base += 2 * del) {
+            for (int i = base; i < base + del; i++) {
+                x[i] ^= x[i + del];
+            }
+        }
+    }
+}
+
+/* SC node of n bits from index i: the genie's partial sums into x[0 .. n) */
+static void genie_node(GenieThread *gt, const int n, const int i, int *x) {
+    const int N = gt->g->N;
+    const float *L = gt->beliefs + 2 * N - 2 * n;
+    if (n == 1) {
+        const int u = gt->u[i];
+        gt->err[i] += (L[0] < 0) != u;
+        const int64_t q = (int64_t)lrintf(L[0] * GENIE_LLR_SCALE);
+        gt->llr[i] += u ? -q : q;
+        x[0] = u;
+        return;
+    }
+    const int h = n / 2;
+    float *C = gt->beliefs + 2 * N - n;
+    /* Branch-free: with random u the signs are coin flips */
+    for (int j = 0; j < h; j++) {
+        const float a = fabsf(L[j]), b = fabsf(L[j + h]);
+        C[j] = copysignf(a < b ? a : b, L[j]) * copysignf(1.0f, L[j + h]);
+    }
+    genie_node(gt, h, i, x);
+    for (int j = 0; j < h; j++) {
+        C[j] = (float)(1 - 2 * x[j]) * L[j] + L[j + h];
+    }
+    genie_node(gt, h, i + h, x + h);
+    for (int j = 0; j < h; j++) {
+        x[j] ^= x[j + h];
+    }
+}
+
+static void genie_frame(GenieThread *gt, uint64_t *rng) {
+    const int N = gt->g->N;
+    const float sig = gt->g->sig;
+    const float scale = 2.0f / (sig * sig);
+    for (int i = 0; i < N; i++) {
+        gt->u[i] = (int)(splitmix64(rng) >> 63);
+        gt->x[i] = gt->u[i];
+    }
+    polar_encode(gt->x, N);
+    for (int i = 0; i < N; i += 2) {
+        /* Box-Muller, two samples */
+        const double r = sqrt(-2.0 * log(uniform(rng)));
+        const double t = 6.283185307179586 * uniform(rng);
+        const float z[2] = {(float)(r * cos(t)), (float)(r * sin(t))};
+        for (int k = 0; k < 2 && i + k < N; k++) {
+            const float y = (float)(1 - 2 * gt->x[i + k]) + sig * z[k];
+            gt->beliefs[i + k] = scale * y;
+        }
+    }
+    genie_node(gt, N, 0, gt->x);
+}
+
+static void *genie_thread(void *arg) {
+    GenieThread *gt = arg;
+    Genie *g = gt->g;
+    const long long blocks = (g->frames + GENIE_BLOCK - 1) / GENIE_BLOCK;
+    for (;;) {
+        const long long b = atomic_fetch_add(&g->next_block, 1);
+        if (b >= blocks) break;
+        uint64_t rng = g->seed ^ ((uint64_t)b * 0xD1B54A32D192ED03ULL);
+        splitmix64(&rng);
+        const long long end = (b + 1) * GENIE_BLOCK < g->frames
+                                  ? (b + 1) * GENIE_BLOCK
+                                  : g->frames;
+        for (long long f = b * GENIE_BLOCK; f < end; f++) {
+            genie_frame(gt, &rng);
+        }
+    }
+    return NULL;
+}
+
+/* Least reliable first: more errors, then a lower LLR of the true bit */
+static int cmp_reliability(const void *pa, const void *pb) {
+    const GenieIndex *a = pa, *b = pb;
+    if (a->err != b->err) return a->err > b->err ? -1 : 1;
+    if (a->llr != b->llr) return a->llr < b->llr ? -1 : 1;
+    return a->i - b->i;
+}
+
+/* Sum of the error rates of the K most reliable indices of Q */
+static double sc_bound(const int N, const int K, const int *Q,
+                       const uint64_t *err, const long long frames) {
+    double p = 0;
+    for (int i_Q = N - K; i_Q < N; i_Q++) {
+        p += (double)err[Q[i_Q]] / (double)frames;
+    }
+    return p;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-K K] [-f frames] [-t threads] [-s seed] [-q Q] "
+            "[-o out] N EbN0dB\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    static Genie g;
+    int K = 0, num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *out_path = NULL, *cmp_path = NULL;
+    g.frames = 100000;
+    g.seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "K:f:t:s:q:o:")) != -1) {
+        switch (opt) {
+        case 'K':
+            K = atoi(optarg);
+            break;
+        case 'f':
+            g.frames = atoll(optarg);
+            break;
+        case 't':
+            num_threads = atoi(optarg);
+            break;
+        case 's':
+            g.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'q':
+            cmp_path = optarg;
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const int N = atoi(argv[optind]);
+    const float EbN0dB = strtof(argv[optind + 1], NULL);
+    if (K == 0) K = N / 2;
+    if (num_threads < 1) num_threads = 1;
+    if (N < 2 || (N & (N - 1)) != 0 || K < 1 || K > N || g.frames < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    g.N = N;
+    const float rate = (float)K / (float)N;
+    g.sig = sqrtf(1.0f / (2.0f * rate) * powf(10.0f, -EbN0dB / 10.0f));
+    atomic_init(&g.next_block, 0);
+
+    int cmp_Q[N];
+    if (cmp_path && rel_order_read(cmp_path, N, cmp_Q) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    GenieThread *threads = calloc((size_t)num_threads, sizeof(GenieThread));
+    if (!threads) return EXIT_FAILURE;
+    int failed = 0;
+    for (int t = 0; t < num_threads; t++) {
+        GenieThread *gt = &threads[t];
+        gt->g = &g;
+        gt->err = calloc((size_t)N, sizeof(uint64_t));
+        gt->llr = calloc((size_t)N, sizeof(int64_t));
+        gt->u = malloc(sizeof(int) * (size_t)N);
+        gt->x = malloc(sizeof(int) * (size_t)N);
+        gt->beliefs = malloc(sizeof(float) * 2 * (size_t)N);
+        failed |= !gt->err || !gt->llr || !gt->u || !gt->x || !gt->beliefs;
+    }
+
+    const uint64_t t0 = lat_now_ns();
+    for (int t = 0; t < num_threads && !failed; t++) {
+        pthread_create(&threads[t].thread, NULL, genie_thread, &threads[t]);
+    }
+    uint64_t err[N];
+    GenieIndex idx[N];
+    memset(err, 0, sizeof(err));
+    for (int i = 0; i < N; i++) {
+        idx[i].i = i;
+        idx[i].err = 0;
+        idx[i].llr = 0;
+    }
+    for (int t = 0; t < num_threads && !failed; t++) {
+        pthread_join(threads[t].thread, NULL);
+        for (int i = 0; i < N; i++) {
+            idx[i].err += threads[t].err[i];
+            idx[i].llr += threads[t].llr[i];
+        }
+    }
+    const double s = (double)(lat_now_ns() - t0) * 1e-9;
+
+    int Q[N];
+    if (!failed) {
+        qsort(idx, (size_t)N, sizeof(GenieIndex), cmp_reliability);
+        for (int i_Q = 0; i_Q < N; i_Q++) {
+            Q[i_Q] = idx[i_Q].i;
+            err[idx[i_Q].i] = idx[i_Q].err;
+        }
+
+        fprintf(stderr,
+                "%s: N %d, K %d, Eb/N0 %.2f dB, %lld frames on %d threads "
+                "in %.3f s, %.0f frames/s\n",
+                argv[0],
+                N,
+                K,
+                (double)EbN0dB,
+                g.frames,
+                num_threads,
+                s,
+                (double)g.frames / s);
+        fprintf(stderr, "SC BLER bound %g", sc_bound(N, K, Q, err, g.frames));
+        if (cmp_path) {
+            fprintf(stderr,
+                    ", %g with %s",
+                    sc_bound(N, K, cmp_Q, err, g.frames),
+                    cmp_path);
+        }
+        fprintf(stderr, "\n");
+
+        FILE *fp = out_path ? fopen(out_path, "w") : stdout;
+        if (!fp) {
+            fprintf(stderr, "cannot open %s\n", out_path);
+            failed = 1;
+        } else {
+            failed |= rel_order_write(fp, N, Q) != 0;
+            if (out_path) failed |= fclose(fp) != 0;
+        }
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        free(threads[t].err);
+        free(threads[t].llr);
+        free(threads[t].u);
+        free(threads[t].x);
+        free(threads[t].beliefs);
+    }
+    free(threads);
+    return failed ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(ARM_SSCL)
+#include "functions_SSCL_ARM.h"
+#elif defined(ARM_SSCD)
+#include "functions_SSCD_ARM.h"
+#else
+#include "functions_SCD_ARM.h"
+#endif
+#include "regression.h"
+#include "simd.h"
+
+/* One driver for the decoders of C/ARM: SC (default), SSC (ARM_SSCD) and
+ * SSCL (ARM_SSCL). They run on the SIMD backend simd.h picks for the build
+ * flags, so every backend is checked against the same vectors. */
+typedef struct ArmContext {
+    int l;
+    uint8_t polynomial[REG_CRC_L + 1];
+#if defined(ARM_SSCD) || defined(ARM_SSCL)
+    int node_type[REG_N * (REG_n + 1)];
+#endif
+} ArmContext;
+
+#if defined(ARM_SSCL)
+/* The first path of the list that passes the CRC (path 0 if none), as in
+ * SSCL_simulate_ARM.c */
+static void decode_arm(void *ctx, const RegVectors *v, const int i_f,
+                       int *msg_cap) {
+    ArmContext *c = ctx;
+    const int K = v->K;
+
+    uint8_t msg_list[c->l * K];
+    int crc_check[c->l];
+    decode_unrolled(v->N,
+                    K,
+                    c->l,
+                    v->info_nodes,
+                    v->data_pos,
+                    c->node_type,
+                    &v->LLR_Q[i_f * v->N],
+                    msg_list);
+    crcDet(msg_list, K, c->l, c->polynomial, v->crc_l, crc_check);
+
+    int crc_ind = 0;
+    for (int i_l = 0; i_l < c->l; i_l++) {
+        if (crc_check[i_l] == 0) {
+            crc_ind = i_l;
+            break;
+        }
+    }
+    for (int i = 0; i < K; i++) {
+        msg_cap[i] = msg_list[crc_ind * K + i];
+    }
+}
+#else
+static void decode_arm(void *ctx, const RegVectors *v, const int i_f,
+                       int *msg_cap) {
+    ArmContext *c = ctx;
+#if defined(ARM_SSCD)
+    decode(msg_cap,
+           v->N,
+           REG_n,
+           v->K,
+           &v->LLR_Q[i_f * v->N],
+           v->info_nodes,
+           v->data_pos,
+           c->node_type);
+#else
+    (void)c;
+    decode(msg_cap,
+           v->N,
+           REG_n,
+           v->K,
+           &v->LLR_Q[i_f * v->N],
+           v->info_nodes,
+           v->data_pos);
+#endif
+}
+#endif
+
+/* Usage: regress_arm_<decoder> vectors output [list_size] */
+int main(int argc, char **argv) {
+    static ArmContext c = {.l = 1, .polynomial = {1, 1, 1, 0, 1, 0, 1, 0, 1}};
+#if defined(ARM_SSCL)
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s vectors output list_size\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    c.l = atoi(argv[3]);
+    if (c.l < 1) {
+        fprintf(stderr, "bad list size %s\n", argv[3]);
+        return EXIT_FAILURE;
+    }
+#else
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s vectors output\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+#endif
+    printf("%s: SIMD backend %s\n", argv[0], SIMD_BACKEND_NAME);
+
+#if defined(ARM_SSCD) || defined(ARM_SSCL)
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    int data_pos_sorted[v.K], frozen_pos_sorted[v.N - v.K];
+    reg_sorted_positions(&v, data_pos_sorted, frozen_pos_sorted);
+#if defined(ARM_SSCD)
+    find_node_type(c.node_type,
+                   v.K,
+                   v.N - v.K,
+                   v.N,
+                   v.N,
+                   0,
+                   data_pos_sorted,
+                   frozen_pos_sorted);
+#else
+    find_node_type(
+        c.node_type, v.N, v.N, 0, data_pos_sorted, frozen_pos_sorted);
+#endif
+    reg_free_vectors(&v);
+#endif
+
+    return reg_run_driver(argc, argv, decode_arm, &c);
+}
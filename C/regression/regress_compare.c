@@ -0,0 +1,118 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "regression.h"
+
+/* Discordant frames of the statistical check may differ by at most
+ * Z_MAX standard deviations (McNemar's test) */
+#define Z_MAX (3.0)
+
+static int frame_error(const RegVectors *v, const int *bits, const int i_f) {
+    for (int i = 0; i < v->K; i++) {
+        if (bits[i_f * v->K + i] != v->msg[i_f * v->K + i]) return 1;
+    }
+    return 0;
+}
+
+static int frame_equal(const RegVectors *v, const int *a, const int *b,
+                       const int i_f) {
+    const size_t off = (size_t)i_f * (size_t)v->K;
+    return memcmp(&a[off], &b[off], sizeof(int) * (size_t)v->K) == 0;
+}
+
+/* Every frame of cand must equal the frame of ref */
+static int check_exact(const RegVectors *v, const int *ref, const int *cand) {
+    int num_diff = 0, first = -1;
+    for (int i_f = 0; i_f < v->num_frames; i_f++) {
+        if (!frame_equal(v, ref, cand, i_f)) {
+            if (first < 0) first = i_f;
+            num_diff++;
+        }
+    }
+    if (num_diff > 0) {
+        printf("%d of %d frames differ, first is frame %d (EbN0dB %.2f)\n",
+               num_diff,
+               v->num_frames,
+               first,
+               v->EbN0dB[first]);
+        return EXIT_FAILURE;
+    }
+    printf("all %d frames bit-exact\n", v->num_frames);
+    return EXIT_SUCCESS;
+}
+
+/* Frame errors of ref and cand must be statistically equivalent. Frames
+ * decoded correctly by only one of them are the evidence of a difference:
+ * b = only cand failed, c = only ref failed, |b - c| <= Z_MAX sqrt(b + c). */
+static int check_stat(const RegVectors *v, const int *ref, const int *cand) {
+    int b = 0, c = 0, same = 0;
+    float level = -1;
+    int fe_ref = 0, fe_cand = 0, frames = 0;
+
+    for (int i_f = 0; i_f <= v->num_frames; i_f++) {
+        /* Per noise level summary */
+        if (i_f == v->num_frames || fabsf(v->EbN0dB[i_f] - level) > 1e-3f) {
+            if (frames > 0) {
+                printf("EbN0dB %.2f\tBLER ref %lf\tcand %lf\n",
+                       level,
+                       (double)fe_ref / frames,
+                       (double)fe_cand / frames);
+            }
+            if (i_f == v->num_frames) break;
+            level = v->EbN0dB[i_f];
+            fe_ref = fe_cand = frames = 0;
+        }
+
+        const int e_ref = frame_error(v, ref, i_f);
+        const int e_cand = frame_error(v, cand, i_f);
+        fe_ref += e_ref;
+        fe_cand += e_cand;
+        frames++;
+
+        b += e_cand && !e_ref;
+        c += e_ref && !e_cand;
+        same += frame_equal(v, ref, cand, i_f);
+    }
+
+    const double bound = Z_MAX * sqrt((double)(b + c));
+    printf("%d of %d frames identical, only cand failed %d, only ref failed "
+           "%d (bound %.1f)\n",
+           same,
+           v->num_frames,
+           b,
+           c,
+           bound);
+    return fabs((double)(b - c)) <= bound ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Usage: regress_compare exact|stat vectors ref_output cand_output */
+int main(int argc, char **argv) {
+    if (argc < 5
+        || (strcmp(argv[1], "exact") != 0 && strcmp(argv[1], "stat") != 0)) {
+        fprintf(stderr,
+                "usage: %s exact|stat vectors ref_output cand_output\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    RegVectors v;
+    if (reg_read_vectors(argv[2], &v) != 0) return EXIT_FAILURE;
+
+    const size_t num_bits = (size_t)v.num_frames * (size_t)v.K;
+    int *ref = malloc(sizeof(int) * num_bits);
+    int *cand = malloc(sizeof(int) * num_bits);
+    int ret = EXIT_FAILURE;
+
+    if (ref && cand && reg_read_output(argv[3], v.num_frames, v.K, ref) == 0
+        && reg_read_output(argv[4], v.num_frames, v.K, cand) == 0) {
+        ret = strcmp(argv[1], "exact") == 0 ? check_exact(&v, ref, cand)
+                                            : check_stat(&v, ref, cand);
+    }
+
+    free(ref);
+    free(cand);
+    reg_free_vectors(&v);
+    return ret;
+}
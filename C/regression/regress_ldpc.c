@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "functions_LDPC.h"
+
+/* Usage: regress_ldpc bg_file
+ * The layered QC-LDPC decoders (float, int16 and int8 min-sum) on the
+ * built-in rate 1/2 base matrix of base_matrix.m: lightly noisy all-zero
+ * frames, with a few hard decisions flipped, must come back as the all-zero
+ * codeword. The same table is also written to bg_file in the 5G NR layout
+ * (qc_load_nr_base_graph()), with a different shift for every lifting set,
+ * and must load as the circulants of qc_init_base_graph() at that Z. */
+
+#define FRAMES    (20)
+#define MAX_ITER  (20)
+#define OFFSET    (0.5f)
+#define LLR_SCALE (4.0f)
+#define MAXQR_CH  (31)
+#define OFFSET_Q  (2)
+#define ALPHA_Q   (6)
+/* One hard decision in FLIP_ONE_IN is wrong */
+#define FLIP_ONE_IN (40)
+
+static uint32_t test_rand(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/* Uniform in [0, 1) */
+static float test_uniform(void) {
+    return (float)(test_rand() >> 8) * 0x1.0p-24f;
+}
+
+/* table at lifting set i_ls, the other sets shifted so a wrong set shows */
+static int write_nr_base_graph(const char *path, const int rows,
+                               const int cols, const int *table,
+                               const int i_ls) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    fprintf(fp, "# base_matrix.m rate 1/2, lifting set %d\n%d %d\n", i_ls,
+            rows, cols);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            if (table[i * cols + j] < 0) continue;
+            fprintf(fp, "%d %d", i, j);
+            for (int k = 0; k < QC_NUM_LIFT_SETS; k++) {
+                const int V = table[i * cols + j] + (k == i_ls ? 0 : k + 1);
+                fprintf(fp, " %d", V);
+            }
+            fprintf(fp, "\n");
+        }
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+static int same_graph(const QcBaseGraph *a, const QcBaseGraph *b) {
+    if (a->rows != b->rows || a->cols != b->cols || a->Z != b->Z
+        || a->num_blocks != b->num_blocks
+        || a->max_row_deg != b->max_row_deg) {
+        return 0;
+    }
+    const size_t n_shift = (size_t)(a->rows * a->cols);
+    const size_t n_row = (size_t)(a->rows + 1);
+    const size_t n_blk = (size_t)a->num_blocks;
+    return memcmp(a->shift, b->shift, sizeof(int) * n_shift) == 0
+           && memcmp(a->row_start, b->row_start, sizeof(int) * n_row) == 0
+           && memcmp(a->blk_col, b->blk_col, sizeof(int) * n_blk) == 0
+           && memcmp(a->blk_shift, b->blk_shift, sizeof(int) * n_blk) == 0;
+}
+
+/* FRAMES frames through every kernel; 0 if all decode to all-zero */
+static int run_graph(const char *name, const QcBaseGraph *bg) {
+    const int N = bg->cols * bg->Z;
+    float *LLR = malloc(sizeof(float) * (size_t)N);
+    int16_t *LLR_Q16 = malloc(sizeof(int16_t) * (size_t)N);
+    int8_t *LLR_Q8 = malloc(sizeof(int8_t) * (size_t)N);
+    uint8_t *c_hat = malloc((size_t)N);
+    if (!LLR || !LLR_Q16 || !LLR_Q8 || !c_hat) {
+        free(LLR);
+        free(LLR_Q16);
+        free(LLR_Q8);
+        free(c_hat);
+        return -1;
+    }
+
+    static const char *const kernel_name[] = {
+        "float offset", "int16 offset", "int8 offset", "int8 normalized"};
+    int frame_err[4] = {0}, flipped = 0;
+    for (int i_f = 0; i_f < FRAMES; i_f++) {
+        for (int i = 0; i < N; i++) {
+            const int flip = test_rand() % FLIP_ONE_IN == 0;
+            LLR[i] = flip ? -0.5f - test_uniform()
+                          : 1.0f + 4.0f * test_uniform();
+            flipped += flip;
+        }
+        quantize_i16(LLR, LLR_Q16, N, LLR_SCALE, MAXQR_CH);
+        quantize_i8(LLR, LLR_Q8, N, LLR_SCALE, MAXQR_CH);
+
+        for (int k = 0; k < 4; k++) {
+            memset(c_hat, 1, (size_t)N);
+            switch (k) {
+            case 0:
+                qc_decode(bg, LLR, c_hat, MAX_ITER, OFFSET);
+                break;
+            case 1:
+                qc_decode_i16(
+                    bg, LLR_Q16, c_hat, MAX_ITER, MINSUM_OFFSET, OFFSET_Q);
+                break;
+            case 2:
+                qc_decode_i8(
+                    bg, LLR_Q8, c_hat, MAX_ITER, MINSUM_OFFSET, OFFSET_Q);
+                break;
+            default:
+                qc_decode_i8(
+                    bg, LLR_Q8, c_hat, MAX_ITER, MINSUM_NORMALIZED, ALPHA_Q);
+                break;
+            }
+            int err = !qc_syndrome_ok(bg, c_hat);
+            for (int i = 0; i < N; i++) {
+                err |= c_hat[i];
+            }
+            frame_err[k] += err;
+        }
+    }
+
+    int ok = flipped > 0;
+    for (int k = 0; k < 4; k++) {
+        printf("%s N %d Z %d %-16s %d bits flipped, %d frame errors\n",
+               name,
+               N,
+               bg->Z,
+               kernel_name[k],
+               flipped,
+               frame_err[k]);
+        ok &= frame_err[k] == 0;
+    }
+
+    free(LLR);
+    free(LLR_Q16);
+    free(LLR_Q8);
+    free(c_hat);
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s bg_file\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int failed = 0;
+    QcBaseGraph bg, ref;
+    if (qc_init_base_graph(&bg, 12, 24, 81, BASE_MATRIX_R12) != 0) {
+        return EXIT_FAILURE;
+    }
+    failed |= run_graph("built-in", &bg) != 0;
+    qc_free_base_graph(&bg);
+
+    /* Z = 40 = 5 * 2^3, lifting set 2 */
+    const int Z = 40;
+    const int i_ls = qc_lifting_set(Z);
+    if (i_ls != 2
+        || write_nr_base_graph(argv[1], 12, 24, BASE_MATRIX_R12, i_ls) != 0
+        || qc_load_nr_base_graph(&bg, argv[1], Z) != 0) {
+        return EXIT_FAILURE;
+    }
+    if (qc_init_base_graph(&ref, 12, 24, Z, BASE_MATRIX_R12) != 0) {
+        qc_free_base_graph(&bg);
+        return EXIT_FAILURE;
+    }
+    const int same = same_graph(&bg, &ref);
+    printf("loaded %s at Z %d: %s\n", argv[1], Z, same ? "ok" : "FAILED");
+    failed |= !same;
+    failed |= run_graph("loaded", &bg) != 0;
+    qc_free_base_graph(&bg);
+    qc_free_base_graph(&ref);
+
+    return failed ? EXIT_FAILURE : 0;
+}
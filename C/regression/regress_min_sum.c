@@ -0,0 +1,136 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "min_sum.h"
+
+/* Usage: regress_min_sum
+ * check_node_i8(), check_node_i16() and boxplus_i16() against a float check
+ * node, value by value: the sign product and the corrected minimum of the
+ * other edges of every edge, for the offset and the normalized variant.
+ * The inputs include 0 and +-MINSUM_I*_MAX, and a normalized scale of 12/8
+ * takes large minima past MINSUM_I*_MAX, where the output saturates. */
+
+#define LANES (37)
+#define MAX_DEG (12)
+#define TRIALS (200)
+
+typedef struct MinSumCase {
+    MinSumVariant variant;
+    int param;
+} MinSumCase;
+
+static const MinSumCase cases[] = {
+    {MINSUM_OFFSET, 0},
+    {MINSUM_OFFSET, 2},
+    {MINSUM_OFFSET, 5},
+    {MINSUM_NORMALIZED, 6},
+    {MINSUM_NORMALIZED, 8},
+    {MINSUM_NORMALIZED, 12},
+};
+
+static uint32_t test_rand(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/* Input in +-max, three in eight of them 0, max or -max */
+static int test_msg(const int max) {
+    const uint32_t r = test_rand();
+    switch (r % 8) {
+    case 0:
+        return 0;
+    case 1:
+        return max;
+    case 2:
+        return -max;
+    default:
+        break;
+    }
+    const int mag = (int)((r >> 3) % (uint32_t)(max + 1));
+    return r & 0x100000 ? -mag : mag;
+}
+
+/* Float check node of deg edges, edge e at msg[e * lanes + z] */
+static void check_node_ref(const float *msg, float *out, const int deg,
+                           const int lanes, const MinSumCase *c,
+                           const float max) {
+    for (int z = 0; z < lanes; z++) {
+        for (int e = 0; e < deg; e++) {
+            float mag = max, sign = 1.0f;
+            for (int f = 0; f < deg; f++) {
+                if (f == e) continue;
+                const float m = msg[f * lanes + z];
+                mag = fminf(mag, fabsf(m));
+                sign *= m < 0 ? -1.0f : 1.0f;
+            }
+            if (c->variant == MINSUM_NORMALIZED) {
+                mag = floorf(mag * (float)c->param / 8.0f + 0.5f);
+            } else {
+                mag = fmaxf(mag - (float)c->param, 0.0f);
+            }
+            out[e * lanes + z] = sign * fminf(mag, max);
+        }
+    }
+}
+
+static int run_case(const MinSumCase *c) {
+    int err_i8 = 0, err_i16 = 0, err_box = 0;
+    for (int t = 0; t < TRIALS; t++) {
+        const int deg = 2 + t % (MAX_DEG - 1);
+        int8_t m8[MAX_DEG * LANES];
+        int16_t m16[MAX_DEG * LANES];
+        float f8[MAX_DEG * LANES], f16[MAX_DEG * LANES];
+        float ref8[MAX_DEG * LANES], ref16[MAX_DEG * LANES];
+        for (int i = 0; i < deg * LANES; i++) {
+            m8[i] = (int8_t)test_msg(MINSUM_I8_MAX);
+            m16[i] = (int16_t)test_msg(MINSUM_I16_MAX);
+            f8[i] = m8[i];
+            f16[i] = m16[i];
+        }
+        check_node_ref(f8, ref8, deg, LANES, c, MINSUM_I8_MAX);
+        check_node_ref(f16, ref16, deg, LANES, c, MINSUM_I16_MAX);
+        check_node_i8(m8, deg, LANES, c->variant, c->param);
+        check_node_i16(m16, deg, LANES, c->variant, c->param);
+        for (int i = 0; i < deg * LANES; i++) {
+            err_i8 += (int)ref8[i] != m8[i];
+            err_i16 += (int)ref16[i] != m16[i];
+        }
+
+        /* boxplus of edges 0 and 1 is the output of a third edge */
+        int16_t box[3 * LANES];
+        float fbox[3 * LANES], refbox[3 * LANES];
+        for (int i = 0; i < 3 * LANES; i++) {
+            box[i] = (int16_t)test_msg(MINSUM_I16_MAX);
+            fbox[i] = box[i];
+        }
+        check_node_ref(fbox, refbox, 3, LANES, c, MINSUM_I16_MAX);
+        boxplus_i16(
+            &box[2 * LANES], box, &box[LANES], LANES, c->variant, c->param);
+        for (int i = 2 * LANES; i < 3 * LANES; i++) {
+            err_box += (int)refbox[i] != box[i];
+        }
+    }
+
+    const int ok = err_i8 == 0 && err_i16 == 0 && err_box == 0;
+    printf("%-10s param %2d: %d int8, %d int16, %d boxplus mismatches, %s\n",
+           c->variant == MINSUM_NORMALIZED ? "normalized" : "offset",
+           c->param,
+           err_i8,
+           err_i16,
+           err_box,
+           ok ? "ok" : "FAILED");
+    return ok ? 0 : -1;
+}
+
+int main(void) {
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        failed |= run_case(&cases[i]) != 0;
+    }
+    return failed ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,143 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "functions_SCD.h"
+#include "regression.h"
+#include "scan_decode.h"
+#include "tree_decode.h"
+
+/* Fixed-point SC decoder Decode() (g clamped to the LLR range) */
+static void decode_sc(void *ctx, const RegVectors *v, const int i_f,
+                      int *msg_cap) {
+    const bool *info_nodes = ctx;
+    Decode(msg_cap,
+           (unsigned)v->K,
+           &v->LLR_Q[i_f * v->N],
+           info_nodes,
+           v->data_pos);
+}
+
+/* Float tree SC decoder treeDecode() on the same (integer valued) LLRs */
+static void decode_tree(void *ctx, const RegVectors *v, const int i_f,
+                        int *msg_cap) {
+    (void)ctx;
+    float LLR_float[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        LLR_float[i_N] = (float)v->LLR_Q[i_f * v->N + i_N];
+    }
+    treeDecode(msg_cap, (unsigned)v->K, LLR_float);
+}
+
+/* SCAN decoder scan_decode() on the same LLRs, hard decisions only */
+static void decode_scan(void *ctx, const RegVectors *v, const int i_f,
+                        int *msg_cap) {
+    ScanDecoder *s = ctx;
+    float LLR_float[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        LLR_float[i_N] = (float)v->LLR_Q[i_f * v->N + i_N];
+    }
+    scan_decode(s, LLR_float, NULL, msg_cap, v->K, v->data_pos);
+}
+
+/* Soft output of SCAN on noiseless BPSK of the first SOFT_FRAMES recorded
+ * messages, LLRs +-SOFT_LLR: the decisions are u, sign(LLR + LLR_out) is
+ * encode(u_hat), and LLR_out[j] alone gives bit j and stays the same when
+ * the channel LLR of bit j is erased (even frames) or flipped (odd frames).
+ * The graph has cycles, so in noise LLR_out[j] can still depend on LLR[j]
+ * through other bits; without noise it must not. Returns the number of
+ * failed checks, -1 if out of memory. */
+#define SOFT_FRAMES (2)
+#define SOFT_LLR    (8.0f)
+
+static int check_scan_soft(const RegVectors *v, const int iters) {
+    const int N = v->N, K = v->K;
+    ScanDecoder s;
+    if (scan_init(&s, N, v->info_nodes, iters) != 0) return -1;
+
+    int failed = 0;
+    for (int i_f = 0; i_f < SOFT_FRAMES && i_f < v->num_frames; i_f++) {
+        int u[N], x[N], x_hat[N];
+        memset(u, 0, sizeof(u));
+        for (int i_k = 0; i_k < K; i_k++) {
+            u[v->data_pos[i_k]] = v->msg[i_f * K + i_k];
+        }
+        memcpy(x, u, sizeof(x));
+        Encode(x);
+
+        float LLR[N], LLR_out[N], LLR_j[N], LLR_out_j[N];
+        for (int i_N = 0; i_N < N; i_N++) {
+            LLR[i_N] = x[i_N] ? -SOFT_LLR : SOFT_LLR;
+        }
+        scan_decode(&s, LLR, LLR_out, NULL, 0, NULL);
+        memcpy(x_hat, s.u_hat, sizeof(x_hat));
+        failed += memcmp(x_hat, u, sizeof(u)) != 0;
+        Encode(x_hat);
+        for (int i_N = 0; i_N < N; i_N++) {
+            failed += (LLR[i_N] + LLR_out[i_N] < 0) != x_hat[i_N];
+        }
+
+        memcpy(LLR_j, LLR, sizeof(LLR));
+        for (int j = 0; j < N; j++) {
+            LLR_j[j] = i_f & 1 ? -LLR[j] : 0.0f;
+            scan_decode(&s, LLR_j, LLR_out_j, NULL, 0, NULL);
+            LLR_j[j] = LLR[j];
+            failed += memcmp(&LLR_out_j[j], &LLR_out[j], sizeof(float)) != 0;
+            failed += x[j] ? LLR_out[j] >= 0 : LLR_out[j] <= 0;
+        }
+    }
+
+    printf("SCAN soft output, iterations %d: %d failed checks\n",
+           iters,
+           failed);
+    scan_free(&s);
+    return failed;
+}
+
+/* Usage: regress_scd vectors output sc|tree|scan [iterations]
+ * scan first checks the soft output (check_scan_soft()) after 1 and after
+ * the given number of iterations. */
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr,
+                "usage: %s vectors output sc|tree|scan [iterations]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[3], "tree") == 0) {
+        createDecodeTree(POLAR_CODE_STAGE);
+        return reg_run_driver(argc, argv, decode_tree, NULL);
+    }
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    if (strcmp(argv[3], "scan") == 0) {
+        ScanDecoder s;
+        const int iters = argc > 4 ? atoi(argv[4]) : 1;
+        const int ok = scan_init(&s, v.N, v.info_nodes, iters) == 0;
+        const int soft_ok = ok && check_scan_soft(&v, 1) == 0
+                            && check_scan_soft(&v, iters) == 0;
+        reg_free_vectors(&v);
+        if (!ok) {
+            fprintf(stderr, "bad iteration count\n");
+            return EXIT_FAILURE;
+        }
+        if (!soft_ok) {
+            scan_free(&s);
+            return EXIT_FAILURE;
+        }
+        const int ret = reg_run_driver(argc, argv, decode_scan, &s);
+        scan_free(&s);
+        return ret;
+    }
+    bool info_nodes[POLAR_CODE_LENGTH];
+    for (int i_N = 0; i_N < POLAR_CODE_LENGTH; i_N++) {
+        info_nodes[i_N] = v.info_nodes[i_N] != 0;
+    }
+    reg_free_vectors(&v);
+
+    return reg_run_driver(argc, argv, decode_sc, info_nodes);
+}
@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(FAST_SSCL)
+#include "functions_FSSCL.h"
+#elif defined(SSCL)
+#include "functions_SSCL.h"
+#else
+#include "functions_SCL.h"
+#endif
+#include "prof.h"
+#include "regression.h"
+
+/* One driver for the list decoders: SCL (int, or float with SCL_FLOAT),
+ * SSCL (SSCL) and Fast-SSCL (FAST_SSCL), which differ only in the LLR type
+ * and the node types of decode_unrolled(). SCL_INTERLEAVED runs the
+ * list-major layout of SCL, decode_interleaved(). SCL_SYSTEMATIC runs the
+ * systematic-output SCL decoders and maps every path back to message bits
+ * before the CRC. SCL_STACK runs the SC-Stack decoder decode_scs() with
+ * list_size forks per bit and a stack of SCS_DEPTH paths per list entry;
+ * it applies the CRC itself. SCL_MULTIBIT runs decode_multibit() with the
+ * leaf size of the optional last argument. SCL_I8 runs decode_unrolled_i8()
+ * on int8 beliefs with int16 path metrics. */
+#define SCS_DEPTH (32)
+
+#if defined(SCL_FLOAT)
+typedef float llr_t;
+#elif defined(SCL_I8)
+typedef int8_t llr_t;
+#else
+typedef int llr_t;
+#endif
+
+typedef struct SclContext {
+    int l;
+    int leaf_size;
+    int polynomial[REG_CRC_L + 1];
+#if defined(SSCL) || defined(FAST_SSCL)
+    int node_type[REG_N * (REG_n + 1)];
+#endif
+#if defined(SCL_STACK)
+    ScsWork scs;
+#endif
+} SclContext;
+
+/* The first path of the list that passes the CRC (path 0 if none), as in
+ * the list decoder simulations */
+static void decode_list(void *ctx, const RegVectors *v, const int i_f,
+                        int *msg_cap) {
+    SclContext *c = ctx;
+    const int K = v->K;
+
+    llr_t LLR[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        LLR[i_N] = (llr_t)v->LLR_Q[i_f * v->N + i_N];
+    }
+
+#if defined(SCL_STACK)
+    decode_scs(&c->scs, K, c->l, v->info_nodes, v->data_pos, LLR,
+               c->polynomial, v->crc_l, msg_cap);
+#else
+    int msg_list[c->l * K];
+    int crc_check[c->l];
+#if defined(SSCL) || defined(FAST_SSCL)
+    decode_unrolled(
+        v->N, K, c->l, v->info_nodes, v->data_pos, c->node_type, LLR, msg_list);
+#elif defined(SCL_SYSTEMATIC)
+    int x_list[c->l * K];
+#if defined(SCL_INTERLEAVED)
+    decode_interleaved_sys(
+        v->N, K, c->l, v->info_nodes, v->data_pos, LLR, x_list);
+#else
+    decode_unrolled_sys(
+        v->N, K, c->l, v->info_nodes, v->data_pos, LLR, x_list);
+#endif
+    for (int i_l = 0; i_l < c->l; i_l++) {
+        reg_unsystematic(v, &x_list[i_l * K], &msg_list[i_l * K], encode);
+    }
+#elif defined(SCL_I8)
+    decode_unrolled_i8(
+        v->N, K, c->l, v->info_nodes, v->data_pos, LLR, msg_list);
+#elif defined(SCL_MULTIBIT)
+    decode_multibit(v->N, K, c->l, c->leaf_size, v->info_nodes, v->data_pos,
+                    LLR, msg_list);
+#elif defined(SCL_INTERLEAVED)
+    decode_interleaved(
+        v->N, K, c->l, v->info_nodes, v->data_pos, LLR, msg_list);
+#else
+    decode_unrolled(v->N, K, c->l, v->info_nodes, v->data_pos, LLR, msg_list);
+#endif
+    crcDet(msg_list, K, c->l, c->polynomial, v->crc_l, crc_check);
+
+    int crc_ind = 0;
+    for (int i_l = 0; i_l < c->l; i_l++) {
+        if (crc_check[i_l] == 0) {
+            crc_ind = i_l;
+            break;
+        }
+    }
+    for (int i = 0; i < K; i++) {
+        msg_cap[i] = msg_list[crc_ind * K + i];
+    }
+#endif
+}
+
+/* Usage: regress_<decoder> vectors output list_size [leaf_size] */
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s vectors output list_size [leaf_size]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    static SclContext c = {.polynomial = {1, 1, 1, 0, 1, 0, 1, 0, 1}};
+    c.l = atoi(argv[3]);
+    if (c.l < 1) {
+        fprintf(stderr, "bad list size %s\n", argv[3]);
+        return EXIT_FAILURE;
+    }
+    c.leaf_size = argc > 4 ? atoi(argv[4]) : 1;
+    if (c.leaf_size != 1 && c.leaf_size != 2 && c.leaf_size != 4
+        && c.leaf_size != 8) {
+        fprintf(stderr, "bad leaf size %s\n", argv[4]);
+        return EXIT_FAILURE;
+    }
+
+#if defined(SSCL) || defined(FAST_SSCL)
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    int data_pos_sorted[v.K], frozen_pos_sorted[v.N - v.K];
+    reg_sorted_positions(&v, data_pos_sorted, frozen_pos_sorted);
+    find_node_type(
+        c.node_type, v.N, v.N, 0, data_pos_sorted, frozen_pos_sorted);
+    reg_free_vectors(&v);
+#endif
+
+#if defined(SCL_STACK)
+    if (scs_work_init(&c.scs, REG_N, SCS_DEPTH * c.l) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    const int ret = reg_run_driver(argc, argv, decode_list, &c);
+    PROF_REPORT("regress_sscl");
+#if defined(SCL_STACK)
+    scs_work_free(&c.scs);
+#endif
+    return ret;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "functions_SSCD.h"
+#include "pmu.h"
+#include "prof.h"
+#include "regression.h"
+
+/* Node types of the simplified SC decoder, built once per frozen set.
+ * SSCD_SYSTEMATIC decodes with decode_sys() and maps its codeword bits back
+ * to message bits. */
+typedef struct SscdContext {
+    int node_type[REG_N * (REG_n + 1)];
+} SscdContext;
+
+static void decode_sscd(void *ctx, const RegVectors *v, const int i_f,
+                        int *msg_cap) {
+    SscdContext *c = ctx;
+    PMU_START();
+#ifdef SSCD_SYSTEMATIC
+    int x_cap[v->K];
+    decode_sys(x_cap,
+               (unsigned)v->N,
+               REG_n,
+               (unsigned)v->K,
+               &v->LLR_Q[i_f * v->N],
+               v->info_nodes,
+               v->data_pos,
+               c->node_type);
+    PMU_STOP(v->K);
+    reg_unsystematic(v, x_cap, msg_cap, encode);
+#else
+    decode(msg_cap,
+           (unsigned)v->N,
+           REG_n,
+           (unsigned)v->K,
+           &v->LLR_Q[i_f * v->N],
+           v->info_nodes,
+           v->data_pos,
+           c->node_type);
+    PMU_STOP(v->K);
+#endif
+}
+
+/* Usage: regress_sscd vectors output */
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s vectors output\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    int data_pos_sorted[v.K], frozen_pos_sorted[v.N - v.K];
+    reg_sorted_positions(&v, data_pos_sorted, frozen_pos_sorted);
+
+    static SscdContext c;
+    find_node_type(
+        c.node_type, v.N, v.N, 0, data_pos_sorted, frozen_pos_sorted);
+    reg_free_vectors(&v);
+
+    const int ret = reg_run_driver(argc, argv, decode_sscd, &c);
+    PROF_REPORT("regress_sscd");
+    PMU_REPORT("regress_sscd");
+    return ret;
+}
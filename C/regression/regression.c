@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "llr_trace.h"
+#include "regression.h"
+
+static int read_bits(FILE *fp, int *bits, const int K) {
+    for (int i = 0; i < K; i++) {
+        int c;
+        do {
+            c = fgetc(fp);
+        } while (c == ' ' || c == '\n' || c == '\r');
+        if (c != '0' && c != '1') return -1;
+        bits[i] = c - '0';
+    }
+    return 0;
+}
+
+/* Binary trace (llr_trace.h) into v: the frames are widened to int */
+static int read_trace(const char *path, RegVectors *v) {
+    LlrTrace t;
+    if (llr_trace_open(&t, path) != 0) return -1;
+
+    if (t.h->N != REG_N || t.h->num_frames == 0
+        || t.h->num_frames > (uint64_t)INT32_MAX) {
+        fprintf(stderr, "%s: bad header\n", path);
+        llr_trace_close(&t);
+        return -1;
+    }
+    v->N = (int)t.h->N;
+    v->K = (int)t.h->K;
+    v->crc_l = (int)t.h->crc_l;
+    v->num_frames = (int)t.h->num_frames;
+
+    const size_t F = (size_t)v->num_frames;
+    v->data_pos = malloc(sizeof(int) * (size_t)v->K);
+    v->info_nodes = calloc((size_t)v->N, sizeof(int));
+    v->EbN0dB = malloc(sizeof(float) * F);
+    v->msg = malloc(sizeof(int) * F * (size_t)v->K);
+    v->LLR_Q = malloc(sizeof(int) * F * (size_t)v->N);
+    int ok = v->data_pos && v->info_nodes && v->EbN0dB && v->msg && v->LLR_Q;
+
+    for (int i = 0; i < v->K && ok; i++) {
+        ok = t.data_pos[i] < t.h->N;
+        v->data_pos[i] = (int)t.data_pos[i];
+        if (ok) v->info_nodes[v->data_pos[i]] = 1;
+    }
+    for (int i_f = 0; i_f < v->num_frames && ok; i_f++) {
+        const uint8_t *bits = llr_trace_bits(&t, (uint64_t)i_f);
+        for (int i = 0; i < v->K; i++) {
+            v->msg[i_f * v->K + i] = bits[i];
+        }
+        v->EbN0dB[i_f] = llr_trace_ebn0(&t, (uint64_t)i_f);
+        llr_trace_llr_int(&t,
+                          (uint64_t)i_f,
+                          &v->LLR_Q[i_f * v->N],
+                          t.h->rmax,
+                          t.h->maxqr);
+    }
+    llr_trace_close(&t);
+
+    if (!ok) {
+        fprintf(stderr, "%s: malformed\n", path);
+        reg_free_vectors(v);
+        return -1;
+    }
+    return 0;
+}
+
+/* Vector file:
+ *   N K crc_l num_frames
+ *   data_pos[0] ... data_pos[K-1]
+ * then per frame
+ *   EbN0dB
+ *   K message bits as one string of 0/1
+ *   N quantized channel LLRs
+ * or a binary trace of llr_trace.h, told apart by its magic */
+int reg_read_vectors(const char *path, RegVectors *v) {
+    memset(v, 0, sizeof(*v));
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+
+    /* A binary trace instead of a text vector file */
+    char magic[sizeof(LLR_TRACE_MAGIC) - 1];
+    if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)
+        && memcmp(magic, LLR_TRACE_MAGIC, sizeof(magic)) == 0) {
+        fclose(fp);
+        return read_trace(path, v);
+    }
+    rewind(fp);
+
+    if (fscanf(fp, "%d %d %d %d", &v->N, &v->K, &v->crc_l, &v->num_frames)
+            != 4
+        || v->N != REG_N || v->K <= 0 || v->K > v->N || v->num_frames <= 0) {
+        fprintf(stderr, "%s: bad header\n", path);
+        fclose(fp);
+        return -1;
+    }
+
+    const size_t F = (size_t)v->num_frames;
+    v->data_pos = malloc(sizeof(int) * (size_t)v->K);
+    v->info_nodes = calloc((size_t)v->N, sizeof(int));
+    v->EbN0dB = malloc(sizeof(float) * F);
+    v->msg = malloc(sizeof(int) * F * (size_t)v->K);
+    v->LLR_Q = malloc(sizeof(int) * F * (size_t)v->N);
+    if (!v->data_pos || !v->info_nodes || !v->EbN0dB || !v->msg || !v->LLR_Q) {
+        fclose(fp);
+        reg_free_vectors(v);
+        return -1;
+    }
+
+    int ok = 1;
+    for (int i = 0; i < v->K && ok; i++) {
+        ok = fscanf(fp, "%d", &v->data_pos[i]) == 1 && v->data_pos[i] >= 0
+             && v->data_pos[i] < v->N;
+        if (ok) v->info_nodes[v->data_pos[i]] = 1;
+    }
+    for (int i_f = 0; i_f < v->num_frames && ok; i_f++) {
+        ok = fscanf(fp, "%f", &v->EbN0dB[i_f]) == 1
+             && read_bits(fp, &v->msg[i_f * v->K], v->K) == 0;
+        for (int i = 0; i < v->N && ok; i++) {
+            ok = fscanf(fp, "%d", &v->LLR_Q[i_f * v->N + i]) == 1;
+        }
+    }
+    fclose(fp);
+
+    if (!ok) {
+        fprintf(stderr, "%s: truncated or malformed\n", path);
+        reg_free_vectors(v);
+        return -1;
+    }
+    return 0;
+}
+
+void reg_free_vectors(RegVectors *v) {
+    free(v->data_pos);
+    free(v->info_nodes);
+    free(v->EbN0dB);
+    free(v->msg);
+    free(v->LLR_Q);
+    memset(v, 0, sizeof(*v));
+}
+
+/* Output file of a driver: num_frames lines of K bits */
+int reg_read_output(const char *path, const int num_frames, const int K,
+                    int *bits) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    for (int i_f = 0; i_f < num_frames; i_f++) {
+        if (read_bits(fp, &bits[i_f * K], K) != 0) {
+            fprintf(stderr, "%s: frame %d missing\n", path, i_f);
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+/* Information and frozen positions in channel index order, as expected by
+ * the find_node_type() of the simplified decoders */
+void reg_sorted_positions(const RegVectors *v, int *data_pos_sorted,
+                          int *frozen_pos_sorted) {
+    int i_d = 0, i_fr = 0;
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        if (v->info_nodes[i_N]) {
+            data_pos_sorted[i_d++] = i_N;
+        } else {
+            frozen_pos_sorted[i_fr++] = i_N;
+        }
+    }
+}
+
+void reg_unsystematic(const RegVectors *v, const int *x_cap, int *msg_cap,
+                      void (*encode)(int *u, int N)) {
+    int w[v->N];
+    for (int i_N = 0; i_N < v->N; i_N++) {
+        w[i_N] = 0;
+    }
+    for (int i_m = 0; i_m < v->K; i_m++) {
+        w[v->data_pos[i_m]] = x_cap[i_m];
+    }
+    encode(w, v->N);
+    for (int i_m = 0; i_m < v->K; i_m++) {
+        msg_cap[i_m] = w[v->data_pos[i_m]];
+    }
+}
+
+/* Usage: <driver> vectors output [driver arguments]
+ * Decodes every recorded frame and writes the decoded bits to output. */
+int reg_run_driver(int argc, char **argv, const RegDecodeFn decode,
+                   void *ctx) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s vectors output [args]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    RegVectors v;
+    if (reg_read_vectors(argv[1], &v) != 0) return EXIT_FAILURE;
+
+    FILE *fp = fopen(argv[2], "w");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", argv[2]);
+        reg_free_vectors(&v);
+        return EXIT_FAILURE;
+    }
+
+    int msg_cap[v.K];
+    char line[v.K + 2];
+    float dec_time_used = 0;
+
+    for (int i_f = 0; i_f < v.num_frames; i_f++) {
+        const clock_t dec_start = clock();
+        decode(ctx, &v, i_f, msg_cap);
+        dec_time_used += (float)(clock() - dec_start);
+
+        for (int i = 0; i < v.K; i++) {
+            line[i] = (char)('0' + (msg_cap[i] != 0));
+        }
+        line[v.K] = '\n';
+        line[v.K + 1] = '\0';
+        fputs(line, fp);
+    }
+    fclose(fp);
+
+    printf("%s: %d frames, %.1f us per frame\n",
+           argv[0],
+           v.num_frames,
+           dec_time_used / CLOCKS_PER_SEC * 1e6f / (float)v.num_frames);
+
+    reg_free_vectors(&v);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+/**
+ * @file regression.h
+ * @brief Recorded LLR vectors and decoder drivers of the regression harness
+ *
+ * record_vectors writes a deterministic set of frames (N = 1024, K = 512
+ * with CRC-8, quantized channel LLRs as in the simulations). Every decoder
+ * gets a small driver that replays the file and writes one line of K decoded
+ * bits per frame; regress_compare then checks two such outputs either for
+ * bit-exactness or for statistical equivalence of their frame errors.
+ * record_vectors can write the same frames as a binary trace (llr_trace.h),
+ * which reg_read_vectors() reads as well.
+ */
+
+#include <stdio.h>
+
+/* Code of the recorded vectors, the same as in all *_simulate.c */
+#define REG_N      (1024)
+#define REG_n      (10)
+#define REG_K      (512)
+#define REG_CRC_L  (8)
+
+/* Recorded frames, one row per frame */
+typedef struct RegVectors {
+    int N;
+    int K;
+    int crc_l;
+    int num_frames;
+    int *data_pos;   /* K information positions, least reliable first */
+    int *info_nodes; /* N flags, 1 for information positions */
+    float *EbN0dB;   /* num_frames noise levels */
+    int *msg;        /* num_frames x K transmitted bits (CRC included) */
+    int *LLR_Q;      /* num_frames x N quantized channel LLRs */
+} RegVectors;
+
+/* Decodes frame i_f of v into msg_cap[K] */
+typedef void (*RegDecodeFn)(void *ctx, const RegVectors *v, int i_f,
+                            int *msg_cap);
+
+int reg_read_vectors(const char *path, RegVectors *v);
+
+void reg_free_vectors(RegVectors *v);
+
+int reg_read_output(const char *path, int num_frames, int K, int *bits);
+
+void reg_sorted_positions(const RegVectors *v, int *data_pos_sorted,
+                          int *frozen_pos_sorted);
+
+/* The message bits that a systematic decoder's codeword bits x_cap[K] at the
+ * information positions stand for: the first pass of the systematic encoder,
+ * with the decoder's own encode(). The vectors are not systematic, so its
+ * output compares with the other decoders' only after this. */
+void reg_unsystematic(const RegVectors *v, const int *x_cap, int *msg_cap,
+                      void (*encode)(int *u, int N));
+
+int reg_run_driver(int argc, char **argv, RegDecodeFn decode, void *ctx);
+
+#endif  // REGRESSION_H
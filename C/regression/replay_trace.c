@@ -0,0 +1,111 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "functions_SSCD.h"
+#include "latency.h"
+#include "llr_trace.h"
+
+/* Usage: replay_trace trace [reps]
+ * Streams the frames of a binary LLR trace from its mapping into the SSC
+ * decoder, reps passes, and prints the best time per frame and the bit and
+ * frame errors against the reference bits of the trace. The int8 LLRs are
+ * widened frame by frame into the int buffer decode() takes; nothing else is
+ * copied. */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s trace [reps]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const int reps = argc > 2 ? atoi(argv[2]) : 5;
+    if (reps < 1) {
+        fprintf(stderr, "bad repetitions %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    LlrTrace t;
+    if (llr_trace_open(&t, argv[1]) != 0) return EXIT_FAILURE;
+
+    const int N = (int)t.h->N;
+    const int K = (int)t.h->K;
+    unsigned n = 0;
+    while ((1 << n) < N) n++;
+    if ((1 << n) != N || t.h->llr_type != LLR_TRACE_INT8) {
+        fprintf(stderr, "%s: needs int8 LLRs and N a power of 2\n", argv[1]);
+        llr_trace_close(&t);
+        return EXIT_FAILURE;
+    }
+
+    /* Node types from the frozen set of the trace */
+    int data_pos[K], info_nodes[N];
+    int data_pos_sorted[K], frozen_pos_sorted[N - K];
+    for (int i = 0; i < N; i++) {
+        info_nodes[i] = 0;
+    }
+    for (int i = 0; i < K; i++) {
+        data_pos[i] = (int)t.data_pos[i];
+        info_nodes[data_pos[i]] = 1;
+    }
+    int i_d = 0, i_fr = 0;
+    for (int i = 0; i < N; i++) {
+        if (info_nodes[i]) {
+            data_pos_sorted[i_d++] = i;
+        } else {
+            frozen_pos_sorted[i_fr++] = i;
+        }
+    }
+    int *node_type = malloc(sizeof(int) * (size_t)N * (n + 1));
+    if (!node_type) {
+        llr_trace_close(&t);
+        return EXIT_FAILURE;
+    }
+    find_node_type(node_type, N, N, 0, data_pos_sorted, frozen_pos_sorted);
+
+    printf("%s: N %d K %d crc %u, %llu frames, seed 0x%llx\n",
+           argv[1],
+           N,
+           K,
+           t.h->crc_l,
+           (unsigned long long)t.h->num_frames,
+           (unsigned long long)t.h->seed);
+
+    double best_us = 0;
+    uint64_t bit_err = 0, frame_err = 0;
+    for (int r = 0; r < reps; r++) {
+        bit_err = 0;
+        frame_err = 0;
+        const uint64_t t0 = lat_now_ns();
+        for (uint64_t i_f = 0; i_f < t.h->num_frames; i_f++) {
+            int LLR_Q[N], msg_cap[K];
+            llr_trace_llr_int(&t, i_f, LLR_Q, t.h->rmax, t.h->maxqr);
+            decode(msg_cap,
+                   (unsigned)N,
+                   n,
+                   (unsigned)K,
+                   LLR_Q,
+                   info_nodes,
+                   data_pos,
+                   node_type);
+
+            const uint8_t *bits = llr_trace_bits(&t, i_f);
+            int cur_err = 0;
+            for (int i = 0; i < K; i++) {
+                cur_err += msg_cap[i] != bits[i];
+            }
+            bit_err += (uint64_t)cur_err;
+            frame_err += cur_err > 0;
+        }
+        const double us = (double)(lat_now_ns() - t0) * 1e-3
+                          / (double)t.h->num_frames;
+        if (r == 0 || us < best_us) best_us = us;
+    }
+
+    printf("SSC: %.2f us per frame, BER %f, BLER %f\n",
+           best_us,
+           (double)bit_err / ((double)K * (double)t.h->num_frames),
+           (double)frame_err / (double)t.h->num_frames);
+
+    free(node_type);
+    llr_trace_close(&t);
+    return 0;
+}
@@ -0,0 +1,611 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "latency.h"
+#include "protocol.h"
+#include "svc_decoders.h"
+
+/* Usage: polar_daemon [-w workers] [-b batch] [-1] socket
+ * Serves decode requests (protocol.h) on a UNIX stream socket.
+ *
+ * One I/O thread polls the listening socket and the clients, registers code
+ * configurations inline and collects the decode requests of every client per
+ * config id. A batch goes to the work queue when it holds batch requests, and
+ * whatever was collected goes at the end of each poll round, so batching
+ * never waits for more traffic. The workers decode a batch back to back on
+ * the same node types, then write the responses, one send per run of
+ * requests of the same client. Sends never block: what a client's socket
+ * does not take is queued and written by the I/O thread when the socket
+ * polls writable. A client that leaves more than CLIENT_OUT_MAX bytes of
+ * responses unread is disconnected, so it cannot stall the others.
+ *
+ * -w  worker threads, default the online CPUs
+ * -b  largest batch, default 32
+ * -1  exit once the last client has disconnected, after the first one */
+
+#define MAX_CLIENTS  (64)
+#define RECV_ROUNDS  (16)        /* reads per client and poll round */
+#define WORKER_STACK (16u << 20) /* SSCL keeps its L-path tree on the stack */
+#define CLIENT_OUT_MAX (4u << 20) /* unread response bytes per client */
+
+typedef struct Client {
+    int fd;
+    int wake_fd;          /* the I/O thread polls the other end */
+    int refs;             /* the I/O thread and each queued request */
+    pthread_mutex_t lock; /* refs and the output queue */
+    int broken;           /* gone or too slow: responses are dropped */
+    uint8_t *out;         /* responses the socket has not taken yet */
+    size_t out_len, out_cap;
+    size_t in_len;
+    uint8_t in[sizeof(SvcHeader) + SVC_MAX_PAYLOAD];
+} Client;
+
+typedef struct Request {
+    Client *client;
+    uint32_t seq;
+    uint64_t t_recv;
+    int8_t llr[SVC_MAX_N];
+} Request;
+
+typedef struct Batch {
+    struct Batch *next;
+    uint32_t config_id;
+    int count;
+    Request req[];
+} Batch;
+
+typedef struct Daemon {
+    int max_batch;
+
+    /* Written by the I/O thread only, before the first request of the id is
+     * queued, and never again */
+    SvcCode codes[SVC_MAX_CONFIGS];
+    int registered[SVC_MAX_CONFIGS];
+
+    /* I/O thread only */
+    Batch *pending[SVC_MAX_CONFIGS];
+    Client *clients[MAX_CLIENTS];
+    int num_clients;
+
+    /* Work queue and statistics, under lock */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    Batch *head, *tail;
+    int stop;
+    uint64_t frames, batches, crc_fail;
+    LatHist lat;
+} Daemon;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+static void client_retain(Client *c) {
+    pthread_mutex_lock(&c->lock);
+    c->refs++;
+    pthread_mutex_unlock(&c->lock);
+}
+
+static void client_release(Client *c) {
+    pthread_mutex_lock(&c->lock);
+    const int refs = --c->refs;
+    pthread_mutex_unlock(&c->lock);
+    if (refs == 0) {
+        close(c->fd);
+        pthread_mutex_destroy(&c->lock);
+        free(c->out);
+        free(c);
+    }
+}
+
+/* Writes what the socket of c takes without blocking; the bytes written, or
+ * -1 once the client is gone */
+static ssize_t client_write(const Client *c, const uint8_t *p,
+                            const size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        const ssize_t w = send(
+            c->fd, p + done, len - done, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (w <= 0) return -1;
+        done += (size_t)w;
+    }
+    return (ssize_t)done;
+}
+
+/* Drops the output of c and shuts its socket down, which the I/O thread
+ * reads as EOF and drops the client; under c->lock */
+static void client_break(Client *c) {
+    c->broken = 1;
+    c->out_len = 0;
+    shutdown(c->fd, SHUT_RDWR);
+}
+
+/* Sends what the socket takes now and queues the rest for the I/O thread.
+ * A client that went away, or lets too much pile up, loses its responses. */
+static void client_send(Client *c, const void *buf, const size_t len) {
+    const uint8_t *p = buf;
+    size_t left = len;
+    pthread_mutex_lock(&c->lock);
+    const int was_empty = c->out_len == 0;
+    if (!c->broken && was_empty) {
+        const ssize_t w = client_write(c, p, left);
+        if (w < 0) {
+            client_break(c);
+        } else {
+            p += w;
+            left -= (size_t)w;
+        }
+    }
+    if (!c->broken && left > 0) {
+        const size_t need = c->out_len + left;
+        if (need > CLIENT_OUT_MAX) {
+            client_break(c);
+        } else if (need > c->out_cap) {
+            const size_t cap = need > 2 * c->out_cap ? need : 2 * c->out_cap;
+            uint8_t *out = realloc(c->out, cap);
+            if (out) {
+                c->out = out;
+                c->out_cap = cap;
+            } else {
+                client_break(c);
+            }
+        }
+    }
+    if (!c->broken && left > 0) {
+        memcpy(c->out + c->out_len, p, left);
+        c->out_len += left;
+        if (was_empty) {
+            /* A full pipe already holds a wake-up */
+            const ssize_t r = write(c->wake_fd, "", 1);
+            (void)r;
+        }
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+/* Writes the queued output of c, from the I/O thread */
+static void client_flush(Client *c) {
+    pthread_mutex_lock(&c->lock);
+    if (!c->broken && c->out_len > 0) {
+        const ssize_t w = client_write(c, c->out, c->out_len);
+        if (w < 0) {
+            client_break(c);
+        } else {
+            c->out_len -= (size_t)w;
+            memmove(c->out, c->out + w, c->out_len);
+        }
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+static int client_has_output(Client *c) {
+    pthread_mutex_lock(&c->lock);
+    const int has_output = c->out_len > 0;
+    pthread_mutex_unlock(&c->lock);
+    return has_output;
+}
+
+static void respond(Client *c, const SvcHeader *req, const SvcStatus status) {
+    const SvcHeader h = {SVC_RESPONSE_MAGIC,
+                         req->type,
+                         (uint16_t)status,
+                         req->config_id,
+                         req->seq,
+                         0};
+    client_send(c, &h, sizeof(h));
+}
+
+static void queue_batch(Daemon *d, Batch *b) {
+    b->next = NULL;
+    pthread_mutex_lock(&d->lock);
+    if (d->tail) {
+        d->tail->next = b;
+    } else {
+        d->head = b;
+    }
+    d->tail = b;
+    pthread_cond_signal(&d->cond);
+    pthread_mutex_unlock(&d->lock);
+}
+
+static void flush_pending(Daemon *d) {
+    for (int id = 0; id < SVC_MAX_CONFIGS; id++) {
+        if (d->pending[id]) {
+            queue_batch(d, d->pending[id]);
+            d->pending[id] = NULL;
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    Daemon *d = arg;
+    const size_t resp_max = sizeof(SvcHeader) + SVC_MAX_N;
+    uint8_t *out = malloc(resp_max * (size_t)d->max_batch);
+    size_t off[d->max_batch + 1];
+    LatHist lat;
+    lat_reset(&lat);
+    uint64_t frames = 0, batches = 0, crc_fail = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&d->lock);
+        while (!d->head && !d->stop) {
+            pthread_cond_wait(&d->cond, &d->lock);
+        }
+        Batch *b = d->head;
+        if (b) {
+            d->head = b->next;
+            if (!d->head) d->tail = NULL;
+        }
+        pthread_mutex_unlock(&d->lock);
+        if (!b) break;
+
+        /* Without a response buffer the batch fails, as a request does when
+         * handle_decode() cannot allocate its batch */
+        if (!out) out = malloc(resp_max * (size_t)d->max_batch);
+        if (!out) {
+            for (int i = 0; i < b->count; i++) {
+                const SvcHeader req = {SVC_REQUEST_MAGIC,
+                                       SVC_DECODE,
+                                       0,
+                                       b->config_id,
+                                       b->req[i].seq,
+                                       0};
+                respond(b->req[i].client, &req, SVC_BAD_REQUEST);
+                client_release(b->req[i].client);
+            }
+            free(b);
+            continue;
+        }
+
+        /* Decode the whole batch, then answer */
+        const SvcCode *code = &d->codes[b->config_id];
+        const uint32_t K = code->cfg.K;
+        off[0] = 0;
+        for (int i = 0; i < b->count; i++) {
+            const Request *r = &b->req[i];
+            uint8_t *resp = out + off[i];
+            const SvcStatus status =
+                svc_decode(code, r->llr, resp + sizeof(SvcHeader));
+            const SvcHeader h = {SVC_RESPONSE_MAGIC,
+                                 SVC_DECODE,
+                                 (uint16_t)status,
+                                 b->config_id,
+                                 r->seq,
+                                 K};
+            memcpy(resp, &h, sizeof(h));
+            off[i + 1] = off[i] + sizeof(h) + K;
+            crc_fail += status == SVC_CRC_FAIL;
+        }
+
+        int first = 0;
+        for (int i = 1; i <= b->count; i++) {
+            if (i < b->count && b->req[i].client == b->req[first].client) {
+                continue;
+            }
+            client_send(b->req[first].client,
+                        out + off[first],
+                        off[i] - off[first]);
+            const uint64_t now = lat_now_ns();
+            for (int j = first; j < i; j++) {
+                lat_record(&lat, now - b->req[j].t_recv);
+                client_release(b->req[j].client);
+            }
+            first = i;
+        }
+        frames += (uint64_t)b->count;
+        batches++;
+        free(b);
+    }
+
+    pthread_mutex_lock(&d->lock);
+    d->frames += frames;
+    d->batches += batches;
+    d->crc_fail += crc_fail;
+    lat_merge(&d->lat, &lat);
+    pthread_mutex_unlock(&d->lock);
+    free(out);
+    return NULL;
+}
+
+static SvcStatus handle_config(Daemon *d, const SvcHeader *h,
+                               const uint8_t *payload) {
+    SvcConfigMsg cfg;
+    static uint32_t data_pos[SVC_MAX_N];
+    if (h->length < sizeof(cfg)) return SVC_BAD_REQUEST;
+    memcpy(&cfg, payload, sizeof(cfg));
+    if (cfg.K > SVC_MAX_N || h->length != sizeof(cfg) + 4 * cfg.K) {
+        return SVC_BAD_REQUEST;
+    }
+    memcpy(data_pos, payload + sizeof(cfg), 4 * cfg.K);
+
+    const uint32_t id = h->config_id;
+    if (d->registered[id]) {
+        return svc_code_same(&d->codes[id], &cfg, data_pos) ? SVC_OK
+                                                            : SVC_BAD_CONFIG;
+    }
+    if (svc_code_init(&d->codes[id], &cfg, data_pos) != 0) {
+        return SVC_BAD_CONFIG;
+    }
+    d->registered[id] = 1;
+    return SVC_OK;
+}
+
+static SvcStatus handle_decode(Daemon *d, Client *c, const SvcHeader *h,
+                               const uint8_t *payload) {
+    const uint32_t id = h->config_id;
+    if (!d->registered[id]) return SVC_BAD_CONFIG;
+    if (h->length != d->codes[id].cfg.N) return SVC_BAD_REQUEST;
+
+    Batch *b = d->pending[id];
+    if (!b) {
+        b = malloc(sizeof(Batch) + sizeof(Request) * (size_t)d->max_batch);
+        if (!b) return SVC_BAD_REQUEST;
+        b->config_id = id;
+        b->count = 0;
+        d->pending[id] = b;
+    }
+    Request *r = &b->req[b->count++];
+    r->client = c;
+    r->seq = h->seq;
+    r->t_recv = lat_now_ns();
+    memcpy(r->llr, payload, h->length);
+    client_retain(c);
+
+    if (b->count == d->max_batch) {
+        queue_batch(d, b);
+        d->pending[id] = NULL;
+    }
+    return SVC_OK;
+}
+
+/* Handles the complete messages in the input buffer of c; -1 drops it */
+static int handle_input(Daemon *d, Client *c) {
+    size_t pos = 0;
+    while (c->in_len - pos >= sizeof(SvcHeader)) {
+        SvcHeader h;
+        memcpy(&h, c->in + pos, sizeof(h));
+        if (h.magic != SVC_REQUEST_MAGIC || h.length > SVC_MAX_PAYLOAD) {
+            return -1;
+        }
+        if (c->in_len - pos < sizeof(h) + h.length) break;
+
+        const uint8_t *payload = c->in + pos + sizeof(h);
+        SvcStatus status = SVC_BAD_REQUEST;
+        if (h.config_id >= SVC_MAX_CONFIGS) {
+            status = SVC_BAD_CONFIG;
+        } else if (h.type == SVC_CONFIG) {
+            status = handle_config(d, &h, payload);
+        } else if (h.type == SVC_DECODE) {
+            status = handle_decode(d, c, &h, payload);
+        }
+        /* Queued decodes are answered by the workers */
+        if (h.type != SVC_DECODE || status != SVC_OK) {
+            respond(c, &h, status);
+        }
+        pos += sizeof(h) + h.length;
+    }
+    memmove(c->in, c->in + pos, c->in_len - pos);
+    c->in_len -= pos;
+    return 0;
+}
+
+/* Reads what c has sent, without blocking; -1 on EOF or error */
+static int client_read(Daemon *d, Client *c) {
+    for (int round = 0; round < RECV_ROUNDS; round++) {
+        const ssize_t r = recv(
+            c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, MSG_DONTWAIT);
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        c->in_len += (size_t)r;
+        if (handle_input(d, c) != 0) return -1;
+    }
+    return 0;
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0
+        || listen(fd, MAX_CLIENTS) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-w workers] [-b batch] [-1] socket\n", name);
+}
+
+int main(int argc, char **argv) {
+    long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_batch = 32;
+    int once = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:b:1")) != -1) {
+        switch (opt) {
+        case 'w':
+            num_workers = atol(optarg);
+            break;
+        case 'b':
+            max_batch = atoi(optarg);
+            break;
+        case '1':
+            once = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || num_workers < 1 || num_workers > 256
+        || max_batch < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *path = argv[optind];
+
+    static Daemon d;
+    d.max_batch = max_batch;
+    lat_reset(&d.lat);
+    pthread_mutex_init(&d.lock, NULL);
+    pthread_cond_init(&d.cond, NULL);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    const int listen_fd = listen_on(path);
+    if (listen_fd < 0) return EXIT_FAILURE;
+
+    /* Workers that queue output for a client wake the poll below */
+    int wake[2];
+    if (pipe(wake) != 0 || fcntl(wake[0], F_SETFL, O_NONBLOCK) != 0
+        || fcntl(wake[1], F_SETFL, O_NONBLOCK) != 0) {
+        perror("pipe");
+        return EXIT_FAILURE;
+    }
+
+    pthread_t workers[num_workers];
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, WORKER_STACK);
+    for (long i = 0; i < num_workers; i++) {
+        if (pthread_create(&workers[i], &attr, worker, &d) != 0) {
+            fprintf(stderr, "cannot start worker %ld\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    printf("%s: %ld workers, batches of up to %d, listening on %s\n",
+           argv[0],
+           num_workers,
+           max_batch,
+           path);
+    fflush(stdout);
+
+    int served = 0;
+    while (!interrupted && !(once && served && d.num_clients == 0)) {
+        struct pollfd fds[MAX_CLIENTS + 2];
+        fds[0].fd = listen_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = wake[0];
+        fds[1].events = POLLIN;
+        for (int i = 0; i < d.num_clients; i++) {
+            fds[i + 2].fd = d.clients[i]->fd;
+            fds[i + 2].events
+                = POLLIN | (client_has_output(d.clients[i]) ? POLLOUT : 0);
+        }
+        if (poll(fds, (nfds_t)d.num_clients + 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            uint8_t drain[64];
+            while (read(wake[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        /* Clients, last first so that dropping one keeps the indices */
+        for (int i = d.num_clients - 1; i >= 0; i--) {
+            const short revents = fds[i + 2].revents;
+            if (!revents) continue;
+            Client *c = d.clients[i];
+            if (revents & POLLOUT) client_flush(c);
+            if ((revents & ~POLLOUT) && client_read(&d, c) != 0) {
+                d.clients[i] = d.clients[--d.num_clients];
+                client_release(c);
+            }
+        }
+        flush_pending(&d);
+
+        if (fds[0].revents & POLLIN) {
+            const int fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0 && d.num_clients == MAX_CLIENTS) {
+                close(fd);
+            } else if (fd >= 0) {
+                Client *c = calloc(1, sizeof(Client));
+                if (!c) {
+                    close(fd);
+                    continue;
+                }
+                c->fd = fd;
+                c->wake_fd = wake[1];
+                c->refs = 1;
+                pthread_mutex_init(&c->lock, NULL);
+                d.clients[d.num_clients++] = c;
+                served = 1;
+            }
+        }
+    }
+
+    /* Drain the queue, then stop the workers */
+    flush_pending(&d);
+    pthread_mutex_lock(&d.lock);
+    d.stop = 1;
+    pthread_cond_broadcast(&d.cond);
+    pthread_mutex_unlock(&d.lock);
+    for (long i = 0; i < num_workers; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    for (int i = 0; i < d.num_clients; i++) {
+        client_release(d.clients[i]);
+    }
+    close(listen_fd);
+    close(wake[0]);
+    close(wake[1]);
+    unlink(path);
+
+    printf("%s: %llu frames in %llu batches (%.1f per batch), "
+           "%llu CRC failures\n",
+           argv[0],
+           (unsigned long long)d.frames,
+           (unsigned long long)d.batches,
+           d.batches ? (double)d.frames / (double)d.batches : 0.0,
+           (unsigned long long)d.crc_fail);
+    lat_print(stdout, "requests", &d.lat);
+
+    for (int id = 0; id < SVC_MAX_CONFIGS; id++) {
+        if (d.registered[id]) svc_code_free(&d.codes[id]);
+    }
+    pthread_cond_destroy(&d.cond);
+    pthread_mutex_destroy(&d.lock);
+    return 0;
+}
@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "latency.h"
+#include "llr_trace.h"
+#include "protocol.h"
+
+/* Usage: polar_loadgen [-l L] [-c clients] [-w window] [-n frames] [-o out]
+ *                      socket trace
+ * Replays the frames of a binary LLR trace (llr_trace.h) against
+ * polar_daemon and reports the sustained frames per second, the request
+ * latency and the bit and frame errors against the reference bits.
+ *
+ * -l  list size: SSCL with the CRC of the trace, default 0 for SSC
+ * -c  client threads, one connection each, default 1
+ * -w  requests in flight per client, default 16
+ * -n  frames in total, default those of the trace (cycled beyond)
+ * -o  decoded bits of the first pass over the trace, one line of K bits per
+ *     frame as the regression drivers write them
+ *
+ * SSC registers config id 0, SSCL the id L, so that runs of different list
+ * sizes can share one daemon. */
+
+#define CONNECT_TRIES (500) /* 10 ms apart, while the daemon starts */
+
+typedef struct Load {
+    const char *path;
+    LlrTrace trace;
+    SvcConfigMsg cfg;
+    uint32_t config_id;
+    int num_clients;
+    int window;
+    uint64_t frames;
+    uint64_t *send_ns; /* frames */
+    uint8_t *out;      /* trace frames x K, or NULL */
+} Load;
+
+typedef struct LoadClient {
+    pthread_t thread;
+    int index;
+    Load *load;
+    int failed;
+    uint64_t frames, bit_err, frame_err, crc_fail;
+    LatHist lat;
+} LoadClient;
+
+static int connect_to(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    for (int t = 0; t < CONNECT_TRIES; t++) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) break;
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        const struct timespec pause = {0, 10000000};
+        nanosleep(&pause, NULL);
+    }
+    perror(path);
+    return -1;
+}
+
+static int send_config(const int fd, const Load *ld) {
+    const LlrTrace *t = &ld->trace;
+    const SvcHeader h = {SVC_REQUEST_MAGIC,
+                         SVC_CONFIG,
+                         0,
+                         ld->config_id,
+                         0,
+                         (uint32_t)(sizeof(SvcConfigMsg) + 4 * t->h->K)};
+    SvcHeader resp;
+    if (svc_write_full(fd, &h, sizeof(h)) != 0
+        || svc_write_full(fd, &ld->cfg, sizeof(ld->cfg)) != 0
+        || svc_write_full(fd, t->data_pos, 4 * t->h->K) != 0
+        || svc_read_full(fd, &resp, sizeof(resp)) != 0) {
+        return -1;
+    }
+    if (resp.magic != SVC_RESPONSE_MAGIC || resp.status != SVC_OK) {
+        fprintf(stderr, "config %u rejected, status %u\n",
+                ld->config_id,
+                resp.status);
+        return -1;
+    }
+    return 0;
+}
+
+static int send_frame(const int fd, Load *ld, const uint64_t i) {
+    const LlrTrace *t = &ld->trace;
+    const uint32_t N = t->h->N;
+    uint8_t buf[sizeof(SvcHeader) + SVC_MAX_N];
+    const SvcHeader h = {
+        SVC_REQUEST_MAGIC, SVC_DECODE, 0, ld->config_id, (uint32_t)i, N};
+    memcpy(buf, &h, sizeof(h));
+
+    int LLR_Q[SVC_MAX_N];
+    llr_trace_llr_int(t, i % t->h->num_frames, LLR_Q, t->h->rmax, t->h->maxqr);
+    for (uint32_t j = 0; j < N; j++) {
+        buf[sizeof(h) + j] = (uint8_t)(int8_t)LLR_Q[j];
+    }
+    ld->send_ns[i] = lat_now_ns();
+    return svc_write_full(fd, buf, sizeof(h) + N);
+}
+
+static int recv_result(const int fd, LoadClient *lc) {
+    Load *ld = lc->load;
+    const LlrTrace *t = &ld->trace;
+    const uint32_t K = t->h->K;
+    SvcHeader h;
+    uint8_t bits[SVC_MAX_N];
+    if (svc_read_full(fd, &h, sizeof(h)) != 0) return -1;
+    if (h.magic != SVC_RESPONSE_MAGIC || h.type != SVC_DECODE
+        || h.seq >= ld->frames || h.length != K
+        || (h.status != SVC_OK && h.status != SVC_CRC_FAIL)) {
+        fprintf(stderr, "bad response to frame %u, status %u\n",
+                h.seq,
+                h.status);
+        return -1;
+    }
+    if (svc_read_full(fd, bits, K) != 0) return -1;
+    lat_record(&lc->lat, lat_now_ns() - ld->send_ns[h.seq]);
+
+    const uint64_t i_f = h.seq % t->h->num_frames;
+    const uint8_t *ref = llr_trace_bits(t, i_f);
+    uint64_t cur_err = 0;
+    for (uint32_t j = 0; j < K; j++) {
+        cur_err += bits[j] != ref[j];
+    }
+    lc->bit_err += cur_err;
+    lc->frame_err += cur_err > 0;
+    lc->crc_fail += h.status == SVC_CRC_FAIL;
+    lc->frames++;
+    if (ld->out && h.seq < t->h->num_frames) {
+        memcpy(ld->out + (size_t)h.seq * K, bits, K);
+    }
+    return 0;
+}
+
+/* Frames index, index + clients, ... with at most window in flight */
+static void *run_client(void *arg) {
+    LoadClient *lc = arg;
+    Load *ld = lc->load;
+    lc->failed = 1;
+
+    const int fd = connect_to(ld->path);
+    if (fd < 0) return NULL;
+    if (send_config(fd, ld) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    const uint64_t step = (uint64_t)ld->num_clients;
+    uint64_t next = (uint64_t)lc->index;
+    uint64_t in_flight = 0;
+    while (next < ld->frames || in_flight > 0) {
+        while (next < ld->frames && in_flight < (uint64_t)ld->window) {
+            if (send_frame(fd, ld, next) != 0) {
+                close(fd);
+                return NULL;
+            }
+            next += step;
+            in_flight++;
+        }
+        if (recv_result(fd, lc) != 0) {
+            close(fd);
+            return NULL;
+        }
+        in_flight--;
+    }
+    close(fd);
+    lc->failed = 0;
+    return NULL;
+}
+
+static int write_output(const char *path, const Load *ld) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    const uint32_t K = ld->trace.h->K;
+    char line[K + 2];
+    for (uint64_t i_f = 0; i_f < ld->trace.h->num_frames; i_f++) {
+        for (uint32_t j = 0; j < K; j++) {
+            line[j] = (char)('0' + (ld->out[i_f * K + j] != 0));
+        }
+        line[K] = '\n';
+        line[K + 1] = '\0';
+        fputs(line, fp);
+    }
+    fclose(fp);
+    return 0;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-l L] [-c clients] [-w window] [-n frames] [-o out] "
+            "socket trace\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    static Load ld;
+    int list_size = 0;
+    long long frames = 0;
+    const char *out_path = NULL;
+    ld.num_clients = 1;
+    ld.window = 16;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:c:w:n:o:")) != -1) {
+        switch (opt) {
+        case 'l':
+            list_size = atoi(optarg);
+            break;
+        case 'c':
+            ld.num_clients = atoi(optarg);
+            break;
+        case 'w':
+            ld.window = atoi(optarg);
+            break;
+        case 'n':
+            frames = atoll(optarg);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 2 || list_size < 0 || list_size > SVC_MAX_LIST
+        || ld.num_clients < 1 || ld.window < 1 || frames < 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    ld.path = argv[optind];
+
+    LlrTrace *t = &ld.trace;
+    if (llr_trace_open(t, argv[optind + 1]) != 0) return EXIT_FAILURE;
+    /* float traces are quantized to int8 with the range they record */
+    if (t->h->N > SVC_MAX_N || t->h->num_frames == 0 || t->h->maxqr < 1
+        || t->h->maxqr > 127 || !(t->h->rmax > 0)) {
+        fprintf(stderr, "%s: no frames, N above %d or no int8 range\n",
+                argv[optind + 1],
+                SVC_MAX_N);
+        llr_trace_close(t);
+        return EXIT_FAILURE;
+    }
+    ld.frames = frames > 0 ? (uint64_t)frames : t->h->num_frames;
+    ld.cfg.decoder = list_size > 0 ? SVC_SSCL : SVC_SSC;
+    ld.cfg.N = t->h->N;
+    ld.cfg.K = t->h->K;
+    ld.cfg.list_size = (uint32_t)list_size;
+    ld.cfg.crc_l = list_size > 0 ? t->h->crc_l : 0;
+    ld.config_id = (uint32_t)list_size;
+    ld.send_ns = malloc(sizeof(uint64_t) * ld.frames);
+    if (out_path) ld.out = calloc(t->h->num_frames, t->h->K);
+    if (!ld.send_ns || (out_path && !ld.out)) {
+        llr_trace_close(t);
+        return EXIT_FAILURE;
+    }
+
+    LoadClient *clients = calloc((size_t)ld.num_clients, sizeof(LoadClient));
+    if (!clients) return EXIT_FAILURE;
+    const uint64_t t0 = lat_now_ns();
+    for (int c = 0; c < ld.num_clients; c++) {
+        clients[c].index = c;
+        clients[c].load = &ld;
+        lat_reset(&clients[c].lat);
+        pthread_create(&clients[c].thread, NULL, run_client, &clients[c]);
+    }
+
+    int failed = 0;
+    uint64_t done = 0, bit_err = 0, frame_err = 0, crc_fail = 0;
+    static LatHist lat;
+    lat_reset(&lat);
+    for (int c = 0; c < ld.num_clients; c++) {
+        pthread_join(clients[c].thread, NULL);
+        failed |= clients[c].failed;
+        done += clients[c].frames;
+        bit_err += clients[c].bit_err;
+        frame_err += clients[c].frame_err;
+        crc_fail += clients[c].crc_fail;
+        lat_merge(&lat, &clients[c].lat);
+    }
+    const double s = (double)(lat_now_ns() - t0) * 1e-9;
+
+    printf("%s: %s", argv[0], list_size > 0 ? "SSCL" : "SSC");
+    if (list_size > 0) printf(" L %d", list_size);
+    printf(", %d clients x %d in flight: %llu frames in %.3f s, "
+           "%.0f frames/s\n",
+           ld.num_clients,
+           ld.window,
+           (unsigned long long)done,
+           s,
+           (double)done / s);
+    if (done > 0) {
+        printf("BER %f, BLER %f, %llu CRC failures\n",
+               (double)bit_err / ((double)t->h->K * (double)done),
+               (double)frame_err / (double)done,
+               (unsigned long long)crc_fail);
+        lat_print(stdout, "requests", &lat);
+    }
+
+    if (!failed && out_path && write_output(out_path, &ld) != 0) failed = 1;
+
+    free(clients);
+    free(ld.send_ns);
+    free(ld.out);
+    llr_trace_close(t);
+    return failed || done != ld.frames ? EXIT_FAILURE : 0;
+}
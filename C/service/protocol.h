@@ -0,0 +1,89 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+/**
+ * @file protocol.h
+ * @brief Messages of the decode service over a UNIX stream socket
+ *
+ * Every message is a SvcHeader and its payload of header.length bytes, in
+ * host byte order (the socket is local). A client first registers a code
+ * configuration under an id of its choice, then sends any number of decode
+ * requests for that id; requests may be pipelined and the responses, matched
+ * by seq, can come back out of order. Config ids are shared by all clients;
+ * registering an id again is accepted only with the same code.
+ *
+ *   SVC_CONFIG  SvcConfigMsg, then data_pos[K] as uint32_t
+ *               -> SVC_CONFIG response, no payload
+ *   SVC_DECODE  N int8_t quantized LLRs
+ *               -> SVC_DECODE response, K uint8_t decoded bits (status OK or
+ *                  CRC_FAIL), nothing otherwise
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define SVC_REQUEST_MAGIC  (0x51524C50u) /* "PLRQ" */
+#define SVC_RESPONSE_MAGIC (0x53524C50u) /* "PLRS" */
+
+#define SVC_MAX_N       (1024)
+#define SVC_MAX_LIST    (32)
+#define SVC_MAX_CONFIGS (64)
+#define SVC_MAX_PAYLOAD (sizeof(SvcConfigMsg) + 4 * SVC_MAX_N)
+
+typedef enum SvcType { SVC_CONFIG = 1, SVC_DECODE = 2 } SvcType;
+
+typedef enum SvcStatus {
+    SVC_OK = 0,
+    SVC_CRC_FAIL = 1,    /* decoded, but no path of the list passed the CRC */
+    SVC_BAD_CONFIG = 2,  /* config id unknown, or registered differently */
+    SVC_BAD_REQUEST = 3
+} SvcStatus;
+
+typedef enum SvcDecoder { SVC_SSC = 0, SVC_SSCL = 1 } SvcDecoder;
+
+typedef struct SvcHeader {
+    uint32_t magic;
+    uint16_t type;      /* SvcType */
+    uint16_t status;    /* SvcStatus, responses only */
+    uint32_t config_id; /* < SVC_MAX_CONFIGS */
+    uint32_t seq;       /* chosen by the client, echoed in the response */
+    uint32_t length;    /* payload bytes that follow */
+} SvcHeader;
+
+typedef struct SvcConfigMsg {
+    uint32_t decoder;   /* SvcDecoder */
+    uint32_t N;         /* power of 2, at most SVC_MAX_N */
+    uint32_t K;         /* information bits, CRC included */
+    uint32_t list_size; /* SSCL only */
+    uint32_t crc_l;     /* SSCL only: 8 (the CRC of the simulations) or 0 */
+} SvcConfigMsg;
+
+/* Blocking full read and write of a stream socket, -1 on error or EOF */
+static inline int svc_read_full(const int fd, void *buf, size_t len) {
+    uint8_t *p = buf;
+    while (len > 0) {
+        const ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        p += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+static inline int svc_write_full(const int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        const ssize_t w = send(fd, p, len, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        p += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+#endif  // PROTOCOL_H
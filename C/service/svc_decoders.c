@@ -0,0 +1,105 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "svc_decoders.h"
+
+int svc_code_init(SvcCode *c, const SvcConfigMsg *cfg,
+                  const uint32_t *data_pos) {
+    memset(c, 0, sizeof(*c));
+
+    const uint32_t N = cfg->N, K = cfg->K;
+    unsigned n = 0;
+    while ((1u << n) < N) n++;
+    if (N < 2 || N > SVC_MAX_N || (1u << n) != N || K == 0 || K > N) {
+        return -1;
+    }
+    if (cfg->decoder == SVC_SSCL) {
+        if (cfg->list_size < 1 || cfg->list_size > SVC_MAX_LIST
+            || (cfg->crc_l != 0 && cfg->crc_l != 8) || cfg->crc_l >= K) {
+            return -1;
+        }
+    } else if (cfg->decoder != SVC_SSC) {
+        return -1;
+    }
+
+    c->cfg = *cfg;
+    c->n = n;
+    c->data_pos = malloc(sizeof(int) * K);
+    c->info_nodes = calloc(N, sizeof(int));
+    c->node_type = calloc((size_t)N * (n + 1), sizeof(int));
+    int *sorted = malloc(sizeof(int) * 2 * N);
+    if (!c->data_pos || !c->info_nodes || !c->node_type || !sorted) {
+        free(sorted);
+        svc_code_free(c);
+        return -1;
+    }
+
+    /* Distinct positions below N */
+    for (uint32_t i = 0; i < K; i++) {
+        if (data_pos[i] >= N || c->info_nodes[data_pos[i]]) {
+            free(sorted);
+            svc_code_free(c);
+            return -1;
+        }
+        c->data_pos[i] = (int)data_pos[i];
+        c->info_nodes[data_pos[i]] = 1;
+    }
+
+    /* Information and frozen positions in index order, for the node types;
+     * is_vec_mem() scans N/2 entries of each, so both are padded to N */
+    int *data_sorted = sorted, *frozen_sorted = sorted + N;
+    int i_d = 0, i_fr = 0;
+    for (uint32_t i = 0; i < 2 * N; i++) {
+        sorted[i] = -1;
+    }
+    for (uint32_t i = 0; i < N; i++) {
+        if (c->info_nodes[i]) {
+            data_sorted[i_d++] = (int)i;
+        } else {
+            frozen_sorted[i_fr++] = (int)i;
+        }
+    }
+    if (cfg->decoder == SVC_SSC) {
+        svc_ssc_node_types(c->node_type, (int)N, data_sorted, frozen_sorted);
+    } else {
+        svc_sscl_node_types(c->node_type, (int)N, data_sorted, frozen_sorted);
+    }
+    free(sorted);
+    return 0;
+}
+
+void svc_code_free(SvcCode *c) {
+    free(c->data_pos);
+    free(c->info_nodes);
+    free(c->node_type);
+    memset(c, 0, sizeof(*c));
+}
+
+int svc_code_same(const SvcCode *c, const SvcConfigMsg *cfg,
+                  const uint32_t *data_pos) {
+    if (memcmp(&c->cfg, cfg, sizeof(*cfg)) != 0) return 0;
+    for (uint32_t i = 0; i < cfg->K; i++) {
+        if ((uint32_t)c->data_pos[i] != data_pos[i]) return 0;
+    }
+    return 1;
+}
+
+SvcStatus svc_decode(const SvcCode *c, const int8_t *llr, uint8_t *bits) {
+    int LLR_Q[SVC_MAX_N];
+    int msg_cap[SVC_MAX_N];
+    for (uint32_t i = 0; i < c->cfg.N; i++) {
+        LLR_Q[i] = llr[i];
+    }
+
+    SvcStatus status = SVC_OK;
+    if (c->cfg.decoder == SVC_SSC) {
+        svc_ssc_decode(c, LLR_Q, msg_cap);
+    } else if (!svc_sscl_decode(c, LLR_Q, msg_cap)) {
+        status = SVC_CRC_FAIL;
+    }
+
+    for (uint32_t i = 0; i < c->cfg.K; i++) {
+        bits[i] = (uint8_t)(msg_cap[i] != 0);
+    }
+    return status;
+}
@@ -0,0 +1,47 @@
+#ifndef SVC_DECODERS_H
+#define SVC_DECODERS_H
+
+/**
+ * @file svc_decoders.h
+ * @brief Code configurations of the decode service and their decoders
+ *
+ * A SvcCode is built once per registered config id: the information set,
+ * and the node types that the SSC or SSCL decoder walks. Decoding only reads
+ * it, so any number of workers can share one.
+ */
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+typedef struct SvcCode {
+    SvcConfigMsg cfg;
+    unsigned n;
+    int *data_pos;   /* K, in the registered order */
+    int *info_nodes; /* N flags */
+    int *node_type;  /* N x (n + 1), for cfg.decoder */
+} SvcCode;
+
+/* Checks cfg and the information set, builds the node types; 0 or -1 */
+int svc_code_init(SvcCode *c, const SvcConfigMsg *cfg,
+                  const uint32_t *data_pos);
+
+void svc_code_free(SvcCode *c);
+
+/* 1 if c was registered with exactly cfg and data_pos */
+int svc_code_same(const SvcCode *c, const SvcConfigMsg *cfg,
+                  const uint32_t *data_pos);
+
+/* Decodes N int8 LLRs into K bits: SVC_OK, or SVC_CRC_FAIL for a list
+ * whose paths all fail the CRC (the first path is returned) */
+SvcStatus svc_decode(const SvcCode *c, const int8_t *llr, uint8_t *bits);
+
+/* The decoders, each in its own translation unit */
+void svc_ssc_node_types(int *node_type, int N, int *data_pos_sorted,
+                        int *frozen_pos_sorted);
+void svc_ssc_decode(const SvcCode *c, int *LLR_Q, int *msg_cap);
+void svc_sscl_node_types(int *node_type, int N, int *data_pos_sorted,
+                         int *frozen_pos_sorted);
+int svc_sscl_decode(const SvcCode *c, int *LLR_Q, int *msg_cap);
+
+#endif  // SVC_DECODERS_H
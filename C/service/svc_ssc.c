@@ -0,0 +1,18 @@
+#include "functions_SSCD.h"
+#include "svc_decoders.h"
+
+void svc_ssc_node_types(int *node_type, int N, int *data_pos_sorted,
+                        int *frozen_pos_sorted) {
+    find_node_type(node_type, N, N, 0, data_pos_sorted, frozen_pos_sorted);
+}
+
+void svc_ssc_decode(const SvcCode *c, int *LLR_Q, int *msg_cap) {
+    decode(msg_cap,
+           c->cfg.N,
+           c->n,
+           c->cfg.K,
+           LLR_Q,
+           c->info_nodes,
+           c->data_pos,
+           c->node_type);
+}
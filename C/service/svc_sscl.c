@@ -0,0 +1,41 @@
+#include <string.h>
+
+#include "functions_SSCL.h"
+#include "svc_decoders.h"
+
+/* The CRC-8 of the SSCL simulation */
+static int polynomial[9] = {1, 1, 1, 0, 1, 0, 1, 0, 1};
+
+void svc_sscl_node_types(int *node_type, int N, int *data_pos_sorted,
+                         int *frozen_pos_sorted) {
+    find_node_type(node_type, N, N, 0, data_pos_sorted, frozen_pos_sorted);
+}
+
+/* The first path of the list that passes the CRC into msg_cap, or path 0;
+ * returns whether one passed */
+int svc_sscl_decode(const SvcCode *c, int *LLR_Q, int *msg_cap) {
+    const int N = (int)c->cfg.N;
+    const int K = (int)c->cfg.K;
+    const int l = (int)c->cfg.list_size;
+    int msg_list[l * K];
+    int crc_check[l];
+
+    decode_unrolled(
+        N, K, l, c->info_nodes, c->data_pos, c->node_type, LLR_Q, msg_list);
+
+    int crc_ind = -1;
+    if (c->cfg.crc_l > 0) {
+        crcDet(msg_list, K, l, polynomial, (int)c->cfg.crc_l, crc_check);
+        for (int i = 0; i < l; i++) {
+            if (crc_check[i] == 0) {
+                crc_ind = i;
+                break;
+            }
+        }
+    }
+
+    memcpy(msg_cap,
+           msg_list + (crc_ind < 0 ? 0 : crc_ind) * K,
+           sizeof(int) * (size_t)K);
+    return crc_ind >= 0 || c->cfg.crc_l == 0;
+}